@@ -23,6 +23,22 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "boot.h"
+#include "idle.h"
+#include "watchdog.h"
+#include "param.h"
+#include "calibration.h"
+#include "ecu.h"
+#include "vehicle.h"
+#include "line_sensor.h"
+#include "lane_keep.h"
+#include "control.h"
+#include "telemetry.h"
+#include "console.h"
+#include "logger.h"
+#include "range_sensor.h"
+#include "range_filter.h"
+#include "aeb.h"
 
 /* USER CODE END Includes */
 
@@ -33,6 +49,12 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define MAIN_LOOP_TASK          (0)     // watchdog task number of the main loop
+#define MAIN_LOOP_WINDOW_MS     (150)   // the loop wakes on every SysTick at least
+#define MAIN_LANE_KEEP_SPEED    (0.5f)  // m/s, lane keep drives once the mode gives it the motors
+#define MAIN_TELEMETRY_FLUSH_MS (20)    // bound of the telemetry latency when few records are written
+#define MAIN_RANGE_ALPHA        (0.5f)  // alpha beta tracker of the forward range
+#define MAIN_RANGE_BETA         (0.2f)
 
 /* USER CODE END PD */
 
@@ -44,17 +66,53 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
+static const vehicle_config_t MainVehicleConfig =
+{
+    .TrackWidth = 0.16f,
+    .MaxWheelSpeed = 1.2f,
+    .Reversed = { 0, 1, 0, 1 },     // the right side motors are mounted mirrored
+};
+
+/* 20 kHz pwm / 4 scans per frame = 5 kHz frames, one step every 5 frames */
+static const lane_keep_config_t MainLaneKeepConfig =
+{
+    .SensorPitch = 0.01f,
+    .LookAhead = 0.20f,
+    .MaxCurvature = 8.0f,
+    .HeadingFilter = 0.5f,
+    .FramesPerStep = 5,
+    .StepPeriod = 0.001f,
+    .MaxLostSteps = 50,
+};
+
+static motor_curve_t MainMotorCurves[ECU_MOTORS];
+static range_filter_t MainFrontRange;
+static aeb_t MainAeb;
+static vehicle_t MainVehicle;
+static lane_keep_t MainLaneKeep;
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
+static void main_on_line_frame(const line_sensor_frame_t *p_Frame);
+ECU_RAMFUNC static void main_on_range(uint16_t p_RangeMm, uint32_t p_EchoEdgeCycles);
+static void main_on_aeb_fault(uint32_t p_LatencyCycles);
 
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+/* after the prototypes, the fault callback is part of the configuration */
+static const aeb_config_t MainAebConfig =
+{
+    .BaseTtc = 0.6f,
+    .TtcPerSpeed = 0.4f,
+    .MinDistance = 0.15f,
+    .LatencyBoundUs = AEB_DEFAULT_LATENCY_US,
+    .FaultCallback = main_on_aeb_fault,
+};
 
 /* USER CODE END 0 */
 
@@ -66,6 +124,9 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
+  /* the PLL may already run (BOOT_FAST_CLOCK), HAL_Init sets the tick from SystemCoreClock */
+  SystemCoreClockUpdate();
+  uint32_t l_LastFlush = 0U;
 
   /* USER CODE END 1 */
 
@@ -75,6 +136,7 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
+  (void)boot_mark(BOOT_STAMP_HAL_INIT);
 
   /* USER CODE END Init */
 
@@ -82,6 +144,7 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+  (void)boot_mark(BOOT_STAMP_CLOCK);
 
   /* USER CODE END SysInit */
 
@@ -89,19 +152,73 @@ int main(void)
   MX_GPIO_Init();
   MX_TIM4_Init();
   /* USER CODE BEGIN 2 */
-  HAL_TIM_PWM_Start(&htim4, TIM_CHANNEL_1);
+  (void)boot_mark(BOOT_STAMP_PERIPHERALS);
+  /* the stored values are read before anything uses them, the spare sector is erased while the IWDG is off */
+  (void)param_init();
+  /* a missing calibration keeps the defaults (linear mapping, DEFUALT_SPEED), the first motor write comes after */
+  (void)motor_load_calibration();
+  (void)calibration_load(EcuMotors, MainMotorCurves, ECU_MOTORS);
+  /* both pwm channels and the direction pins, then the bank starts standing still */
+  if ((ECU_OK != ecu_init()) || (ECU_OK != vehicle_init(&MainVehicle, &MainVehicleConfig, EcuMotors)))
+  {
+    Error_Handler();
+  }
+  (void)boot_mark(BOOT_STAMP_PWM_READY);
+  /* the loop sleeps whenever it waits (HAL_Delay, idle_enter) */
+  (void)idle_init();
+  (void)watchdog_register(MAIN_LOOP_TASK, MAIN_LOOP_WINDOW_MS);
+  (void)watchdog_start();
+  /* non critical peripherals (link, telemetry, IMU) start after this point, off the boot path */
+  /* the AEB brakes from the echo interrupt, the arbiter holds its brake. no parking assist: the side range
+     sensors and the odometry have no driver yet */
+  if ((ECU_OK != range_filter_init(&MainFrontRange, MAIN_RANGE_ALPHA, MAIN_RANGE_BETA,
+                                   (float_t)RANGE_SENSOR_PERIOD_MS / 1000.0f)) ||
+      (ECU_OK != aeb_init(&MainAeb, &MainAebConfig, EcuMotors, ECU_MOTORS)))
+  {
+    Error_Handler();
+  }
+  (void)control_init(&MainVehicle, NULL, &MainAeb);
+  /* the UART is up with the link, records go out as soon as a buffer fills */
+  (void)telemetry_init();
+  /* DWT cycles of one LOGGER_PRINT of this build, read through SWO with Tools/log_decode.py --itm */
+  (void)cycle_counter_init();
+  uint32_t l_LogStart = CYCLE_COUNTER_NOW();
+  LOGGER_PRINT("boot done after %u cycles", l_LogStart);
+  uint32_t l_LogCycles = CYCLE_COUNTER_NOW() - l_LogStart;
+  LOGGER_PRINT("one LOGGER_PRINT: %u cycles", l_LogCycles);
+  /* hot path from SRAM or flash (ECU_RAMFUNC_ENABLE), first call with a cold ART cache then a warm one. the car
+     stands still, a zero twist changes nothing */
+  uint32_t l_TwistCycles[2];
+  for (uint32_t l_Pass = 0U; l_Pass < 2U; l_Pass++)
+  {
+    uint32_t l_TwistStart = CYCLE_COUNTER_NOW();
+    (void)vehicle_set_twist(&MainVehicle, 0.0f, 0.0f);
+    l_TwistCycles[l_Pass] = CYCLE_COUNTER_NOW() - l_TwistStart;
+  }
+  LOGGER_PRINT("vehicle_set_twist, ECU_RAMFUNC_ENABLE %u: cold %u, warm %u cycles", ECU_RAMFUNC_ENABLE,
+               l_TwistCycles[0], l_TwistCycles[1]);
+  (void)lane_keep_init(&MainLaneKeep, &MainLaneKeepConfig, control_get_arbiter());
+  (void)lane_keep_set_speed(&MainLaneKeep, MAIN_LANE_KEEP_SPEED);
+  (void)line_sensor_init(main_on_line_frame);
+  (void)range_sensor_init(main_on_range);
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-	for(uint8_t duty = 0; duty <= 100; duty+=5)
-	{
-		uint32_t duty_cycle = (uint32_t)((float)(4200.0 * duty / 100.0));
-		__HAL_TIM_SET_COMPARE(&htim4, TIM_CHANNEL_1, duty_cycle);
-		HAL_Delay(100);
-	}
+    /* the motors belong to the arbiter, the loop only runs background work between interrupts */
+    WATCHDOG_CHECK_IN(MAIN_LOOP_TASK);
+    /* one changed value per pass (~40 us flash stall), never an erase once the IWDG runs */
+    (void)param_service(0);
+    if ((HAL_GetTick() - l_LastFlush) >= MAIN_TELEMETRY_FLUSH_MS)
+    {
+      l_LastFlush = HAL_GetTick();
+      (void)telemetry_flush();
+    }
+    /* printf output stopped by a full ITM FIFO (or a busy UART) */
+    console_drain();
+    (void)idle_enter(param_is_pending);
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -155,6 +272,37 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+/**
+  * @brief  Line sensor frame (DMA interrupt), lane keep runs its step and submits from here
+  * @param  p_Frame frame of the array
+  * @retval None
+  */
+static void main_on_line_frame(const line_sensor_frame_t *p_Frame)
+{
+  (void)lane_keep_on_frame(&MainLaneKeep, p_Frame);
+}
+
+/**
+  * @brief  Forward echo (TIM2 capture interrupt), filter then AEB, the brake is written from here
+  * @param  p_RangeMm raw range, zero without echo
+  * @param  p_EchoEdgeCycles cycle counter at the echo edge
+  * @retval None
+  */
+ECU_RAMFUNC static void main_on_range(uint16_t p_RangeMm, uint32_t p_EchoEdgeCycles)
+{
+  (void)range_filter_update(&MainFrontRange, p_RangeMm);
+  (void)aeb_on_range(&MainAeb, &MainFrontRange, Q16_FROM_FLOAT(MainVehicle.Speed), p_EchoEdgeCycles);
+}
+
+/**
+  * @brief  An echo missed the AEB latency bound (capture interrupt)
+  * @param  p_LatencyCycles latency of the sample
+  * @retval None
+  */
+static void main_on_aeb_fault(uint32_t p_LatencyCycles)
+{
+  LOGGER_PRINT("AEB latency %u cycles over the bound", p_LatencyCycles);
+}
 
 /* USER CODE END 4 */
 
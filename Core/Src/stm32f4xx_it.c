@@ -22,6 +22,14 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "line_sensor.h"
+#include "imu.h"
+#include "uart.h"
+#include "idle.h"
+#include "watchdog.h"
+#include "control.h"
+#include "power.h"
+#include "range_sensor.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -183,6 +191,9 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
+  idle_on_tick();
+  watchdog_supervise();
+  control_on_tick();
 
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
@@ -200,4 +211,84 @@ void SysTick_Handler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA2 stream0 global interrupt (ADC1, line sensor).
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_adc1);
+}
+
+/**
+  * @brief This function handles EXTI line[9:5] interrupts (IMU data ready on PB5).
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  HAL_EXTI_IRQHandler(&hexti_imu);
+}
+
+/**
+  * @brief This function handles DMA1 stream0 global interrupt (I2C1 RX, IMU).
+  */
+void DMA1_Stream0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_i2c1_rx);
+}
+
+/**
+  * @brief This function handles I2C1 event interrupt.
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  imu_i2c_event_irq();
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt.
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  imu_i2c_error_irq();
+}
+
+/**
+  * @brief This function handles DMA1 stream5 global interrupt (USART2 RX, companion link).
+  */
+void DMA1_Stream5_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart2_rx);
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (USART2 TX, companion link).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+}
+
+/**
+  * @brief This function handles USART2 global interrupt (idle line only).
+  */
+void USART2_IRQHandler(void)
+{
+  uart_irq();
+}
+
+/**
+  * @brief This function handles TIM2 global interrupt (range sensor echo capture).
+  */
+void TIM2_IRQHandler(void)
+{
+  range_sensor_irq();
+}
+
+/**
+  * @brief This function handles RTC wake-up interrupt through EXTI line 22 (STOP mode IWDG refresh).
+  */
+void RTC_WKUP_IRQHandler(void)
+{
+  power_wakeup_irq();
+}
+
 /* USER CODE END 1 */
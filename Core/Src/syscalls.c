@@ -29,6 +29,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "console.h"
 
 
 /* Variables */
@@ -80,12 +81,13 @@ __attribute__((weak)) int _read(int file, char *ptr, int len)
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
   (void)file;
-  int DataIdx;
-
-  for (DataIdx = 0; DataIdx < len; DataIdx++)
-  {
-    __io_putchar(*ptr++);
-  }
+#if CONSOLE_OUTPUT != CONSOLE_OUTPUT_NONE
+  /* queued for UART DMA / ITM, never waits. bytes that do not fit are counted by the console and reported as
+     written so newlib does not retry */
+  (void)console_write(ptr, (uint32_t)len);
+#else
+  (void)ptr;
+#endif
   return len;
 }
 
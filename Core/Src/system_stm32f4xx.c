@@ -46,6 +46,7 @@
 
 
 #include "stm32f4xx.h"
+#include "boot.h"
 
 #if !defined  (HSE_VALUE) 
   #define HSE_VALUE    ((uint32_t)25000000) /*!< Default value of the External oscillator in Hz */
@@ -171,6 +172,11 @@ void SystemInit(void)
     SCB->CPACR |= ((3UL << 10*2)|(3UL << 11*2));  /* set CP10 and CP11 Full Access */
   #endif
 
+#if (BOOT_FAST_CLOCK)
+  /* PLL before the .data / .bss loops of Reset_Handler instead of in SystemClock_Config (boot.h) */
+  (void)boot_fast_clock();
+#endif
+
 #if defined (DATA_IN_ExtSRAM) || defined (DATA_IN_ExtSDRAM)
   SystemInit_ExtMemCtl(); 
 #endif /* DATA_IN_ExtSRAM || DATA_IN_ExtSDRAM */
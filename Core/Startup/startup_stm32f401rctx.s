@@ -39,6 +39,12 @@ defined in linker script */
 .word  _sdata
 /* end address for the .data section. defined in linker script */
 .word  _edata
+/* start address for the initialization values of the .ramfunc section. defined in linker script */
+.word  _siramfunc
+/* start address for the .ramfunc section. defined in linker script */
+.word  _sramfunc
+/* end address for the .ramfunc section. defined in linker script */
+.word  _eramfunc
 /* start address for the .bss section. defined in linker script */
 .word  _sbss
 /* end address for the .bss section. defined in linker script */
@@ -59,48 +65,97 @@ defined in linker script */
   .type  Reset_Handler, %function
 Reset_Handler:  
   ldr   sp, =_estack      /* set stack pointer */
-  
+
+/* Start the boot profile (boot.h), the stamps are boot_stamp_t values */
+  movs r0, #0             /* BOOT_STAMP_RESET */
+  bl  boot_mark
+
 /* Call the clock system initialization function.*/
   bl  SystemInit  
+  movs r0, #1             /* BOOT_STAMP_SYSTEM_INIT */
+  bl  boot_mark
+
+/* Copy the hot path code (ECU_RAMFUNC) from flash to SRAM */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  bl  CopyWords
 
 /* Copy the data segment initializers from flash to SRAM */  
   ldr r0, =_sdata
   ldr r1, =_edata
   ldr r2, =_sidata
-  movs r3, #0
-  b LoopCopyDataInit
+  bl  CopyWords
+  movs r0, #2             /* BOOT_STAMP_DATA_COPY */
+  bl  boot_mark
+  
+/* Zero fill the bss segment, 16 bytes per store then word by word. */
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  movs r4, #0
+  movs r5, #0
+  movs r6, #0
+  movs r7, #0
+  b LoopFillZeroBlock
 
-CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
+FillZeroBlock:
+  stmia r0!, {r4-r7}
 
-LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
-  bcc CopyDataInit
-  
-/* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
-  movs r3, #0
+LoopFillZeroBlock:
+  subs r3, r1, r0
+  cmp r3, #16
+  bhs FillZeroBlock
   b LoopFillZerobss
 
 FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
+  str  r4, [r0], #4
 
 LoopFillZerobss:
-  cmp r2, r4
+  cmp r0, r1
   bcc FillZerobss
+  movs r0, #3             /* BOOT_STAMP_BSS_ZERO */
+  bl  boot_mark
 
 /* Call static constructors */
     bl __libc_init_array
+  movs r0, #4             /* BOOT_STAMP_LIBC_INIT */
+  bl  boot_mark
 /* Call the application's entry point.*/
   bl  main
   bx  lr    
 .size  Reset_Handler, .-Reset_Handler
 
+/**
+ * @brief  Copies the words [r0, r1) from r2, 16 bytes per load / store pair then
+ *         word by word. Both ends are 4 byte aligned by the linker script.
+ * @param  r0 destination, r1 end of the destination, r2 source
+ * @retval None, r0 to r7 are clobbered
+*/
+    .section  .text.CopyWords
+  .type  CopyWords, %function
+CopyWords:
+  b LoopCopyBlock
+
+CopyBlock:
+  ldmia r2!, {r4-r7}
+  stmia r0!, {r4-r7}
+
+LoopCopyBlock:
+  subs r3, r1, r0
+  cmp r3, #16
+  bhs CopyBlock
+  b LoopCopyWord
+
+CopyWord:
+  ldr r4, [r2], #4
+  str r4, [r0], #4
+
+LoopCopyWord:
+  cmp r0, r1
+  bcc CopyWord
+  bx  lr
+.size  CopyWords, .-CopyWords
+
 /**
  * @brief  This is the code that gets called when the processor receives an 
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
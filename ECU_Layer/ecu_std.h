@@ -5,11 +5,13 @@
  * @date 2024-10-07
  */
 
-
+#ifndef ECU_STD_H_
+#define ECU_STD_H_
 
 /***********************************************************************************************************************
 *                                                      INCLUDES                                                        *
 ***********************************************************************************************************************/
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,11 +24,38 @@
 ***********************************************************************************************************************/
 #define ZERO (0)
 
+#define Q16_SHIFT   (16)
+#define Q16_ONE     ((q16_t)1 << Q16_SHIFT)
+
+/* hot path code executed from SRAM (.ramfunc in the linker script, copied by Reset_Handler) so its timing does not
+   depend on ART cache hits. long_call since SRAM is out of BL range from flash, the prototype must carry it too.
+   build with -DECU_RAMFUNC_ENABLE=0 to run the same code from flash and compare: main logs the cycles of one
+   vehicle_set_twist at boot and the AEB keeps its worst latency (aeb_t). cost: Tools/ramfunc_report.py */
+#ifndef ECU_RAMFUNC_ENABLE
+#define ECU_RAMFUNC_ENABLE  (1)
+#endif
+
+#if (ECU_RAMFUNC_ENABLE)
+#define ECU_RAMFUNC         __attribute__((section(".RamFunc"), long_call))
+#else
+#define ECU_RAMFUNC
+#endif
+
+/* variables Reset_Handler neither copies nor zeroes (.noinit): big buffers always written before being read, and data
+   that has to survive a reset. the content is random after power up */
+#define ECU_NOINIT          __attribute__((section(".noinit")))
+
 
 
 /***********************************************************************************************************************
 *                                                   MACRO FUNCTIONS                                                    *
 ***********************************************************************************************************************/
+/* Q16.16 fixed point helpers, the product is taken in 64 bit to keep the full range (single SMULL on the M4) */
+#define Q16_FROM_INT(x)     ((q16_t)((int32_t)(x) * Q16_ONE))
+#define Q16_TO_INT(x)       ((int32_t)(x) >> Q16_SHIFT)
+#define Q16_FROM_FLOAT(x)   ((q16_t)((x) * (float_t)Q16_ONE))
+#define Q16_TO_FLOAT(x)     ((float_t)(x) / (float_t)Q16_ONE)
+#define Q16_MUL(a, b)       ((q16_t)(((int64_t)(a) * (int64_t)(b)) >> Q16_SHIFT))
 
 
 
@@ -51,6 +80,11 @@ typedef enum
     ECU_RESERVED,
 }ecu_status_t;
 
+/**
+ * @brief signed Q16.16 fixed point number
+ */
+typedef int32_t q16_t;
+
 
 
 /***********************************************************************************************************************
@@ -59,3 +93,6 @@ typedef enum
 *                       |                                                                                              * 
 *                       |                                                                                              * 
 ***********************************************************************************************************************/
+
+
+#endif /* ECU_STD_H_ */
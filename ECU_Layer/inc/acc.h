@@ -0,0 +1,145 @@
+/**
+ * @file    acc.h
+ * @author  Ahmed Hani
+ * @brief   adaptive cruise control, keeps a set speed or a time gap to the vehicle ahead
+ * @date    2026-10-19
+ * @note    acc_step() must be called at the fixed rate given to acc_init() (control timer), it never allocates
+ *          and runs in single precision so it maps on the M4 FPU. the command goes to the arbiter (MODE_OWNER_ACC),
+ *          which holds the AEB brake whatever is submitted: it checks aeb_is_braking() in the same masked section
+ *          as the write, an AEB firing between the braking check of the ACC and the submit still wins, and the next
+ *          step falls back to following the real speed
+ */
+
+
+#ifndef ACC_ACC_H_
+#define ACC_ACC_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "arbiter.h"
+#include "range_filter.h"
+#include "aeb.h"
+#include "cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define ACC_COMMAND_TTL_MS          (200U)  // a few steps, a stalled controller loses the motors
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief tuning of the cruise controller, all units SI
+ * @param StepPeriod period of acc_step() in seconds
+ * @param MaxVehicleSpeed highest speed the controller may command in m/s
+ * @param DetectRange ranges above this are treated as a free road in meters
+ * @param StandstillGap gap kept when stopped behind the vehicle ahead in meters
+ * @param SpeedGain acceleration per m/s of speed error (1/s)
+ * @param GapGain acceleration per meter of gap error (1/s^2)
+ * @param ClosingGain acceleration per m/s of closing speed (1/s)
+ * @param MaxAccel acceleration limit in m/s^2
+ * @param MaxDecel deceleration limit in m/s^2 (positive), harder braking is left to the AEB
+ * @param MaxJerk jerk limit in m/s^3
+ */
+typedef struct
+{
+    float_t StepPeriod;
+    float_t MaxVehicleSpeed;
+    float_t DetectRange;
+    float_t StandstillGap;
+    float_t SpeedGain;
+    float_t GapGain;
+    float_t ClosingGain;
+    float_t MaxAccel;
+    float_t MaxDecel;
+    float_t MaxJerk;
+}acc_config_t;
+
+/**
+ * @brief state of the cruise controller
+ * @param Config tuning given at init
+ * @param Arbiter arbiter receiving the speed commands
+ * @param MaxJerkStep largest acceleration change per step in m/s^2
+ * @param SetSpeed requested cruise speed in m/s
+ * @param TimeGap requested time gap in seconds
+ * @param Accel acceleration commanded on the last step in m/s^2
+ * @param SpeedCommand vehicle speed commanded on the last step in m/s
+ * @param LastStepCycles cpu cycles used by the last step
+ * @param WorstStepCycles worst cpu cycles used by one step since init
+ */
+typedef struct
+{
+    acc_config_t Config;
+    arbiter_t *Arbiter;
+    float_t MaxJerkStep;
+    float_t SetSpeed;
+    float_t TimeGap;
+    float_t Accel;
+    float_t SpeedCommand;
+    uint32_t LastStepCycles;
+    uint32_t WorstStepCycles;
+}acc_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the cruise controller, the car starts with zero set speed
+ *
+ * @param p_Acc object of cruise controller
+ * @param p_Config tuning of the controller
+ * @param p_Arbiter arbiter receiving the speed commands
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t acc_init(acc_t *p_Acc, const acc_config_t *p_Config, arbiter_t *p_Arbiter);
+
+/**
+ * @brief this function changes the driver settings
+ *
+ * @param p_Acc object of cruise controller
+ * @param p_SetSpeed cruise speed in m/s
+ * @param p_TimeGap time gap to the vehicle ahead in seconds
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t acc_set_target(acc_t *p_Acc, float_t p_SetSpeed, float_t p_TimeGap);
+
+/**
+ * @brief this function runs one control step and submits the speed command to the arbiter
+ *
+ * @param p_Acc object of cruise controller
+ * @param p_Range filtered forward range and closing speed
+ * @param p_WheelSpeeds measured wheel speeds in m/s
+ * @param p_WheelCount number of wheel speeds
+ * @param p_Aeb emergency brake, while it is braking the controller only follows the real speed (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t acc_step(acc_t *p_Acc, const range_filter_t *p_Range, const float_t *p_WheelSpeeds,
+                      uint8_t p_WheelCount, const aeb_t *p_Aeb);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* ACC_ACC_H_ */
@@ -0,0 +1,162 @@
+/**
+ * @file    aeb.h
+ * @author  Ahmed Hani
+ * @brief   automatic emergency braking, time-to-collision check run directly in the range sensor context
+ * @date    2026-10-19
+ * @note    aeb_on_range() must be called from the echo / range interrupt (highest NVIC priority among the sensors)
+ *          right after the range filter update, the brake is written from there without going through any task
+ *          the whole path (range_filter_update, aeb_on_range, motor_brake) is ECU_RAMFUNC, no flash wait states
+ *          while braking the motor brake latch is held (motor_set_brake_latch): no other writer can drive or coast
+ *          the motors until the AEB releases it. a sample over the latency bound latches LatencyFault and calls the
+ *          fault callback from the handler, the counter alone would go unnoticed
+ */
+
+
+#ifndef AEB_AEB_H_
+#define AEB_AEB_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "morot.h"
+#include "range_filter.h"
+#include "cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define AEB_MAX_MOTORS              (4)
+#define AEB_DEFAULT_LATENCY_US      (2000)      // echo edge to brake register write
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief called from the range interrupt when a sample misses the latency bound, keep it short
+ */
+typedef void (*aeb_fault_callback_t)(uint32_t p_LatencyCycles);
+
+/**
+ * @brief tuning of the emergency brake
+ * @param BaseTtc time-to-collision threshold at standstill in seconds
+ * @param TtcPerSpeed extra threshold per m/s of own speed in seconds (faster car needs more time to stop)
+ * @param MinDistance range that always triggers the brake in meters
+ * @param LatencyBoundUs allowed latency from echo edge to brake register write in microseconds
+ * @param FaultCallback called on a sample over the latency bound (can be NULL)
+ */
+typedef struct
+{
+    float_t BaseTtc;
+    float_t TtcPerSpeed;
+    float_t MinDistance;
+    uint32_t LatencyBoundUs;
+    aeb_fault_callback_t FaultCallback;
+}aeb_config_t;
+
+/**
+ * @brief state of the emergency brake
+ * @param Motors motors braked when the brake fires
+ * @param MotorCount number of used entries in Motors
+ * @param BaseTtc see aeb_config_t (Q16)
+ * @param TtcPerSpeed see aeb_config_t (Q16)
+ * @param MinDistance see aeb_config_t (Q16)
+ * @param LatencyBoundUs allowed latency in microseconds, converted to cycles at the clock of each sample
+ * @param Braking one while the brake is latched
+ * @param Activations number of times the brake fired
+ * @param LastLatencyCycles latency of the last processed sample
+ * @param WorstLatencyCycles worst latency seen since init
+ * @param LatencyViolations number of samples that exceeded the bound
+ * @param LatencyFault one once a sample exceeded the bound, until aeb_clear_fault()
+ * @param FaultCallback see aeb_config_t
+ */
+typedef struct
+{
+    motor_t *Motors[AEB_MAX_MOTORS];
+    uint8_t MotorCount;
+    q16_t BaseTtc;
+    q16_t TtcPerSpeed;
+    q16_t MinDistance;
+    uint32_t LatencyBoundUs;
+    volatile uint8_t Braking;
+    volatile uint32_t Activations;
+    volatile uint32_t LastLatencyCycles;
+    volatile uint32_t WorstLatencyCycles;
+    volatile uint32_t LatencyViolations;
+    volatile uint8_t LatencyFault;
+    aeb_fault_callback_t FaultCallback;
+}aeb_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the emergency brake
+ *
+ * @param p_Aeb object of emergency brake
+ * @param p_Config tuning of the brake
+ * @param p_Motors motors to be braked
+ * @param p_MotorCount number of motors (up to AEB_MAX_MOTORS)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t aeb_init(aeb_t *p_Aeb, const aeb_config_t *p_Config, motor_t *const *p_Motors, uint8_t p_MotorCount);
+
+/**
+ * @brief this function evaluates the time-to-collision and brakes if needed, constant time
+ *
+ * @param p_Aeb object of emergency brake
+ * @param p_Range filtered forward range (already updated with the sample of this echo)
+ * @param p_EgoSpeed own speed in m/s (Q16)
+ * @param p_EchoEdgeCycles CYCLE_COUNTER_NOW() taken at the echo edge that produced this sample
+ * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t aeb_on_range(aeb_t *p_Aeb, const range_filter_t *p_Range, q16_t p_EgoSpeed, uint32_t p_EchoEdgeCycles);
+
+/**
+ * @brief this function reports if the brake is latched
+ *
+ * @param p_Aeb object of emergency brake
+ * @return uint8_t one while braking
+ */
+uint8_t aeb_is_braking(const aeb_t *p_Aeb);
+
+/**
+ * @brief this function reports if a sample missed the latency bound since init or the last aeb_clear_fault()
+ *
+ * @param p_Aeb object of emergency brake
+ * @return uint8_t one on a fault
+ */
+uint8_t aeb_has_fault(const aeb_t *p_Aeb);
+
+/**
+ * @brief this function acknowledges the latency fault, the violation counter keeps counting
+ *
+ * @param p_Aeb object of emergency brake
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t aeb_clear_fault(aeb_t *p_Aeb);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* AEB_AEB_H_ */
@@ -0,0 +1,184 @@
+/**
+ * @file    arbiter.h
+ * @author  Ahmed Hani
+ * @brief   motor command arbiter: every producer submits a twist with a priority and a time to live, the live command
+ *          with the highest priority among the sources allowed by the active mode drives the vehicle
+ * @date    2026-10-19
+ * @note    one slot per source (the motor owners of mode.h), a new command replaces the previous one of its source.
+ *          only the owner of the active mode (given to arbiter_tick by the control tick) and commands of
+ *          ARBITER_PRIORITY_SAFETY and above are eligible. a submit or release of an eligible source picks the winner
+ *          in a fixed number of steps (ARBITER_SOURCES) and writes it at once, with interrupts masked, so a producer
+ *          reaches the compare registers in its own context without waiting for the tick. arbiter_tick() expires the
+ *          slots whose time to live has run out and applies mode changes. the car is braked (vehicle_brake) when no
+ *          command is live: a source that stops submitting (dead companion link) loses the motors one TTL + one tick
+ *          later at most without any watchdog code of its own. the AEB still brakes the motors directly from its
+ *          handler, while aeb_is_braking() the arbiter holds that brake whatever is live
+ */
+
+
+#ifndef ARBITER_ARBITER_H_
+#define ARBITER_ARBITER_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "cycle_counter.h"
+#include "vehicle.h"
+#include "aeb.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define ARBITER_SOURCES             (MODE_OWNERS)
+#define ARBITER_MAX_TTL_MS          (1000U)     // longer requests are clamped, nothing outlives a second of silence
+
+/* suggested priorities, higher wins */
+#define ARBITER_PRIORITY_DRIVER     (1U)        // remote driving from the link
+#define ARBITER_PRIORITY_ASSIST     (2U)        // ACC, lane keep, parking
+#define ARBITER_PRIORITY_SAFETY     (8U)        // AEB, eligible whatever the mode
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief module allowed to command the motor bank
+ */
+typedef enum
+{
+    MODE_OWNER_NONE = 0,
+    MODE_OWNER_LINK,                // remote driving commands
+    MODE_OWNER_ACC,
+    MODE_OWNER_LANE_KEEP,
+    MODE_OWNER_PARKING,
+    MODE_OWNER_AEB,
+    MODE_OWNERS,
+}mode_owner_t;
+
+/**
+ * @brief one motion request
+ * @param Speed forward speed in m/s
+ * @param YawRate yaw rate in rad/s, positive turns left
+ */
+typedef struct
+{
+    float_t Speed;
+    float_t YawRate;
+}arbiter_command_t;
+
+/**
+ * @brief last command of one source
+ * @param Command requested motion
+ * @param Priority priority of the request, 0 marks an empty slot
+ * @param Deadline HAL tick in milliseconds after which the request is stale
+ */
+typedef struct
+{
+    arbiter_command_t Command;
+    uint8_t Priority;
+    uint32_t Deadline;
+}arbiter_slot_t;
+
+/**
+ * @brief this type represents the arbiter
+ * @param Vehicle drivetrain written by the arbiter (can be NULL: the winner is only recorded)
+ * @param Aeb emergency brake whose brake is held while it brakes (can be NULL)
+ * @param Slots last command of every source
+ * @param Owner owner of the active mode given to the last arbiter_tick()
+ * @param Winner source applied on the last tick, MODE_OWNER_AEB while the AEB brakes, MODE_OWNER_NONE when the car
+ *        was braked because nothing was live
+ * @param Expired requests that ran out of time per source
+ * @param WorstApplyCycles worst cpu cycles of one choice and write (submit, release or tick) since init
+ */
+typedef struct
+{
+    vehicle_t *Vehicle;
+    const aeb_t *Aeb;
+    volatile arbiter_slot_t Slots[ARBITER_SOURCES];
+    volatile mode_owner_t Owner;
+    volatile mode_owner_t Winner;
+    uint32_t Expired[ARBITER_SOURCES];
+    uint32_t WorstApplyCycles;
+}arbiter_t;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the arbiter with every slot empty
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Vehicle drivetrain to command (can be NULL)
+ * @param p_Aeb emergency brake (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t arbiter_init(arbiter_t *p_Arbiter, vehicle_t *p_Vehicle, const aeb_t *p_Aeb);
+
+/**
+ * @brief this function replaces the request of a source and, if the source may drive in the active mode, writes the
+ *        winner to the vehicle at once. safe from any handler (link callback, line sensor DMA, AEB)
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Source source of the request
+ * @param p_Command requested motion
+ * @param p_Priority priority, 1 .. 255
+ * @param p_TtlMs time to live in milliseconds, 1 .. ARBITER_MAX_TTL_MS (clamped)
+ * @return ecu_status_t ECU_ERROR for an unknown source, a zero priority, a zero time to live or a refused write
+ */
+ecu_status_t arbiter_submit(arbiter_t *p_Arbiter, mode_owner_t p_Source, const arbiter_command_t *p_Command,
+                            uint8_t p_Priority, uint32_t p_TtlMs);
+
+/**
+ * @brief this function withdraws the request of a source at once, the next live command (or the brake) is written
+ *        right away when the source was driving
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Source source of the request
+ * @return ecu_status_t ECU_ERROR for an unknown source
+ */
+ecu_status_t arbiter_release(arbiter_t *p_Arbiter, mode_owner_t p_Source);
+
+/**
+ * @brief this function takes the owner of the active mode and expires the stale requests, then writes the winner to
+ *        the vehicle or brakes it when nothing is live or the AEB brakes. called once per control tick (after
+ *        mode_step), the submits in between are written when they arrive
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Owner owner of the active mode (mode_get_owner)
+ * @return ecu_status_t status of vehicle_set_twist / vehicle_brake
+ */
+ecu_status_t arbiter_tick(arbiter_t *p_Arbiter, mode_owner_t p_Owner);
+
+/**
+ * @brief this function tells which source drove the vehicle on the last tick
+ *
+ * @param p_Arbiter object of the arbiter
+ * @return mode_owner_t winner, MODE_OWNER_NONE when the car was braked (or no arbiter)
+ */
+mode_owner_t arbiter_get_winner(const arbiter_t *p_Arbiter);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* ARBITER_ARBITER_H_ */
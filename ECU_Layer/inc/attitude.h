@@ -0,0 +1,142 @@
+/**
+ * @file    attitude.h
+ * @author  Ahmed Hani
+ * @brief   Mahony complementary attitude filter (quaternion) fed by the IMU samples
+ * @date    2026-10-19
+ * @note    single precision only, written for the FPv4-SP unit (-mfloat-abi=hard): no double constants,
+ *          no divisions or sqrtf in the update. without a magnetometer the yaw is gyro only and drifts slowly
+ */
+
+
+#ifndef ATTITUDE_ATTITUDE_H_
+#define ATTITUDE_ATTITUDE_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "ecu_std.h"
+#include "cycle_counter.h"
+#include "imu.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief tuning of the filter
+ * @param Kp proportional gain pulling the estimate towards gravity in 1/s
+ * @param Ki integral gain estimating the gyro bias in 1/s^2 (zero disables it)
+ * @param SamplePeriod period used when no timestamp is available (first sample) in seconds
+ */
+typedef struct
+{
+    float_t Kp;
+    float_t Ki;
+    float_t SamplePeriod;
+}attitude_config_t;
+
+/**
+ * @brief euler angles of the estimate in radians (z-y-x order)
+ * @param Roll rotation around x
+ * @param Pitch rotation around y
+ * @param Yaw rotation around z, positive turns left
+ */
+typedef struct
+{
+    float_t Roll;
+    float_t Pitch;
+    float_t Yaw;
+}attitude_euler_t;
+
+/**
+ * @brief state of the filter
+ * @param Config see attitude_config_t
+ * @param Q orientation quaternion w, x, y, z (body to earth)
+ * @param GyroBias integral term, subtracted from the gyro in rad/s
+ * @param LastTimestamp timestamp of the last sample of the previous batch
+ * @param HasTimestamp set once LastTimestamp is valid
+ * @param CyclesPerSample cost of one sample in the last batch update
+ */
+typedef struct
+{
+    attitude_config_t Config;
+    float_t Q[4];
+    float_t GyroBias[3];
+    uint32_t LastTimestamp;
+    uint8_t HasTimestamp;
+    uint32_t CyclesPerSample;
+}attitude_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the filter at level with zero yaw
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Config tuning of the filter
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_init(attitude_t *p_Attitude, const attitude_config_t *p_Config);
+
+/**
+ * @brief this function runs one filter step
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Gyro angular rate around x, y, z in rad/s
+ * @param p_Accel acceleration along x, y, z (any unit, only the direction is used)
+ * @param p_Period time since the previous step in seconds
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_update(attitude_t *p_Attitude, const float_t *p_Gyro, const float_t *p_Accel, float_t p_Period);
+
+/**
+ * @brief this function runs the filter over a burst of IMU samples, the period of every step comes from the
+ *        sample timestamps converted with the core clock running now (power profiles change it)
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Samples samples, oldest first
+ * @param p_Count number of samples
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_update_batch(attitude_t *p_Attitude, const imu_sample_t *p_Samples, uint8_t p_Count);
+
+/**
+ * @brief this function converts the quaternion to euler angles, uses the libm trigonometry so keep it out of the
+ *        sample rate path
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Euler destination of the angles
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_get_euler(const attitude_t *p_Attitude, attitude_euler_t *p_Euler);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* ATTITUDE_ATTITUDE_H_ */
@@ -0,0 +1,140 @@
+/**
+ * @file    boot.h
+ * @author  Ahmed Hani
+ * @brief   boot time profile (DWT timestamps of every start-up phase kept in .noinit) and the fast boot clock
+ * @date    2026-10-19
+ * @note    boot_mark() and boot_fast_clock() run before .data / .bss are initialized (called from Reset_Handler and
+ *          SystemInit): they only touch registers and the .noinit table, never globals, never the FPU.
+ *          the time from the reset pin release to Reset_Handler is not measured (the DWT restarts with it)
+ */
+
+
+#ifndef BOOT_BOOT_H_
+#define BOOT_BOOT_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+/* switch to the PLL in SystemInit, before the memory copies, instead of in SystemClock_Config. 0 = stock boot on HSI */
+#ifndef BOOT_FAST_CLOCK
+#define BOOT_FAST_CLOCK             (1)
+#endif
+
+/* must match SystemClock_Config (main.c) so HAL_RCC_OscConfig sees the same PLL and leaves it running */
+#define BOOT_PLL_M                  (25)
+#define BOOT_PLL_N                  (168)
+#define BOOT_PLL_P                  (2)
+#define BOOT_PLL_Q                  (4)
+#define BOOT_HSE_TIMEOUT            (0x10000)   // polls of HSERDY before staying on HSI (SystemClock_Config reports it)
+
+#define BOOT_MAGIC                  (0x544F4F42UL)  // "BOOT", the table survived a reset
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief end of every start-up phase, the values are hard coded in startup_stm32f401rctx.s
+ */
+typedef enum
+{
+    BOOT_STAMP_RESET = 0,           // Reset_Handler entry, origin of the profile
+    BOOT_STAMP_SYSTEM_INIT,         // SystemInit (FPU, fast clock)
+    BOOT_STAMP_DATA_COPY,           // .ramfunc and .data copies
+    BOOT_STAMP_BSS_ZERO,            // .bss zero fill
+    BOOT_STAMP_LIBC_INIT,           // __libc_init_array
+    BOOT_STAMP_HAL_INIT,            // HAL_Init
+    BOOT_STAMP_CLOCK,               // SystemClock_Config (HSE bypass + PLL lock)
+    BOOT_STAMP_PERIPHERALS,         // MX_*_Init
+    BOOT_STAMP_PWM_READY,           // motors can be driven
+    BOOT_STAMPS,
+}boot_stamp_t;
+
+/**
+ * @brief raw profile of the last boot, placed in .noinit
+ * @param Magic BOOT_MAGIC once written, anything else after a power up
+ * @param BootCount boots since the last power up
+ * @param ResetFlags RCC->CSR at Reset_Handler (reset cause), the flags are cleared afterwards
+ * @param Cycles DWT cycle counter at the end of every phase
+ * @param Clock core clock in Hz when the stamp was taken
+ */
+typedef struct
+{
+    uint32_t Magic;
+    uint32_t BootCount;
+    uint32_t ResetFlags;
+    uint32_t Cycles[BOOT_STAMPS];
+    uint32_t Clock[BOOT_STAMPS];
+}boot_table_t;
+
+/**
+ * @brief profile of the last boot converted to time
+ * @param PhaseUs duration of every phase in microseconds (index 0, the reset entry, is always zero)
+ * @param TotalUs Reset_Handler to the last stamp taken in microseconds
+ * @param BootCount see boot_table_t
+ * @param ResetFlags see boot_table_t
+ */
+typedef struct
+{
+    uint32_t PhaseUs[BOOT_STAMPS];
+    uint32_t TotalUs;
+    uint32_t BootCount;
+    uint32_t ResetFlags;
+}boot_report_t;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function records the end of a boot phase, BOOT_STAMP_RESET also starts the DWT and the table
+ *
+ * @param p_Stamp phase that just ended
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t boot_mark(boot_stamp_t p_Stamp);
+
+/**
+ * @brief this function runs the core on the PLL (84 MHz) with the flash wait states and ART caches set, called from
+ *        SystemInit when BOOT_FAST_CLOCK is set. SystemCoreClock is not updated (.data is not copied yet)
+ *
+ * @return ecu_status_t ECU_ERROR if the HSE did not start, the core then stays on HSI
+ */
+ecu_status_t boot_fast_clock(void);
+
+/**
+ * @brief this function converts the profile of the last boot, every phase is timed with the clock it started on
+ *
+ * @param p_Report destination of the profile
+ * @return ecu_status_t ECU_ERROR if the table was never written
+ */
+ecu_status_t boot_get_report(boot_report_t *p_Report);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* BOOT_BOOT_H_ */
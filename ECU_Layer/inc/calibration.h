@@ -0,0 +1,165 @@
+/**
+ * @file    calibration.h
+ * @author  Ahmed Hani
+ * @brief   automatic motor calibration: duty sweep with encoder feedback, builds the speed to duty curve of every motor
+ * @date    2026-10-19
+ * @note    run it with the wheels off the ground, all motors sweep together from zero to full duty.
+ *          every curve is scaled to the slowest motor, so the same speed request gives the same wheel speed on
+ *          every motor and the car drives straight. curves go to the parameter store (param.h), two points per word
+ */
+
+
+#ifndef CALIBRATION_CALIBRATION_H_
+#define CALIBRATION_CALIBRATION_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "morot.h"
+#include "param.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define CALIBRATION_DUTY_STEPS      (32)    // duty levels of the sweep above zero
+#define CALIBRATION_CURVE_WORDS     ((MOTOR_CURVE_POINTS + 1) / 2)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief phase of the calibration
+ */
+typedef enum
+{
+    CALIBRATION_IDLE = 0,
+    CALIBRATION_SWEEP,          // motors running, one duty level after the other
+    CALIBRATION_DONE,           // curves ready, see calibration_save()
+    CALIBRATION_FAILED,         // a motor never moved
+}calibration_state_t;
+
+/**
+ * @brief tuning of the calibration
+ * @param SettlePeriods periods waited after every duty change before measuring
+ * @param SamplePeriods periods averaged at every duty level
+ * @param MovingFraction speed above which a motor counts as moving, as a fraction of its full duty speed
+ */
+typedef struct
+{
+    uint16_t SettlePeriods;
+    uint16_t SamplePeriods;
+    float_t MovingFraction;
+}calibration_config_t;
+
+/**
+ * @brief state of the calibration
+ * @param Config see calibration_config_t
+ * @param Motors motors under calibration
+ * @param Count number of motors
+ * @param State see calibration_state_t
+ * @param Level current duty level of the sweep
+ * @param Period periods spent at the current level
+ * @param Sums speeds summed at the current level
+ * @param Speeds mean speed of every motor at every level
+ * @param DeadZone compare value where every motor starts moving
+ * @param MaxSpeed speed of every motor at full duty, in the unit of the measured speeds
+ * @param Curves result, speed to compare value of every motor
+ */
+typedef struct
+{
+    calibration_config_t Config;
+    motor_t *Motors[MOTOR_BANK_MAX_MOTORS];
+    uint8_t Count;
+    calibration_state_t State;
+    uint8_t Level;
+    uint16_t Period;
+    float_t Sums[MOTOR_BANK_MAX_MOTORS];
+    float_t Speeds[MOTOR_BANK_MAX_MOTORS][CALIBRATION_DUTY_STEPS + 1];
+    uint16_t DeadZone[MOTOR_BANK_MAX_MOTORS];
+    float_t MaxSpeed[MOTOR_BANK_MAX_MOTORS];
+    motor_curve_t Curves[MOTOR_BANK_MAX_MOTORS];
+}calibration_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the calibration in idle
+ *
+ * @param p_Calibration object of calibration
+ * @param p_Config tuning of the calibration
+ * @param p_Motors motors to calibrate, same order as the measured speeds
+ * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_init(calibration_t *p_Calibration, const calibration_config_t *p_Config,
+                              motor_t *const *p_Motors, uint8_t p_Count);
+
+/**
+ * @brief this function starts the sweep, the motors turn forward
+ *
+ * @param p_Calibration object of calibration
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_start(calibration_t *p_Calibration);
+
+/**
+ * @brief this function stops the motors and returns to idle
+ *
+ * @param p_Calibration object of calibration
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_cancel(calibration_t *p_Calibration);
+
+/**
+ * @brief this function runs one period of the sweep, call it at a fixed rate with the encoder speeds
+ *
+ * @param p_Calibration object of calibration
+ * @param p_Speeds measured speed of every motor (magnitude, any unit common to all motors, e.g. ticks per period)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_step(calibration_t *p_Calibration, const float_t *p_Speeds);
+
+/**
+ * @brief this function writes the curves to the parameter store and hands them to the motors
+ *
+ * @param p_Calibration object of calibration, in CALIBRATION_DONE
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_save(calibration_t *p_Calibration);
+
+/**
+ * @brief this function reads the stored curves at boot and hands them to the motors (param_init must run before)
+ *
+ * @param p_Motors motors, same order as during the calibration
+ * @param p_Curves storage of the curves, must outlive the motors
+ * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+ * @return ecu_status_t ECU_ERROR if no complete calibration is stored, the motors keep the linear mapping
+ */
+ecu_status_t calibration_load(motor_t *const *p_Motors, motor_curve_t *p_Curves, uint8_t p_Count);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* CALIBRATION_CALIBRATION_H_ */
@@ -0,0 +1,97 @@
+/**
+ * @file    console.h
+ * @author  Ahmed Hani
+ * @brief   non blocking text output behind printf (_write), a byte ring drained by UART TX DMA or ITM port 0
+ * @date    2026-10-19
+ * @note    writers never wait and never mask interrupts: space is reserved with LDREX / STREX and published when the
+ *          outermost writer returns, the drain is claimed the same way, so printf from nested interrupts is safe.
+ *          the only masked section is the DMA claim of uart_transmit (a few cycles) with CONSOLE_OUTPUT_UART.
+ *          what does not fit is dropped (newest bytes first) and counted. the default is ITM: USART2 carries the
+ *          binary link and text would corrupt its frames. build with CONSOLE_OUTPUT=CONSOLE_OUTPUT_NONE for
+ *          production, _write then returns at once. newlib still formats and buffers stdout, prefer LOGGER_PRINT
+ *          (logger.h) in hot paths
+ */
+
+
+#ifndef CONSOLE_CONSOLE_H_
+#define CONSOLE_CONSOLE_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "uart.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define CONSOLE_OUTPUT_UART         (0)     // USART2, only without the link: text between its frames breaks them
+#define CONSOLE_OUTPUT_ITM          (1)     // ITM stimulus port 0, read through SWO by the debugger
+#define CONSOLE_OUTPUT_NONE         (2)     // _write discards everything
+
+#ifndef CONSOLE_OUTPUT
+#define CONSOLE_OUTPUT              CONSOLE_OUTPUT_ITM
+#endif
+
+#define CONSOLE_RING_SIZE           (512)   // power of two
+#define CONSOLE_ITM_PORT            (0)
+#define CONSOLE_ITM_BURST           (32)    // bytes pushed to the ITM per console_drain(), bounds its duration
+
+#if (CONSOLE_RING_SIZE & (CONSOLE_RING_SIZE - 1)) != 0
+#error "CONSOLE_RING_SIZE must be a power of two"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function queues text and starts draining it, callable from any context, never waits
+ *
+ * @param p_Data text to send
+ * @param p_Length number of bytes
+ * @return uint32_t bytes queued, the rest was dropped
+ */
+uint32_t console_write(const char *p_Data, uint32_t p_Length);
+
+/**
+ * @brief this function sends the next part of the ring if the output is free. it runs after every write and
+ *        every UART transfer, call it from the background loop too so output blocked by other UART users or by
+ *        a full ITM FIFO resumes
+ */
+void console_drain(void);
+
+/**
+ * @brief this function tells how many bytes were dropped because the ring was full
+ *
+ * @return uint32_t dropped bytes since reset
+ */
+uint32_t console_get_dropped(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* CONSOLE_CONSOLE_H_ */
@@ -0,0 +1,96 @@
+/**
+ * @file    control.h
+ * @author  Ahmed Hani
+ * @brief   control tick: owns the mode machine and the motor command arbiter and feeds them from the link
+ * @date    2026-10-19
+ * @note    control_on_tick() runs from SysTick, every CONTROL_PERIOD_MS it applies the queued mode events
+ *          (mode_step) then hands the owner of the new mode to the arbiter (arbiter_tick), which expires the stale
+ *          commands. the commands themselves are written when they are submitted, the tick period only bounds mode
+ *          changes and time outs. link frames land in the arbiter (LINK_MSG_DRIVE, MODE_OWNER_LINK) and the mode
+ *          machine (LINK_MSG_MODE, a mode_event_t). the tick posts MODE_EVENT_OBSTACLE when the AEB starts braking
+ *          and MODE_EVENT_LINK_LOST when a link command times out while the link owns the motors. the companion
+ *          may not post OBSTACLE, it may post CLEAR (leave EMERGENCY) once the AEB has released. the ACC, lane
+ *          keep and parking are initialized with control_get_arbiter()
+ */
+
+
+#ifndef CONTROL_CONTROL_H_
+#define CONTROL_CONTROL_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "link.h"
+#include "mode.h"
+#include "arbiter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define CONTROL_PERIOD_MS           (10U)   // mode changes and time outs, in SysTick periods
+#define CONTROL_LINK_TTL_MS         (250U)  // life of a drive command, the companion sends them at 10 Hz at least
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the mode machine (MANUAL) and the arbiter, then starts the link
+ *
+ * @param p_Vehicle drivetrain (can be NULL: the winner is only recorded)
+ * @param p_Parking parking assist cancelled when PARK is left (can be NULL)
+ * @param p_Aeb emergency brake whose brake is held while it brakes (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t control_init(vehicle_t *p_Vehicle, parking_t *p_Parking, const aeb_t *p_Aeb);
+
+/**
+ * @brief this function counts SysTick periods and runs the control tick every CONTROL_PERIOD_MS, call it from
+ *        SysTick_Handler
+ */
+void control_on_tick(void);
+
+/**
+ * @brief this function gives the arbiter the producers submit to
+ *
+ * @return arbiter_t* arbiter of the control tick
+ */
+arbiter_t *control_get_arbiter(void);
+
+/**
+ * @brief this function gives the mode machine, to post events (mode_post) or read the active mode
+ *
+ * @return mode_machine_t* mode machine of the control tick
+ */
+mode_machine_t *control_get_mode(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* CONTROL_CONTROL_H_ */
@@ -0,0 +1,65 @@
+/**
+ * @file    cycle_counter.h
+ * @author  Ahmed Hani
+ * @brief   DWT cycle counter used to timestamp events and measure execution time / latency
+ * @date    2026-10-19
+ * @note    the counter wraps every 2^32 cycles (~51 s at 84 MHz), always subtract timestamps as uint32_t
+ */
+
+
+#ifndef CYCLE_COUNTER_CYCLE_COUNTER_H_
+#define CYCLE_COUNTER_CYCLE_COUNTER_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define CYCLE_COUNTER_NOW()                     (DWT->CYCCNT)
+#define CYCLE_COUNTER_ELAPSED(start)            ((uint32_t)(DWT->CYCCNT - (uint32_t)(start)))
+#define CYCLE_COUNTER_US_TO_CYCLES(us)          ((uint32_t)(us) * (SystemCoreClock / 1000000U))
+#define CYCLE_COUNTER_CYCLES_TO_US(cycles)      ((uint32_t)(cycles) / (SystemCoreClock / 1000000U))
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function enables the DWT cycle counter, must be called once before any CYCLE_COUNTER_NOW()
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t cycle_counter_init(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* CYCLE_COUNTER_CYCLE_COUNTER_H_ */
@@ -3,7 +3,9 @@
  * @author  Ahmed Hani
  * @brief   contains all configuation of the ecu layer
  * @date    2024-10-07
- * @note    nan
+ * @note    motor bank of the board: TIM4 CH1 (PB6) drives the left side and CH2 (PB7) the right side, the front and
+ *          rear motor of a side share the channel (the curve of the last one written sets the duty), direction pins
+ *          on PC0 .. PC7 so a bank write is one BSRR store
  */
 
 /***********************************************************************************************************************
@@ -17,6 +19,7 @@
 *                                                    MACRO DEFINES                                                     *
 ***********************************************************************************************************************/
 #define TIMER_AUTO_RELOAD_VAL   (4200)
+#define ECU_MOTORS              (4)
 
 
 
@@ -32,11 +35,13 @@
 ***********************************************************************************************************************/
 extern motor_t MotorFrontLeft;
 
-extern motor_t MotorFrontLeft;
+extern motor_t MotorFrontRight;
 
-extern motor_t MotorFrontLeft;
+extern motor_t MotorRearLeft;
 
-extern motor_t MotorFrontLeft;
+extern motor_t MotorRearRight;
+
+extern motor_t *const EcuMotors[ECU_MOTORS];      // indexed by vehicle_wheel_t
 
 
 
@@ -51,6 +56,14 @@ extern motor_t MotorFrontLeft;
 *                                                  FUNCTION DEFINITION                                                 *
 ***********************************************************************************************************************/
 
+/**
+ * @brief this function configures what CubeMX does not: the direction pins of the motors (PC0 .. PC7, low) and the
+ *        second pwm channel (TIM4 CH2 on PB7, same settings as CH1). MX_TIM4_Init must run before
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t ecu_init(void);
+
 
 
 
@@ -0,0 +1,94 @@
+/**
+ * @file    fixed_math.h
+ * @author  Ahmed Hani
+ * @brief   table based fixed point helpers for the control loops (reciprocal instead of divide)
+ * @date    2026-10-19
+ * @note    results are accurate to about 0.2 %, enough for control laws, not for bookkeeping
+ *          angles are binary angles (BAM): the full uint32_t range is one turn, so wrapping is free
+ */
+
+
+#ifndef FIXED_MATH_FIXED_MATH_H_
+#define FIXED_MATH_FIXED_MATH_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "ecu_std.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define FIXED_MATH_BAM_QUARTER_TURN     (0x40000000UL)
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* radians (Q16) to binary angle: * 2^32 / (2 * pi) */
+#define FIXED_MATH_RAD_TO_BAM(rad)      ((uint32_t)(((int64_t)(rad) * 683565276LL) >> 16))
+/* binary angle to radians (Q16) in [-pi, pi): * 2 * pi / 2^32 */
+#define FIXED_MATH_BAM_TO_RAD(bam)      ((q16_t)(((int64_t)(int32_t)(bam) * 411775LL) >> 32))
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function divides two integers through the reciprocal table, constant time
+ *
+ * @param p_Num numerator
+ * @param p_Den denominator (> 0)
+ * @return int32_t p_Num / p_Den, saturated if p_Den is zero
+ */
+int32_t fixed_math_div(int32_t p_Num, uint32_t p_Den);
+
+/**
+ * @brief this function divides two Q16 numbers through the reciprocal table, constant time
+ *
+ * @param p_Num numerator (Q16)
+ * @param p_Den denominator (Q16, > 0)
+ * @return q16_t p_Num / p_Den (Q16), saturated if p_Den is zero
+ */
+q16_t fixed_math_div_q16(q16_t p_Num, q16_t p_Den);
+
+/**
+ * @brief this function returns the sine of a binary angle from a 256 entry table with linear interpolation
+ *
+ * @param p_Angle binary angle (2^32 = one turn)
+ * @return q16_t sine (Q16)
+ */
+q16_t fixed_math_sin(uint32_t p_Angle);
+
+/**
+ * @brief this function returns the cosine of a binary angle from a 256 entry table with linear interpolation
+ *
+ * @param p_Angle binary angle (2^32 = one turn)
+ * @return q16_t cosine (Q16)
+ */
+q16_t fixed_math_cos(uint32_t p_Angle);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* FIXED_MATH_FIXED_MATH_H_ */
@@ -0,0 +1,183 @@
+/**
+ * @file    fsm.h
+ * @author  Ahmed Hani
+ * @brief   table driven hierarchical state machine with an event queue
+ * @date    2026-10-19
+ * @note    states and transitions are const tables (flash). a transition is one table lookup per level: an event not
+ *          handled by the current state is looked up in its parent, up to FSM_MAX_DEPTH levels, so the cost of an
+ *          event is bounded by the depth, never by the number of states or events. on a transition the states are
+ *          exited up to the common ancestor and entered down to the target, then to its initial child if it has
+ *          one. events are posted from any context and dispatched from the control tick, FSM_DISPATCH_BUDGET at most
+ */
+
+
+#ifndef FSM_FSM_H_
+#define FSM_FSM_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define FSM_MAX_DEPTH               (4)     // levels of nesting, a top level state is at depth 1
+#define FSM_QUEUE_SIZE              (8)     // pending events, power of two
+#define FSM_DISPATCH_BUDGET         (4)     // events handled per fsm_dispatch() call
+
+#define FSM_NONE                    (0x00U) // table entry: not handled here, ask the parent / no parent / leaf
+#define FSM_IGNORE                  (0xFFU) // table entry: handled, no transition
+
+#if ((FSM_QUEUE_SIZE & (FSM_QUEUE_SIZE - 1)) != 0)
+#error "FSM_QUEUE_SIZE must be a power of two"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* table entry naming a state, 0 stays free for FSM_NONE: unlisted entries of a designated initializer are unhandled */
+#define FSM_TO(state)               ((uint8_t)((state) + 1U))
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief entry or exit action of a state
+ */
+typedef void (*fsm_action_t)(void *p_Context);
+
+/**
+ * @brief this type represents one state of a table
+ * @param Parent FSM_TO(parent) or FSM_NONE for a top level state
+ * @param Initial FSM_TO(child) entered after this state, FSM_NONE for a leaf
+ * @param Owner user value of the state (motor owner for the modes), read by fsm_get_owner
+ * @param Entry action run when the state is entered (can be NULL)
+ * @param Exit action run when the state is left (can be NULL)
+ */
+typedef struct
+{
+    uint8_t Parent;
+    uint8_t Initial;
+    uint8_t Owner;
+    fsm_action_t Entry;
+    fsm_action_t Exit;
+}fsm_state_t;
+
+/**
+ * @brief this type represents a whole machine, kept in flash
+ * @param States state descriptions
+ * @param Transitions StateCount x EventCount entries, row major: FSM_TO(target), FSM_IGNORE or FSM_NONE
+ * @param StateCount number of states (254 at most)
+ * @param EventCount number of events
+ * @param Initial state entered by fsm_init
+ */
+typedef struct
+{
+    const fsm_state_t *States;
+    const uint8_t *Transitions;
+    uint8_t StateCount;
+    uint8_t EventCount;
+    uint8_t Initial;
+}fsm_table_t;
+
+/**
+ * @brief this type represents a running machine
+ * @param Table machine description
+ * @param Context argument of the actions
+ * @param Current active leaf state
+ * @param Queue pending events
+ * @param Head next event to dispatch
+ * @param Tail next free slot
+ * @param Dropped events lost on a full queue
+ * @param WorstDispatchCycles worst cpu cycles of one fsm_dispatch() since init
+ */
+typedef struct
+{
+    const fsm_table_t *Table;
+    void *Context;
+    volatile uint8_t Current;
+    volatile uint8_t Queue[FSM_QUEUE_SIZE];
+    volatile uint8_t Head;
+    volatile uint8_t Tail;
+    volatile uint32_t Dropped;
+    uint32_t WorstDispatchCycles;
+}fsm_t;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function checks the table and enters its initial state (and the initial children below it)
+ *
+ * @param p_Fsm object of the machine
+ * @param p_Table machine description
+ * @param p_Context argument given to every action
+ * @return ecu_status_t ECU_ERROR if a parent, an initial child or a target is out of range or the nesting is deeper
+ *         than FSM_MAX_DEPTH
+ */
+ecu_status_t fsm_init(fsm_t *p_Fsm, const fsm_table_t *p_Table, void *p_Context);
+
+/**
+ * @brief this function queues an event, safe from any handler
+ *
+ * @param p_Fsm object of the machine
+ * @param p_Event event number
+ * @return ecu_status_t ECU_ERROR for an unknown event or a full queue
+ */
+ecu_status_t fsm_post(fsm_t *p_Fsm, uint8_t p_Event);
+
+/**
+ * @brief this function handles up to FSM_DISPATCH_BUDGET queued events, called from the control tick (one context)
+ *
+ * @param p_Fsm object of the machine
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t fsm_dispatch(fsm_t *p_Fsm);
+
+/**
+ * @brief this function tells the active leaf state
+ *
+ * @param p_Fsm object of the machine
+ * @return uint8_t state number
+ */
+uint8_t fsm_get_state(const fsm_t *p_Fsm);
+
+/**
+ * @brief this function tells if a state is the active leaf or one of its ancestors
+ *
+ * @param p_Fsm object of the machine
+ * @param p_State state number
+ * @return uint8_t nonzero if the state is active
+ */
+uint8_t fsm_in_state(const fsm_t *p_Fsm, uint8_t p_State);
+
+/**
+ * @brief this function tells the owner value of the active leaf state
+ *
+ * @param p_Fsm object of the machine
+ * @return uint8_t Owner of the state
+ */
+uint8_t fsm_get_owner(const fsm_t *p_Fsm);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* FSM_FSM_H_ */
@@ -0,0 +1,142 @@
+/**
+ * @file    idle.h
+ * @author  Ahmed Hani
+ * @brief   idle policy: the main loop sleeps (WFI, Sleep mode) when it has nothing to run, with wake up latency and
+ *          sleep residency measurement
+ * @date    2026-10-19
+ * @note    Sleep mode only stops the core clock: the bus clocks, the timers, the ADC, the DMA and every interrupt keep
+ *          running and any interrupt wakes the core, so the pwm and the sensors are not disturbed. the wake up
+ *          latency is measured on the SysTick (it counts HCLK cycles, the DWT cycle counter stops with the core):
+ *          cycles from the tick event to its handler while the core slept. the AEB path only adds this latency to
+ *          its own (AEB_DEFAULT_LATENCY_US budget, checked by aeb_get_stats), bound: IDLE_WAKE_BOUND_CYCLES.
+ *          current estimate: measured residency weighted by the IDLE_*_CURRENT_UA figures, typical values of the
+ *          STM32F401 datasheet (all peripherals clocked, 25 C) to be replaced by bench measurements of the board
+ */
+
+
+#ifndef IDLE_IDLE_H_
+#define IDLE_IDLE_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "power.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+/* event to handler bound while asleep: ~12 cycles of wake up and stacking, flash wait states and idle_enter() exit */
+#define IDLE_WAKE_BOUND_CYCLES      (256U)
+
+/* core current per run profile, awake and in Sleep mode: datasheet typical values, estimates not measured */
+#define IDLE_RUN_CURRENT_UA         (12000U)    // HCLK 84 MHz
+#define IDLE_SLEEP_CURRENT_UA       (6500U)
+#define IDLE_PARKED_RUN_CURRENT_UA  (6500U)     // HCLK 42 MHz
+#define IDLE_PARKED_SLEEP_CURRENT_UA (3500U)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief callback telling if work is ready, called with the interrupts masked right before sleeping so work made
+ *        ready by a handler can not be missed (returns nonzero when there is work)
+ */
+typedef uint8_t (*idle_ready_t)(void);
+
+/**
+ * @brief this type represents the idle statistics since init or the last idle_reset_stats()
+ * @param Wakeups number of sleeps ended by an interrupt
+ * @param SleepUs time spent asleep in microseconds
+ * @param TotalUs time elapsed in microseconds
+ * @param ResidencyPermille share of the time spent asleep in 1/1000
+ * @param CurrentUa estimated average core current in microamperes
+ * @param LastWakeCycles latency of the last measured wake up (SysTick event to handler) in HCLK cycles
+ * @param WorstWakeCycles worst measured wake up latency
+ * @param WakeViolations wake ups that exceeded IDLE_WAKE_BOUND_CYCLES
+ */
+typedef struct
+{
+    uint32_t Wakeups;
+    uint64_t SleepUs;
+    uint64_t TotalUs;
+    uint32_t ResidencyPermille;
+    uint32_t CurrentUa;
+    uint32_t LastWakeCycles;
+    uint32_t WorstWakeCycles;
+    uint32_t WakeViolations;
+}idle_stats_t;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function starts the measurement (HAL_Init must run before)
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_init(void);
+
+/**
+ * @brief this function sleeps until the next interrupt unless work is ready, the handler that woke the core has run
+ *        when it returns. with sleep on exit enabled it does not return: everything then runs in handlers
+ *
+ * @param p_Ready work ready check, NULL to sleep anyway
+ * @return ecu_status_t ECU_ERROR if work was ready and the core did not sleep
+ */
+ecu_status_t idle_enter(idle_ready_t p_Ready);
+
+/**
+ * @brief this function enables or disables sleep on exit: the core goes back to sleep at the end of the last handler
+ *        instead of returning to the main loop, for purely interrupt driven configurations
+ *
+ * @param p_Enable nonzero to enable
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_set_sleep_on_exit(uint8_t p_Enable);
+
+/**
+ * @brief this function measures the wake up latency, called first in SysTick_Handler
+ */
+void idle_on_tick(void);
+
+/**
+ * @brief this function copies the statistics and computes the residency and the current estimate
+ *
+ * @param p_Stats destination
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_get_stats(idle_stats_t *p_Stats);
+
+/**
+ * @brief this function clears the statistics
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_reset_stats(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* IDLE_IDLE_H_ */
@@ -0,0 +1,133 @@
+/**
+ * @file    imu.h
+ * @author  Ahmed Hani
+ * @brief   MPU-6050 class IMU read through its FIFO in DMA bursts on I2C1, paced by the data ready EXTI
+ * @date    2026-10-19
+ * @note    the I2C HAL driver is not part of the project, I2C1 is programmed through CMSIS registers.
+ *          the address phase runs from the I2C event interrupt and the payload from DMA1 stream 0 so the cpu
+ *          never waits on the bus. pins: PB8 SCL, PB9 SDA, PB5 INT
+ */
+
+
+#ifndef IMU_IMU_H_
+#define IMU_IMU_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define IMU_I2C_ADDRESS             (0x68)  // AD0 low
+#define IMU_I2C_SPEED               (400000UL)
+#define IMU_SAMPLE_RATE_DIVIDER     (0)     // 1 kHz / (1 + divider) with the 188 Hz DLPF
+#define IMU_SAMPLES_PER_BURST       (4)     // FIFO samples read per DMA burst
+#define IMU_RING_SIZE               (64)    // samples buffered for the reader, power of two
+#define IMU_IRQ_PRIORITY            (1)     // EXTI, I2C event / error and DMA of the IMU share it
+
+#if (IMU_RING_SIZE & (IMU_RING_SIZE - 1)) != 0
+#error "IMU_RING_SIZE must be a power of two"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief one converted sample
+ * @param Gyro angular rate around x, y, z in rad/s (Q16)
+ * @param Accel acceleration along x, y, z in m/s^2 (Q16)
+ * @param Timestamp CYCLE_COUNTER_NOW() at the data ready edge of this sample
+ */
+typedef struct
+{
+    q16_t Gyro[3];
+    q16_t Accel[3];
+    uint32_t Timestamp;
+}imu_sample_t;
+
+/**
+ * @brief counters of the acquisition
+ * @param Dropped samples lost because the ring was full
+ * @param BusErrors I2C errors and FIFO overruns, each one resets the sensor FIFO
+ * @param WorstCycles worst cpu cycles spent converting and queueing one burst
+ */
+typedef struct
+{
+    uint32_t Dropped;
+    uint32_t BusErrors;
+    uint32_t WorstCycles;
+}imu_stats_t;
+
+
+
+/***********************************************************************************************************************
+*                                                   EXTERN OBJECTS                                                     *
+***********************************************************************************************************************/
+extern DMA_HandleTypeDef hdma_i2c1_rx;
+extern EXTI_HandleTypeDef hexti_imu;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures I2C1, DMA1 stream 0 and the sensor then starts streaming,
+ *        blocks for about 100 ms while the sensor resets
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t imu_init(void);
+
+/**
+ * @brief this function takes the oldest sample out of the ring, single reader
+ *
+ * @param p_Sample destination of the sample
+ * @return ecu_status_t ECU_OK if a sample was copied, ECU_ERROR if the ring is empty
+ */
+ecu_status_t imu_read(imu_sample_t *p_Sample);
+
+/**
+ * @brief this function copies the acquisition counters
+ *
+ * @param p_Stats destination of the counters
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t imu_get_stats(imu_stats_t *p_Stats);
+
+/**
+ * @brief I2C1 event interrupt, drives the address phase of every transfer
+ */
+void imu_i2c_event_irq(void);
+
+/**
+ * @brief I2C1 error interrupt, aborts the transfer and schedules a FIFO reset
+ */
+void imu_i2c_error_irq(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* IMU_IMU_H_ */
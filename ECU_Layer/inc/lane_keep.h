@@ -0,0 +1,150 @@
+/**
+ * @file    lane_keep.h
+ * @author  Ahmed Hani
+ * @brief   lane keeping steering from the line sensor centroid (pure pursuit on offset and heading)
+ * @date    2026-10-19
+ * @note    lane_keep_on_frame() is meant to run from the line sensor callback; the law is Q16 and uses no divide.
+ *          the twist goes to the arbiter (MODE_OWNER_LANE_KEEP), which writes it to the compare registers within the
+ *          submit while lane keep owns the motors, a lost line withdraws it so the arbiter brakes. nothing is
+ *          submitted while the AEB holds the brake (motor brake latch), the arbiter also holds that brake
+ */
+
+
+#ifndef LANE_KEEP_LANE_KEEP_H_
+#define LANE_KEEP_LANE_KEEP_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "arbiter.h"
+#include "line_sensor.h"
+#include "fixed_math.h"
+#include "cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define LANE_KEEP_COMMAND_TTL_MS    (100U)  // a few steps, a silent line sensor loses the motors
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief tuning of the lane keeping, all units SI
+ * @param SensorPitch distance between two sensors of the array in meters
+ * @param LookAhead pure pursuit look ahead distance in meters
+ * @param MaxCurvature steering limit in 1/m
+ * @param HeadingFilter low pass factor of the heading estimate (0 .. 1, 1 = no filtering)
+ * @param FramesPerStep sensor frames per control step (5 kHz frames / 5 = 1 kHz control)
+ * @param StepPeriod period of one control step in seconds
+ * @param MaxLostSteps steps without line before the motors are stopped
+ */
+typedef struct
+{
+    float_t SensorPitch;
+    float_t LookAhead;
+    float_t MaxCurvature;
+    float_t HeadingFilter;
+    uint8_t FramesPerStep;
+    float_t StepPeriod;
+    uint16_t MaxLostSteps;
+}lane_keep_config_t;
+
+/**
+ * @brief state of the lane keeping
+ * @param Arbiter arbiter receiving the twist
+ * @param SensorPitch pitch in meters (Q16)
+ * @param OffsetGain curvature per meter of offset, 2 / L^2 (Q16)
+ * @param HeadingGain curvature per radian of heading, 2 / L (Q16)
+ * @param MaxCurvature curvature limit in 1/m (Q16)
+ * @param HeadingFilter filter factor (Q16)
+ * @param StepPeriod control period in seconds (Q16)
+ * @param FramesPerStep see lane_keep_config_t
+ * @param FrameCount frames since the last step
+ * @param MaxLostSteps see lane_keep_config_t
+ * @param LostSteps steps since the line was last seen
+ * @param Speed requested forward speed in m/s (Q16), zero leaves the motors alone
+ * @param Offset lateral offset of the line in meters (Q16), positive to the right
+ * @param Heading heading of the line relative to the car in radians (Q16), positive drifting to the right
+ * @param Curvature last commanded curvature in 1/m (Q16), positive turns right
+ * @param WorstLatencyCycles worst time from DMA hand over to the return of the submit, the compare registers are
+ *        written by then while lane keep owns the motors
+ * @param BrakeHeldSteps steps not submitted because the AEB held the brake
+ */
+typedef struct
+{
+    arbiter_t *Arbiter;
+    q16_t SensorPitch;
+    q16_t OffsetGain;
+    q16_t HeadingGain;
+    q16_t MaxCurvature;
+    q16_t HeadingFilter;
+    q16_t StepPeriod;
+    uint8_t FramesPerStep;
+    uint8_t FrameCount;
+    uint16_t MaxLostSteps;
+    uint16_t LostSteps;
+    volatile q16_t Speed;
+    q16_t Offset;
+    q16_t Heading;
+    q16_t Curvature;
+    volatile uint32_t WorstLatencyCycles;
+    uint32_t BrakeHeldSteps;
+}lane_keep_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the lane keeping, it starts disengaged (zero speed)
+ *
+ * @param p_LaneKeep object of lane keeping
+ * @param p_Config tuning of the lane keeping
+ * @param p_Arbiter arbiter receiving the twist
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t lane_keep_init(lane_keep_t *p_LaneKeep, const lane_keep_config_t *p_Config, arbiter_t *p_Arbiter);
+
+/**
+ * @brief this function sets the forward speed, zero disengages the lane keeping
+ *
+ * @param p_LaneKeep object of lane keeping
+ * @param p_Speed forward speed in m/s
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t lane_keep_set_speed(lane_keep_t *p_LaneKeep, float_t p_Speed);
+
+/**
+ * @brief this function consumes one line sensor frame and runs the steering law every FramesPerStep frames
+ *
+ * @param p_LaneKeep object of lane keeping
+ * @param p_Frame frame given by the line sensor callback
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t lane_keep_on_frame(lane_keep_t *p_LaneKeep, const line_sensor_frame_t *p_Frame);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* LANE_KEEP_LANE_KEEP_H_ */
@@ -0,0 +1,132 @@
+/**
+ * @file    line_sensor.h
+ * @author  Ahmed Hani
+ * @brief   IR reflectance line sensor array sampled by ADC1 in scan mode with circular double buffered DMA
+ * @date    2026-10-19
+ * @note    conversions are triggered by TIM4 CC4 (ADC EXTSEL 1001), the spare channel of the motor PWM timer, so
+ *          the scan starts at a fixed delay inside every PWM period and TIM3 stays free. TIM4 counts up in PWM1: all
+ *          motor outputs switch on together at the update, the largest current step, and each one switches off at
+ *          its own compare. the scan starts once the update edge has settled and must end LINE_SENSOR_GUARD_TICKS
+ *          before the next update (checked at build time in line_sensor.c), a compare edge inside the scan only hits
+ *          the channel sampling at that time and the four scans summed per frame average it out.
+ *          the ADC HAL driver is not part of the project, ADC1 and TIM4 CC4 are programmed through CMSIS registers
+ */
+
+
+#ifndef LINE_SENSOR_LINE_SENSOR_H_
+#define LINE_SENSOR_LINE_SENSOR_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "cycle_counter.h"
+#include "fixed_math.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define LINE_SENSOR_CHANNELS            (8)     // 5 .. 8 sensors, see the channel table in line_sensor.c
+#define LINE_SENSOR_SCANS_PER_FRAME     (4)     // scans summed per frame, frame rate = PWM rate / this
+#define LINE_SENSOR_TRIGGER_DELAY       (168)   // TIM4 ticks after the PWM update at which the scan starts (2 us)
+#define LINE_SENSOR_GUARD_TICKS         (168)   // the scan ends at least this long before the next update
+#define LINE_SENSOR_MIN_STRENGTH        (64)    // sum of strengths below this means no line under the array
+#define LINE_SENSOR_IRQ_PRIORITY        (2)
+
+#if (LINE_SENSOR_CHANNELS < 5) || (LINE_SENSOR_CHANNELS > 8)
+#error "LINE_SENSOR_CHANNELS must be between 5 and 8"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief one processed frame of the array
+ * @param Strength normalized reading of every sensor, 0 = surface, 255 = line
+ * @param Position line centroid in 1/256 of the sensor pitch from the array center, positive to the right
+ * @param LineFound one if the line is under the array, Position keeps its last value otherwise
+ * @param Sequence number of the frame, increments on every frame
+ * @param Timestamp CYCLE_COUNTER_NOW() when the DMA handed over the samples of this frame
+ */
+typedef struct
+{
+    uint8_t Strength[LINE_SENSOR_CHANNELS];
+    int16_t Position;
+    uint8_t LineFound;
+    uint32_t Sequence;
+    uint32_t Timestamp;
+}line_sensor_frame_t;
+
+/**
+ * @brief called from the DMA interrupt with every new frame, must be short
+ */
+typedef void (*line_sensor_callback_t)(const line_sensor_frame_t *p_Frame);
+
+
+
+/***********************************************************************************************************************
+*                                                   EXTERN OBJECTS                                                     *
+***********************************************************************************************************************/
+extern DMA_HandleTypeDef hdma_adc1;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures the pins, ADC1, TIM4 channel 4 and DMA2 stream 0 then starts sampling,
+ *        TIM4 must already run (MX_TIM4_Init)
+ *
+ * @param p_Callback called with every frame from the DMA interrupt (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t line_sensor_init(line_sensor_callback_t p_Callback);
+
+/**
+ * @brief this function sets the normalization from raw readings taken over the surface and over the line
+ *
+ * @param p_Surface raw ADC reading (0 .. 4095) of every sensor over the surface
+ * @param p_Line raw ADC reading (0 .. 4095) of every sensor over the line
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t line_sensor_calibrate(const uint16_t *p_Surface, const uint16_t *p_Line);
+
+/**
+ * @brief this function copies the latest frame for readers outside the interrupt
+ *
+ * @param p_Frame destination of the frame
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t line_sensor_get_frame(line_sensor_frame_t *p_Frame);
+
+/**
+ * @brief this function returns the worst processing time of one frame in cpu cycles
+ *
+ * @return uint32_t cycles
+ */
+uint32_t line_sensor_get_worst_cycles(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* LINE_SENSOR_LINE_SENSOR_H_ */
@@ -0,0 +1,70 @@
+/**
+ * @file    link.h
+ * @author  Ahmed Hani
+ * @brief   binary command link with the companion computer, frames parsed in place from the UART DMA ring
+ * @date    2026-10-19
+ * @note    the frame format, the CRC and the parser live in link_frame.h, this module only binds them to the UART
+ */
+
+
+#ifndef LINK_LINK_H_
+#define LINK_LINK_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "uart.h"
+#include "link_frame.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function starts the link on the UART
+ *
+ * @param p_Callback receiver of the commands
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t link_init(link_command_callback_t p_Callback);
+
+/**
+ * @brief this function copies the counters of the link
+ *
+ * @param p_Stats destination of the counters
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t link_get_stats(link_stats_t *p_Stats);
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* LINK_LINK_H_ */
@@ -0,0 +1,153 @@
+/**
+ * @file    link_frame.h
+ * @author  Ahmed Hani
+ * @brief   frame format, CRC and in place parser of the companion link, free of any hardware access
+ * @date    2026-10-19
+ * @note    frame: 0xA5 0x5A | type | length | payload (length bytes) | CRC16-CCITT of type .. payload (little endian).
+ *          all multi byte fields are little endian, see the LINK_MSG_* layouts below. link.c feeds the parser from
+ *          the UART DMA ring, the host tests (Tests/test_link.c) feed it from a pty with the same ring arithmetic
+ */
+
+
+#ifndef LINK_FRAME_LINK_FRAME_H_
+#define LINK_FRAME_LINK_FRAME_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "ecu_std.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define LINK_SYNC_0                 (0xA5)
+#define LINK_SYNC_1                 (0x5A)
+#define LINK_HEADER_SIZE            (4)
+#define LINK_CRC_SIZE               (2)
+#define LINK_MAX_PAYLOAD            (250)   // a whole telemetry buffer (TELEMETRY_BUFFER_SIZE), commands are short
+#define LINK_CRC_INIT               (0xFFFF)
+
+/* messages from the companion computer */
+#define LINK_MSG_DRIVE              (0x01)  // int16 speed in mm/s, int16 yaw rate in mrad/s (positive turns left)
+#define LINK_MSG_MODE               (0x02)  // uint8 requested mode, a mode_event_t (mode.h)
+#define LINK_MSG_HEARTBEAT          (0x03)  // no payload
+
+#define LINK_DRIVE_LENGTH           (4)
+#define LINK_MODE_LENGTH            (1)
+#define LINK_HEARTBEAT_LENGTH       (0)
+
+/* messages to the companion computer */
+#define LINK_MSG_TELEMETRY          (0x80)  // block of telemetry records, see telemetry.h
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief one decoded command
+ * @param Type LINK_MSG_* of the frame
+ * @param Speed requested speed in m/s (LINK_MSG_DRIVE)
+ * @param YawRate requested yaw rate in rad/s (LINK_MSG_DRIVE)
+ * @param Mode requested mode (LINK_MSG_MODE)
+ */
+typedef struct
+{
+    uint8_t Type;
+    float_t Speed;
+    float_t YawRate;
+    uint8_t Mode;
+}link_command_t;
+
+/**
+ * @brief called with every valid command (from the UART interrupt on the target), must be short
+ */
+typedef void (*link_command_callback_t)(const link_command_t *p_Command);
+
+/**
+ * @brief counters of the link
+ * @param Frames valid frames received
+ * @param CrcErrors frames dropped because of the CRC
+ * @param Invalid frames with a good CRC but an unknown type or a wrong length
+ * @param SkippedBytes bytes dropped while searching the start of a frame
+ */
+typedef struct
+{
+    uint32_t Frames;
+    uint32_t CrcErrors;
+    uint32_t Invalid;
+    uint32_t SkippedBytes;
+}link_stats_t;
+
+/**
+ * @brief state of one frame parser
+ * @param Callback receiver of the commands
+ * @param Mask ring size - 1
+ * @param Stats counters of the parser
+ */
+typedef struct
+{
+    link_command_callback_t Callback;
+    uint32_t Mask;
+    link_stats_t Stats;
+}link_parser_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize a parser for a ring of a given size
+ *
+ * @param p_Parser object of the parser
+ * @param p_Callback receiver of the commands
+ * @param p_RingSize size of the ring in bytes, a power of two holding at least two whole frames
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t link_parser_init(link_parser_t *p_Parser, link_command_callback_t p_Callback, uint32_t p_RingSize);
+
+/**
+ * @brief this function scans the unread bytes of the ring for complete frames, an incomplete frame stays in the
+ *        ring for the next call
+ *
+ * @param p_Parser object of the parser
+ * @param p_Ring the ring
+ * @param p_Read offset of the first unread byte
+ * @param p_Write offset where the producer writes next
+ * @return uint32_t offset of the first byte still needed
+ */
+uint32_t link_parser_scan(link_parser_t *p_Parser, const uint8_t *p_Ring, uint32_t p_Read, uint32_t p_Write);
+
+/**
+ * @brief this function computes the frame CRC (CCITT, polynomial 0x1021) over a ring or a plain buffer
+ *
+ * @param p_Buffer data
+ * @param p_Start offset of the first byte
+ * @param p_Length number of bytes
+ * @param p_Mask ring size - 1, or 0xFFFFFFFF for a plain buffer
+ * @return uint16_t CRC starting from LINK_CRC_INIT
+ */
+uint16_t link_crc16(const uint8_t *p_Buffer, uint32_t p_Start, uint32_t p_Length, uint32_t p_Mask);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* LINK_FRAME_LINK_FRAME_H_ */
@@ -0,0 +1,109 @@
+/**
+ * @file    logger.h
+ * @author  Ahmed Hani
+ * @brief   deferred logging: the format string stays on the host, the target only sends its id and the raw arguments
+ * @date    2026-10-19
+ * @note    LOGGER_PRINT places the format string in .logstr, a section the linker script keeps in the ELF but never
+ *          loads, so the id is the offset of the string in that section and costs no flash. Tools/log_decode.py
+ *          reads the strings back from ADAS.elf and formats the messages.
+ *          arguments are 32 bit words: integers and pointers as they are, floats through LOGGER_F32() (%f / %e / %g
+ *          on the host). %s cannot be supported, the string is not on the host.
+ *          the default transport is ITM, a raw push of the words with interrupts masked for the stores only (about
+ *          60 cycles for three arguments by instruction count, main reports the DWT count of one LOGGER_PRINT at boot)
+ */
+
+
+#ifndef LOGGER_LOGGER_H_
+#define LOGGER_LOGGER_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "telemetry.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define LOGGER_TRANSPORT_TELEMETRY  (0)     // TELEMETRY_LOG records on the companion link, hundreds of cycles
+#define LOGGER_TRANSPORT_ITM        (1)     // words on an ITM stimulus port, read through SWO by the debugger
+#define LOGGER_TRANSPORT_NONE       (2)     // logging compiled out
+
+#ifndef LOGGER_TRANSPORT
+#define LOGGER_TRANSPORT            LOGGER_TRANSPORT_ITM
+#endif
+
+#define LOGGER_MAX_ARGS             (3)
+#define LOGGER_ITM_PORT             (1)     // header words, port 0 stays free for the console
+#define LOGGER_ITM_ARG_PORT         (2)     // argument words, a cut message is told apart from the next one
+#define LOGGER_COUNT_SHIFT          (24)    // header word: argument count << 24 | string id
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* number of arguments, a fourth one expands to an undeclared identifier so the build fails */
+#define LOGGER_ARG_N(_0, _1, _2, _3, _4, N, ...)    N
+#define LOGGER_COUNT(...)           LOGGER_ARG_N(_, ##__VA_ARGS__, LOGGER_TOO_MANY_ARGUMENTS, 3, 2, 1, 0)
+/* arguments padded with zeros to LOGGER_MAX_ARGS */
+#define LOGGER_PICK(_, a, b, c, ...)    (uint32_t)(a), (uint32_t)(b), (uint32_t)(c)
+#define LOGGER_ARGS(...)            LOGGER_PICK(_, ##__VA_ARGS__, 0, 0, 0)
+
+/* raw bits of a float argument */
+#define LOGGER_F32(value)           (((union { float_t f; uint32_t u; }){ .f = (float_t)(value) }).u)
+
+#if LOGGER_TRANSPORT == LOGGER_TRANSPORT_NONE
+#define LOGGER_PRINT(format, ...)   do { } while (0)
+#else
+#define LOGGER_PRINT(format, ...)                                                                                     \
+    do                                                                                                                \
+    {                                                                                                                 \
+        static const char l_LoggerFormat[] __attribute__((section(".logstr"), used)) = format;                      \
+        logger_write(((uint32_t)LOGGER_COUNT(__VA_ARGS__) << LOGGER_COUNT_SHIFT) | (uint32_t)l_LoggerFormat,        \
+                     LOGGER_ARGS(__VA_ARGS__));                                                                       \
+    } while (0)
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function sends one message, use LOGGER_PRINT instead, never waits. a message that finds the transport
+ *        busy is dropped and counted, over ITM it is cut at the first word the stimulus FIFO refuses
+ *
+ * @param p_Header argument count and string id
+ * @param p_Arg0 first argument
+ * @param p_Arg1 second argument
+ * @param p_Arg2 third argument
+ */
+void logger_write(uint32_t p_Header, uint32_t p_Arg0, uint32_t p_Arg1, uint32_t p_Arg2);
+
+/**
+ * @brief this function tells how many messages were dropped
+ *
+ * @return uint32_t dropped messages since reset
+ */
+uint32_t logger_get_dropped(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* LOGGER_LOGGER_H_ */
@@ -0,0 +1,155 @@
+/**
+ * @file    mode.h
+ * @author  Ahmed Hani
+ * @brief   ADAS driving modes (manual, cruise, ACC, lane keep, park, emergency) and the owner of the motor bank
+ * @date    2026-10-19
+ * @note    the modes are an fsm.h table in flash:
+ *            DRIVE              link lost / obstacle -> EMERGENCY
+ *              MANUAL           cruise, acc, lane keep -> ASSIST leaf, park -> PARK
+ *              ASSIST           manual -> MANUAL, cruise / acc / lane keep switch between the leaves, park -> PARK
+ *                CRUISE ACC LANE_KEEP
+ *              PARK             manual / park done -> MANUAL
+ *            EMERGENCY          clear -> MANUAL
+ *          only the module given by mode_get_owner() may command the motors, leaving ASSIST or entering EMERGENCY
+ *          brakes the car (vehicle_brake), leaving PARK cancels the parking assist. events are posted from any
+ *          context and applied by mode_step() on the control tick
+ */
+
+
+#ifndef MODE_MODE_H_
+#define MODE_MODE_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "fsm.h"
+#include "vehicle.h"
+#include "arbiter.h"
+#include "parking.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief states of the mode machine, DRIVE and ASSIST are never the active leaf
+ */
+typedef enum
+{
+    MODE_STATE_DRIVE = 0,
+    MODE_STATE_MANUAL,
+    MODE_STATE_ASSIST,
+    MODE_STATE_CRUISE,              // constant speed, the ACC controller without a target ahead
+    MODE_STATE_ACC,
+    MODE_STATE_LANE_KEEP,
+    MODE_STATE_PARK,
+    MODE_STATE_EMERGENCY,
+    MODE_STATES,
+}mode_state_t;
+
+/**
+ * @brief requests and conditions driving the modes
+ */
+typedef enum
+{
+    MODE_EVENT_MANUAL = 0,          // driver takes over
+    MODE_EVENT_CRUISE,
+    MODE_EVENT_ACC,
+    MODE_EVENT_LANE_KEEP,
+    MODE_EVENT_PARK,
+    MODE_EVENT_PARK_DONE,           // parking assist finished or failed
+    MODE_EVENT_OBSTACLE,            // AEB braking
+    MODE_EVENT_LINK_LOST,           // companion link timed out
+    MODE_EVENT_CLEAR,               // emergency acknowledged, car at rest
+    MODE_EVENTS,
+}mode_event_t;
+
+/**
+ * @brief this type represents the mode machine
+ * @param Fsm running machine
+ * @param Vehicle drivetrain braked by the exit and entry actions (can be NULL)
+ * @param Parking parking assist cancelled when PARK is left (can be NULL)
+ */
+typedef struct
+{
+    fsm_t Fsm;
+    vehicle_t *Vehicle;
+    parking_t *Parking;
+}mode_machine_t;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the mode machine in MANUAL
+ *
+ * @param p_Mode object of the mode machine
+ * @param p_Vehicle drivetrain (can be NULL)
+ * @param p_Parking parking assist (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t mode_init(mode_machine_t *p_Mode, vehicle_t *p_Vehicle, parking_t *p_Parking);
+
+/**
+ * @brief this function queues an event, safe from any handler
+ *
+ * @param p_Mode object of the mode machine
+ * @param p_Event event
+ * @return ecu_status_t ECU_ERROR if the queue is full
+ */
+ecu_status_t mode_post(mode_machine_t *p_Mode, mode_event_t p_Event);
+
+/**
+ * @brief this function applies the queued events, called once per control tick before the motors are commanded
+ *
+ * @param p_Mode object of the mode machine
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t mode_step(mode_machine_t *p_Mode);
+
+/**
+ * @brief this function tells the active mode
+ *
+ * @param p_Mode object of the mode machine
+ * @return mode_state_t active leaf state
+ */
+mode_state_t mode_get(const mode_machine_t *p_Mode);
+
+/**
+ * @brief this function tells which module owns the motor bank in the active mode
+ *
+ * @param p_Mode object of the mode machine
+ * @return mode_owner_t owner
+ */
+mode_owner_t mode_get_owner(const mode_machine_t *p_Mode);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* MODE_MODE_H_ */
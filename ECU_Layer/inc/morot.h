@@ -24,12 +24,42 @@
 *                                                    MACRO DEFINES                                                     *
 ***********************************************************************************************************************/
 #define MOTOR_MAX_SPEED (100)
+#define MOTOR_BANK_MAX_MOTORS (4)
+#define MOTOR_CURVE_POINTS (9)      // points of a calibration curve, evenly spaced over 0 .. MOTOR_MAX_SPEED
+#define MOTOR_LUT_SEGMENTS (64)     // segments of a compensation table, fixed by MOTOR_LUT_INIT
+#define MOTOR_DEFAULT_DEAD_ZONE (0.15f)     // duty below which the motors do not start
+#define MOTOR_DEFAULT_CURVATURE (0.0f)      // bend of the duty above the dead zone, -1 .. 1, 0 is linear
 
 
 
 /***********************************************************************************************************************
 *                                                   MACRO FUNCTIONS                                                    *
 ***********************************************************************************************************************/
+/**
+ * compare value of entry i of a compensation table: the dead zone is skipped and the rest of the duty range is
+ * bent by (1 - c) x + c x^2, which stays monotonic for -1 <= c <= 1. only constant arithmetic so the compiler
+ * folds the whole table into flash, TIMER_AUTO_RELOAD_VAL (ecu.h) must be visible where the table is defined
+ */
+#define MOTOR_LUT_ENTRY(i, deadZone, curvature) \
+    ((uint16_t)((((deadZone) + ((1.0f - (deadZone)) * ((float_t)(i) / (float_t)MOTOR_LUT_SEGMENTS) * \
+                  (1.0f - (curvature) + ((curvature) * ((float_t)(i) / (float_t)MOTOR_LUT_SEGMENTS))))) * \
+                 (float_t)TIMER_AUTO_RELOAD_VAL) + 0.5f))
+#define MOTOR_LUT_8(i, deadZone, curvature) \
+    MOTOR_LUT_ENTRY((i), deadZone, curvature), MOTOR_LUT_ENTRY((i) + 1, deadZone, curvature), \
+    MOTOR_LUT_ENTRY((i) + 2, deadZone, curvature), MOTOR_LUT_ENTRY((i) + 3, deadZone, curvature), \
+    MOTOR_LUT_ENTRY((i) + 4, deadZone, curvature), MOTOR_LUT_ENTRY((i) + 5, deadZone, curvature), \
+    MOTOR_LUT_ENTRY((i) + 6, deadZone, curvature), MOTOR_LUT_ENTRY((i) + 7, deadZone, curvature)
+/* initializer of a motor_lut_t, e.g. const motor_lut_t MotorLutFrontLeft = MOTOR_LUT_INIT(0.18f, 0.2f); */
+#define MOTOR_LUT_INIT(deadZone, curvature) \
+    {{ MOTOR_LUT_8(0, deadZone, curvature), MOTOR_LUT_8(8, deadZone, curvature), \
+       MOTOR_LUT_8(16, deadZone, curvature), MOTOR_LUT_8(24, deadZone, curvature), \
+       MOTOR_LUT_8(32, deadZone, curvature), MOTOR_LUT_8(40, deadZone, curvature), \
+       MOTOR_LUT_8(48, deadZone, curvature), MOTOR_LUT_8(56, deadZone, curvature), \
+       MOTOR_LUT_ENTRY(64, deadZone, curvature) }}
+
+#if MOTOR_LUT_SEGMENTS != 64
+#error "MOTOR_LUT_INIT expands exactly 64 segments"
+#endif
 
 
 
@@ -37,12 +67,34 @@
 /***********************************************************************************************************************
 *                                                      DATA TYPES                                                      *
 ***********************************************************************************************************************/
+/**
+ * @brief this type represents the measured speed to duty curve of one motor (see calibration.h)
+ * @param Compare compare value giving the speed k * MOTOR_MAX_SPEED / (MOTOR_CURVE_POINTS - 1) for point k,
+ *        point 0 is the end of the dead zone
+ */
+typedef struct
+{
+    uint16_t Compare[MOTOR_CURVE_POINTS];
+}motor_curve_t;
+
+/**
+ * @brief this type represents the build time compensation table of one motor, see MOTOR_LUT_INIT
+ * @param Compare compare value for the speed i * MaxClibratedSpeed / MOTOR_LUT_SEGMENTS, entry 0 is the end of
+ *        the dead zone
+ */
+typedef struct
+{
+    uint16_t Compare[MOTOR_LUT_SEGMENTS + 1];
+}motor_lut_t;
+
 /**
  * @brief this type represents the full interface with motor 
  * @param GpioxMotor array of two pointers each points to the port of each pin of the motor
  * @param GpioPinMotor array of two integers represents the pins selected for motor
  * @param SelectedTimer pointer to the selected time which generates the pwm for this motor
  * @param SelectedChannel the channel selected among the timer channels
+ * @param Curve calibration curve of the motor, used first when not NULL
+ * @param Lut compensation table of the motor, NULL for the table built from the MOTOR_DEFAULT_* constants
  */
 typedef struct
 {
@@ -50,6 +102,8 @@ typedef struct
     uint16_t GpioPinMotor[2];
     TIM_HandleTypeDef *SelectedTimer;
     uint8_t SelectedChannel;
+    const motor_curve_t *Curve;
+    const motor_lut_t *Lut;
 }motor_t;
 
 
@@ -93,6 +147,31 @@ ecu_status_t motor_move_backward(motor_t *p_Motor , float_t p_Speed);
  */
 ecu_status_t motor_stop(motor_t *p_Motor);
 
+/**
+  * @brief This function actively brakes the motor by shorting its terminals (both pins high, full duty)
+  * 
+  * @param p_Motor object of motor
+  * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t motor_brake(motor_t *p_Motor);
+
+/**
+  * @brief This function latches or releases the brake: while latched every drive write (forward, backward, stop,
+  *        change speed, bank set) is refused with ECU_ERROR and only motor_brake reaches the motors. the latch is
+  *        set before the motors are braked, a writer checks it with interrupts masked around its register writes
+  *
+  * @param p_Latched nonzero latches the brake, zero releases it
+  * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t motor_set_brake_latch(uint8_t p_Latched);
+
+/**
+  * @brief This function tells if the brake is latched
+  *
+  * @return uint8_t one while latched
+ */
+uint8_t motor_is_brake_latched(void);
+
 /**
   *
   * @brief This function change the speed of motor
@@ -103,6 +182,61 @@ ecu_status_t motor_stop(motor_t *p_Motor);
  */
 ecu_status_t motor_change_speed(motor_t *p_Motor , float_t p_Speed);
 
+/**
+  * @brief This function sets direction and speed of several motors in one batch, the direction pins are written
+  *        with one BSRR access per port and the compare registers are preloaded so all duties change on the
+  *        same timer update (call motor_bank_init once before). a motor whose pins change is cut off at once and
+  *        coasts until that update, it never runs in the new direction at its old duty
+  * 
+  * @param p_Motors array of motors
+  * @param p_Speeds signed speed of every motor, negative moves it backward
+  * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+  * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t motor_bank_set(motor_t *const *p_Motors, const float_t *p_Speeds, uint8_t p_Count);
+
+/**
+  * @brief This function loads the calibrated speed from the parameter store (param_init must run before),
+  *        the default stays when it was never calibrated
+  * 
+  * @return ecu_status_t ECU_ERROR if no calibration is stored
+ */
+ecu_status_t motor_load_calibration(void);
+
+/**
+  * @brief This function changes the speed mapped to full duty and keeps it in the parameter store
+  * 
+  * @param p_Speed calibrated speed (positive)
+  * @return ecu_status_t status of the operation
+ */
+ecu_status_t motor_set_calibration(float_t p_Speed);
+
+/**
+  * @brief This function follows a change of the pwm timer clock (power.h): compares are still given in
+  *        TIMER_AUTO_RELOAD_VAL units and scaled to the new period. called with interrupts masked
+  *
+  * @param p_Period auto reload + 1 now loaded in the timer
+  * @return ecu_status_t status of the operation
+ */
+ecu_status_t motor_set_pwm_period(uint32_t p_Period);
+
+/**
+  * @brief This function converts a compare value in TIMER_AUTO_RELOAD_VAL units to the running pwm period
+  *
+  * @param p_Compare compare at the nominal period
+  * @return uint32_t value of the compare register
+ */
+uint32_t motor_scale_compare(uint32_t p_Compare);
+
+/**
+  * @brief This function initializes the motors of a bank and enables the compare preload used by motor_bank_set
+  * 
+  * @param p_Motors array of motors
+  * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+  * @return ecu_status_t status of the operation
+ */
+ecu_status_t motor_bank_init(motor_t *const *p_Motors, uint8_t p_Count);
+
 
 /***********************************************************************************************************************
 * AUTHOR                |* NOTE                                                                                        *
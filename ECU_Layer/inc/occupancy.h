@@ -0,0 +1,115 @@
+/**
+ * @file    occupancy.h
+ * @author  Ahmed Hani
+ * @brief   polar occupancy histogram of recent range hits (36 sectors x 16 range bins) with age decay
+ * @date    2026-10-19
+ * @note    every cell is a 4 bit confidence, a sector is one 64 bit word so decay and ray clearing of a sector are
+ *          a few word operations. footprint is sizeof(occupancy_t) = 336 bytes, every update is O(1)
+ */
+
+
+#ifndef OCCUPANCY_OCCUPANCY_H_
+#define OCCUPANCY_OCCUPANCY_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "ecu_std.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define OCCUPANCY_SECTORS           (36)    // 10 degrees each
+#define OCCUPANCY_BINS              (16)    // fixed, one 64 bit row of 4 bit cells per sector
+#define OCCUPANCY_HIT_WEIGHT        (4)     // confidence added by one hit, a miss removes one
+#define OCCUPANCY_CELL_MAX          (15)
+#define OCCUPANCY_OCCUPIED          (8)     // fixed to the top bit of a cell so it is tested with one mask
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief polar map around the vehicle
+ * @param Rows cells of every sector, bin b is bits [4b, 4b + 3], bin 0 is the closest
+ * @param SectorEpoch epoch at which the decay of the sector was last applied
+ * @param Epoch current decay epoch, advanced by occupancy_tick()
+ * @param RefreshSector next sector refreshed by occupancy_tick() so no sector ages past the epoch wrap
+ * @param BinsPerMeter inverse of the bin width (Q16)
+ */
+typedef struct
+{
+    uint64_t Rows[OCCUPANCY_SECTORS];
+    uint8_t SectorEpoch[OCCUPANCY_SECTORS];
+    uint8_t Epoch;
+    uint8_t RefreshSector;
+    q16_t BinsPerMeter;
+}occupancy_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function clears the map
+ *
+ * @param p_Map object of occupancy map
+ * @param p_BinWidth radial size of a bin in meters, the map reaches OCCUPANCY_BINS times this
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t occupancy_init(occupancy_t *p_Map, float_t p_BinWidth);
+
+/**
+ * @brief this function ages the whole map by one epoch (every cell halves), O(1)
+ *
+ * @param p_Map object of occupancy map
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t occupancy_tick(occupancy_t *p_Map);
+
+/**
+ * @brief this function adds one range reading, the cells in front of the hit are cleared, O(1)
+ *
+ * @param p_Map object of occupancy map
+ * @param p_Bearing direction of the reading (binary angle), use heading + sensor mount for a map that survives turns
+ * @param p_Range filtered range in meters (Q16), beyond the map it only clears the sector
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t occupancy_update(occupancy_t *p_Map, uint32_t p_Bearing, q16_t p_Range);
+
+/**
+ * @brief this function finds the free direction closest to the preferred one
+ *
+ * @param p_Map object of occupancy map
+ * @param p_Preferred wanted direction (binary angle)
+ * @param p_Clearance needed free distance in meters (Q16)
+ * @param p_HalfWidth sectors on each side that must also be free (vehicle width)
+ * @param p_Direction center of the free sector found (binary angle)
+ * @return ecu_status_t ECU_ERROR if every direction is blocked
+ */
+ecu_status_t occupancy_find_free(const occupancy_t *p_Map, uint32_t p_Preferred, q16_t p_Clearance,
+                                 uint8_t p_HalfWidth, uint32_t *p_Direction);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* OCCUPANCY_OCCUPANCY_H_ */
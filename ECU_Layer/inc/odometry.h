@@ -0,0 +1,147 @@
+/**
+ * @file    odometry.h
+ * @author  Ahmed Hani
+ * @brief   dead reckoning pose (x, y, heading) from wheel encoder deltas and gyro yaw rate
+ * @date    2026-10-19
+ * @note    odometry_update() is written to run in the encoder timer interrupt (fixed point, table sin/cos),
+ *          readers take a consistent snapshot through a sequence lock and never disable interrupts
+ */
+
+
+#ifndef ODOMETRY_ODOMETRY_H_
+#define ODOMETRY_ODOMETRY_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "fixed_math.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief tuning of the odometry
+ * @param MetersPerTick distance travelled by a wheel per encoder tick
+ * @param TrackWidth effective distance between left and right wheels in meters (skid steer is wider than real)
+ * @param UpdatePeriod period of odometry_update() in seconds
+ * @param GyroWeight share of the gyro in the heading increment (0 = encoders only, 1 = gyro only)
+ */
+typedef struct
+{
+    float_t MetersPerTick;
+    float_t TrackWidth;
+    float_t UpdatePeriod;
+    float_t GyroWeight;
+}odometry_config_t;
+
+/**
+ * @brief snapshot of the pose
+ * @param X position along the start heading in meters (Q16)
+ * @param Y position to the left of the start heading in meters (Q16)
+ * @param Heading heading in radians (Q16), [-pi, pi), positive turns left
+ */
+typedef struct
+{
+    q16_t X;
+    q16_t Y;
+    q16_t Heading;
+}odometry_pose_t;
+
+/**
+ * @brief state of the odometry
+ * @param MetersPerTick see odometry_config_t (Q32 meters so the sub mm part is kept)
+ * @param EncoderTurn heading change per tick of difference between the sides (binary angle)
+ * @param GyroTurn heading change per rad/s of gyro rate over one period (binary angle)
+ * @param GyroWeight see odometry_config_t (Q16)
+ * @param X position in meters (Q32)
+ * @param Y position in meters (Q32)
+ * @param Heading heading (binary angle)
+ * @param Sequence odd while the published pose is being written
+ * @param Pose published pose
+ */
+typedef struct
+{
+    int64_t MetersPerTick;
+    int32_t EncoderTurn;
+    int32_t GyroTurn;
+    q16_t GyroWeight;
+    int64_t X;
+    int64_t Y;
+    uint32_t Heading;
+    volatile uint32_t Sequence;
+    odometry_pose_t Pose;
+}odometry_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the odometry at the origin
+ *
+ * @param p_Odometry object of odometry
+ * @param p_Config tuning of the odometry
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_init(odometry_t *p_Odometry, const odometry_config_t *p_Config);
+
+/**
+ * @brief this function moves the pose to a known place, must not race with odometry_update()
+ *
+ * @param p_Odometry object of odometry
+ * @param p_Pose new pose
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_set_pose(odometry_t *p_Odometry, const odometry_pose_t *p_Pose);
+
+/**
+ * @brief this function integrates one period of encoder ticks and gyro rate, single writer (encoder interrupt)
+ *
+ * @param p_Odometry object of odometry
+ * @param p_LeftTicks encoder ticks of the left side since the last call
+ * @param p_RightTicks encoder ticks of the right side since the last call
+ * @param p_YawRate gyro yaw rate in rad/s (Q16), positive turns left
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_update(odometry_t *p_Odometry, int32_t p_LeftTicks, int32_t p_RightTicks, q16_t p_YawRate);
+
+/**
+ * @brief this function copies a consistent pose, can be called from any context below the writer priority
+ *
+ * @param p_Odometry object of odometry
+ * @param p_Pose destination of the pose
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_get_pose(const odometry_t *p_Odometry, odometry_pose_t *p_Pose);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* ODOMETRY_ODOMETRY_H_ */
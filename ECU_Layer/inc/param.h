@@ -0,0 +1,141 @@
+/**
+ * @file    param.h
+ * @author  Ahmed Hani
+ * @brief   calibration / tuning values kept in flash as an append only log over two alternating 16 KB sectors
+ * @date    2026-10-19
+ * @note    sectors 1 and 2 (0x08004000 - 0x0800BFFF) are reserved by the linker script for the store.
+ *          sector = header (magic, generation) | records of 8 bytes (tag = key | check << 16, value), the last
+ *          record of a key wins. param_init() scans the newest sector once into a RAM table indexed by key, so
+ *          reads are O(1) and never touch flash. param_set() only updates the table, param_service() programs
+ *          one record per call and copies the table to the other sector when the log is full.
+ *          the F401 has one flash bank, every fetch from flash stalls while it is busy: programming a record
+ *          stalls ~40 us, erasing a sector ~0.5 s, so the erase never runs once the IWDG is started (the stall is
+ *          far beyond WATCHDOG_TIMEOUT_MS). param_init() erases the spare sector at boot, before watchdog_start():
+ *          every run can compact once, a log that fills a second time in the same run keeps its new values in RAM
+ *          (param_is_pending() stays zero) until the next boot erases the old sector
+ */
+
+
+#ifndef PARAM_PARAM_H_
+#define PARAM_PARAM_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "watchdog.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define PARAM_SECTOR_A_ADDRESS      (0x08004000UL)  // FLASH_SECTOR_1, keep in sync with STM32F401RCTX_FLASH.ld
+#define PARAM_SECTOR_B_ADDRESS      (0x08008000UL)  // FLASH_SECTOR_2
+#define PARAM_SECTOR_SIZE           (0x4000UL)
+#define PARAM_COPY_BURST            (4)             // records copied per param_service() while compacting
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief keys of the stored values, only append new keys at the end so old logs stay readable
+ */
+typedef enum
+{
+    PARAM_MAX_CALIBRATED_SPEED = 0,     // float, speed mapped to full duty by motor_change_speed
+    PARAM_MOTOR_CURVES,                 // 4 motors x 5 words, two curve points per word (calibration.h)
+    PARAM_MOTOR_CURVES_END = PARAM_MOTOR_CURVES + 20,
+    PARAM_KEYS = PARAM_MOTOR_CURVES_END,
+}param_key_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function finds the newest sector and loads every stored value into the RAM table, then erases the
+ *        spare sector if it is not blank (old code, stale log). call it before watchdog_start(), the erase stalls
+ *        the flash for 250 - 500 ms and is refused once the IWDG runs
+ *
+ * @return ecu_status_t ECU_ERROR if the spare sector could not be erased
+ */
+ecu_status_t param_init(void);
+
+/**
+ * @brief this function reads a value from the RAM table
+ *
+ * @param p_Key key of the value
+ * @param p_Value destination, untouched if the key was never stored
+ * @return ecu_status_t ECU_ERROR if the key was never stored (keep the default)
+ */
+ecu_status_t param_get(param_key_t p_Key, uint32_t *p_Value);
+
+/**
+ * @brief this function changes a value, callable from any context: only the RAM table is written, the flash
+ *        follows in param_service()
+ *
+ * @param p_Key key of the value
+ * @param p_Value new value
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t param_set(param_key_t p_Key, uint32_t p_Value);
+
+/**
+ * @brief this function reads a float value from the RAM table
+ *
+ * @param p_Key key of the value
+ * @param p_Value destination, untouched if the key was never stored
+ * @return ecu_status_t ECU_ERROR if the key was never stored (keep the default)
+ */
+ecu_status_t param_get_float(param_key_t p_Key, float_t *p_Value);
+
+/**
+ * @brief this function changes a float value, see param_set()
+ *
+ * @param p_Key key of the value
+ * @param p_Value new value
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t param_set_float(param_key_t p_Key, float_t p_Value);
+
+/**
+ * @brief this function moves the store one step forward, call it from the background loop: programs one changed
+ *        value, or copies a few values while compacting, or erases the unused sector when allowed
+ *
+ * @param p_AllowErase one when a ~0.5 s stall of the flash is acceptable (vehicle stopped)
+ * @return ecu_status_t ECU_ERROR if the flash reported an error or an erase was refused (IWDG started)
+ */
+ecu_status_t param_service(uint8_t p_AllowErase);
+
+/**
+ * @brief this function tells if param_service() has work it can do: a compaction, or changed values with room left
+ *        in the log or a blank spare sector to compact into
+ *
+ * @return uint8_t one while param_service() can make progress
+ */
+uint8_t param_is_pending(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* PARAM_PARAM_H_ */
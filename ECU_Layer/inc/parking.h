@@ -0,0 +1,188 @@
+/**
+ * @file    parking.h
+ * @author  Ahmed Hani
+ * @brief   parking assist, measures a parallel gap with a side range sensor and odometry then reverses into it
+ * @date    2026-10-19
+ * @note    the reverse path (two opposite arcs) is tabulated once when the gap is found, every step only indexes
+ *          and interpolates the table. the twist goes to the arbiter (MODE_OWNER_PARKING), a finished or cancelled
+ *          maneuver withdraws it so the arbiter brakes. AEB keeps priority, feed it with the rear sensor while
+ *          reversing
+ */
+
+
+#ifndef PARKING_PARKING_H_
+#define PARKING_PARKING_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "arbiter.h"
+#include "range_filter.h"
+#include "odometry.h"
+#include "aeb.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define PARKING_PATH_POINTS         (32)    // samples of the reverse path, evenly spaced in travelled distance
+#define PARKING_DEPTH_FILTER        (0.1f)  // smoothing of the distance to the parked cars while searching
+#define PARKING_COMMAND_TTL_MS      (100U)  // a few steps, a stalled maneuver loses the motors
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief side of the road the gap is searched on
+ */
+typedef enum
+{
+    PARKING_SIDE_RIGHT = 0,
+    PARKING_SIDE_LEFT,
+}parking_side_t;
+
+/**
+ * @brief phase of the maneuver
+ */
+typedef enum
+{
+    PARKING_IDLE = 0,
+    PARKING_SEARCHING,      // driving along the parked cars measuring the gap
+    PARKING_APPROACH,       // gap found, driving forward to the start of the reverse path
+    PARKING_REVERSE,        // following the reverse path
+    PARKING_DONE,
+    PARKING_ABORTED,        // the gap cannot be reached with the turn radius
+}parking_state_t;
+
+/**
+ * @brief tuning of the parking assist
+ * @param Side side of the road of the gap (and of the range sensor)
+ * @param VehicleWidth width of the car in meters
+ * @param GapDepth side range above which the space next to the car counts as free in meters
+ * @param GapLength free length needed to park in meters (car length plus margins)
+ * @param TurnRadius radius of the two reverse arcs in meters
+ * @param SearchSpeed forward speed while searching and approaching in m/s
+ * @param ManeuverSpeed reverse speed along the path in m/s
+ * @param HeadingGain correction of the heading error in 1/s
+ */
+typedef struct
+{
+    parking_side_t Side;
+    float_t VehicleWidth;
+    float_t GapDepth;
+    float_t GapLength;
+    float_t TurnRadius;
+    float_t SearchSpeed;
+    float_t ManeuverSpeed;
+    float_t HeadingGain;
+}parking_config_t;
+
+/**
+ * @brief state of the parking assist
+ * @param Config see parking_config_t
+ * @param Arbiter arbiter receiving the twist of the maneuver
+ * @param State see parking_state_t
+ * @param OriginX position where the search started in meters
+ * @param OriginY position where the search started in meters
+ * @param OriginHeading heading of the road (binary angle)
+ * @param AlongCos cosine of the road heading
+ * @param AlongSin sine of the road heading
+ * @param Depth smoothed distance to the parked cars in meters
+ * @param GapStart distance along the road where the gap began in meters, negative while none
+ * @param ReverseStart distance along the road where the reverse path begins in meters
+ * @param LastX last position in meters, for the travelled distance
+ * @param LastY last position in meters, for the travelled distance
+ * @param Travelled distance travelled along the reverse path in meters
+ * @param PathLength length of the reverse path in meters
+ * @param PointsPerMeter inverse of the spacing of the path points
+ * @param PathHeading heading relative to the road at every path point in radians
+ * @param PathCurvature heading change per meter travelled at every path point in rad/m
+ */
+typedef struct
+{
+    parking_config_t Config;
+    arbiter_t *Arbiter;
+    parking_state_t State;
+    float_t OriginX;
+    float_t OriginY;
+    uint32_t OriginHeading;
+    float_t AlongCos;
+    float_t AlongSin;
+    float_t Depth;
+    float_t GapStart;
+    float_t ReverseStart;
+    float_t LastX;
+    float_t LastY;
+    float_t Travelled;
+    float_t PathLength;
+    float_t PointsPerMeter;
+    float_t PathHeading[PARKING_PATH_POINTS];
+    float_t PathCurvature[PARKING_PATH_POINTS];
+}parking_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the parking assist in idle
+ *
+ * @param p_Parking object of parking assist
+ * @param p_Config tuning of the parking assist
+ * @param p_Arbiter arbiter receiving the twist
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_init(parking_t *p_Parking, const parking_config_t *p_Config, arbiter_t *p_Arbiter);
+
+/**
+ * @brief this function starts searching a gap, the car must be driving parallel to the parked cars
+ *
+ * @param p_Parking object of parking assist
+ * @param p_Pose current pose from the odometry
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_start(parking_t *p_Parking, const odometry_pose_t *p_Pose);
+
+/**
+ * @brief this function withdraws the twist of the assist (the arbiter brakes) and returns to idle
+ *
+ * @param p_Parking object of parking assist
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_cancel(parking_t *p_Parking);
+
+/**
+ * @brief this function runs one step of the assist and submits the twist to the arbiter
+ *
+ * @param p_Parking object of parking assist
+ * @param p_SideRange filtered range of the side sensor
+ * @param p_Pose current pose from the odometry
+ * @param p_Aeb emergency brake, nothing is commanded while it is braking (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_step(parking_t *p_Parking, const range_filter_t *p_SideRange, const odometry_pose_t *p_Pose,
+                          const aeb_t *p_Aeb);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* PARKING_PARKING_H_ */
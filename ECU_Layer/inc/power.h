@@ -0,0 +1,118 @@
+/**
+ * @file    power.h
+ * @author  Ahmed Hani
+ * @brief   power / performance profiles switched at run time (bus dividers on the running PLL) and STOP mode
+ * @date    2026-10-19
+ * @note    a transition re-derives the flash wait states, the SysTick reload, the ADC prescaler and the period of the
+ *          running APB1 timers (TIM4: motor pwm and the CC4 line sensor ADC trigger, period and compares scaled
+ *          together) so the pwm stays at 20 kHz and the trigger at the same delay in every profile, motor compares
+ *          are then set by motor_set_pwm_period(). PCLK1 is 42 MHz in every profile, USART2 and I2C1 keep their
+ *          settings. peripherals are initialized in the drive profile (the boot clock).
+ *          cycle based bounds are converted with SystemCoreClock when used (AEB latency, attitude dt) and every
+ *          telemetry buffer carries the clock of its timestamps, nothing keeps a cycle count from the boot profile
+ */
+
+
+#ifndef POWER_POWER_H_
+#define POWER_POWER_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "boot.h"
+#include "morot.h"
+#include "watchdog.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define POWER_NOMINAL_TIMER_CLOCK   (84000000UL)    // APB1 timer clock where TIMER_AUTO_RELOAD_VAL gives 20 kHz
+#define POWER_APB1_CLOCK            (42000000UL)    // USART2 baud rate and I2C1 timings are derived from it
+#define POWER_ADC_CLOCK             (21000000UL)
+#define POWER_WAIT_STATE_CLOCK      (30000000UL)    // HCLK per flash wait state, 2.7 .. 3.6 V
+/* RTC wake up that kicks the stretched IWDG in STOP, both count the LSI so the margin holds at any LSI frequency */
+#define POWER_STOP_REFRESH_MS       (10000UL)
+
+#if ((2UL * POWER_STOP_REFRESH_MS) > WATCHDOG_STOP_TIMEOUT_MS)
+#error "POWER_STOP_REFRESH_MS must stay well below WATCHDOG_STOP_TIMEOUT_MS"
+#endif
+
+/* STOP with the low power regulator and the flash powered down: lowest current, a few tens of us more to wake up */
+#ifndef POWER_STOP_DEEP
+#define POWER_STOP_DEEP             (1)
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief run profiles, all on the 84 MHz PLL
+ */
+typedef enum
+{
+    POWER_PROFILE_DRIVE = 0,        // HCLK 84 MHz, active driving
+    POWER_PROFILE_PARKED,           // HCLK 42 MHz, parked / idle, sensors and link keep running
+    POWER_PROFILES,
+}power_profile_t;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function switches to a run profile, safe while the motors and the sensors run
+ *
+ * @param p_Profile profile to run
+ * @return ecu_status_t ECU_ERROR for an unknown profile or one that would change PCLK1
+ */
+ecu_status_t power_set_profile(power_profile_t p_Profile);
+
+/**
+ * @brief this function tells the running profile
+ *
+ * @return power_profile_t profile set by the last power_set_profile()
+ */
+power_profile_t power_get_profile(void);
+
+/**
+ * @brief this function stops every clock until an EXTI interrupt (IMU data ready, echo, button ...), the handler
+ *        runs after the clocks of the running profile are back. USART2 cannot wake the core. while the IWDG runs
+ *        its timeout is stretched and the RTC wakes the core every POWER_STOP_REFRESH_MS to kick it, the core
+ *        goes straight back to STOP when nothing else is pending
+ *
+ * @return ecu_status_t ECU_ERROR if a motor is still driven (its output would freeze), a supervised task is late,
+ *         the RTC runs on another clock than the LSI or the HSE did not restart
+ */
+ecu_status_t power_enter_stop(void);
+
+/**
+ * @brief this function clears the RTC wake up, call it from RTC_WKUP_IRQHandler. power_enter_stop clears its own
+ *        wake ups before the interrupts are unmasked, the handler only runs for a stray one
+ */
+void power_wakeup_irq(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* POWER_POWER_H_ */
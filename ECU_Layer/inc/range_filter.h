@@ -0,0 +1,101 @@
+/**
+ * @file    range_filter.h
+ * @author  Ahmed Hani
+ * @brief   fixed point filtering for range streams (ultrasonic / ToF), sliding median followed by alpha-beta tracker
+ * @date    2026-10-19
+ * @note    the median adds (RANGE_FILTER_MEDIAN_WINDOW - 1) / 2 samples of latency, keep the window small
+ */
+
+
+#ifndef RANGE_FILTER_RANGE_FILTER_H_
+#define RANGE_FILTER_RANGE_FILTER_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "ecu_std.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define RANGE_FILTER_MEDIAN_WINDOW  (5)         // only 3 or 5 are supported (sorting networks)
+#define RANGE_FILTER_MAX_RANGE_MM   (4000)      // readings above this (or zero = no echo) are clamped to it
+
+#if (RANGE_FILTER_MEDIAN_WINDOW != 3) && (RANGE_FILTER_MEDIAN_WINDOW != 5)
+#error "RANGE_FILTER_MEDIAN_WINDOW must be 3 or 5"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief state of one range stream filter
+ * @param Window last raw samples in mm (ring buffer)
+ * @param WindowIndex position of the next sample in the window
+ * @param Initialized set after the first sample seeded the filter
+ * @param Alpha position gain of the tracker (Q16)
+ * @param BetaOverDt velocity gain divided by the sample period in 1/s (Q16)
+ * @param SamplePeriod sample period in seconds (Q16)
+ * @param Range filtered range in meters (Q16), output
+ * @param ClosingSpeed filtered closing speed in m/s (Q16), positive when the target approaches, output
+ */
+typedef struct
+{
+    uint16_t Window[RANGE_FILTER_MEDIAN_WINDOW];
+    uint8_t WindowIndex;
+    uint8_t Initialized;
+    q16_t Alpha;
+    q16_t BetaOverDt;
+    q16_t SamplePeriod;
+    q16_t Range;
+    q16_t ClosingSpeed;
+}range_filter_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the range filter, the only place that uses float math
+ *
+ * @param p_Filter object of range filter
+ * @param p_Alpha position gain of the tracker (0 < alpha <= 1)
+ * @param p_Beta velocity gain of the tracker (0 < beta <= 2)
+ * @param p_SamplePeriod time between two samples in seconds
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t range_filter_init(range_filter_t *p_Filter, float_t p_Alpha, float_t p_Beta, float_t p_SamplePeriod);
+
+/**
+ * @brief this function pushes one raw reading through the median and the tracker, constant time
+ *
+ * @param p_Filter object of range filter
+ * @param p_RawRangeMm raw reading in mm, zero means no echo
+ * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t range_filter_update(range_filter_t *p_Filter, uint16_t p_RawRangeMm);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* RANGE_FILTER_RANGE_FILTER_H_ */
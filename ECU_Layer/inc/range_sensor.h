@@ -0,0 +1,91 @@
+/**
+ * @file    range_sensor.h
+ * @author  Ahmed Hani
+ * @brief   forward ultrasonic range sensor (HC-SR04 type), echo measured by TIM2 input capture
+ * @date    2026-10-19
+ * @note    TIM2 CH3 (PB10) sends the trigger pulse at every counter update, TIM2 CH1 / CH2 both capture the echo on
+ *          PA15 (CH1 rising, CH2 falling, PWM input), only the falling edge interrupts. the echo width is the
+ *          difference of the captures and the edge time in cpu cycles is taken back from the counter, TIM2 runs
+ *          unprescaled at the core clock in both power profiles (HCLK = timer clock). TIM2 is not rescaled by
+ *          power_set_profile: in PARKED the trigger pulse and the period are twice as long, the range stays right.
+ *          the callback runs in the capture interrupt at RANGE_SENSOR_IRQ_PRIORITY, above every other sensor, to
+ *          feed the range filter and the AEB (aeb.h)
+ */
+
+
+#ifndef RANGE_SENSOR_RANGE_SENSOR_H_
+#define RANGE_SENSOR_RANGE_SENSOR_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define RANGE_SENSOR_PERIOD_MS      (50)        // trigger period, longer than the 38 ms echo of an empty field
+#define RANGE_SENSOR_TRIGGER_US     (10)        // trigger pulse, the sensor needs 10 us at least
+#define RANGE_SENSOR_MAX_ECHO_US    (30000)     // longer echoes (no target, 38 ms) are reported as zero
+#define RANGE_SENSOR_IRQ_PRIORITY   (0)         // above the IMU, the line sensor and the UART
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief called from the capture interrupt with every echo, must be short
+ *
+ * @param p_RangeMm range in mm, zero when no echo came back
+ * @param p_EchoEdgeCycles CYCLE_COUNTER_NOW() at the falling edge of the echo
+ */
+typedef void (*range_sensor_callback_t)(uint16_t p_RangeMm, uint32_t p_EchoEdgeCycles);
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures PA15, PB10 and TIM2 then starts triggering
+ *
+ * @param p_Callback called with every echo from the capture interrupt
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t range_sensor_init(range_sensor_callback_t p_Callback);
+
+/**
+ * @brief this function handles the echo capture, call it from TIM2_IRQHandler
+ */
+ECU_RAMFUNC void range_sensor_irq(void);
+
+/**
+ * @brief this function returns the number of echoes measured since init
+ *
+ * @return uint32_t echoes
+ */
+uint32_t range_sensor_get_count(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* RANGE_SENSOR_RANGE_SENSOR_H_ */
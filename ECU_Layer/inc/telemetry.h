@@ -0,0 +1,125 @@
+/**
+ * @file    telemetry.h
+ * @author  Ahmed Hani
+ * @brief   binary telemetry, delta / varint coded records collected in two buffers sent alternately by UART DMA
+ * @date    2026-10-19
+ * @note    every buffer goes out as one link frame of type LINK_MSG_TELEMETRY and decodes on its own:
+ *          payload = sequence (u8) | dropped records (varint) | core clock (varint kHz) | base timestamp (u32 cycles)
+ *          | records. a buffer holds timestamps of one clock only, a power profile change starts a new buffer (the
+ *          records taken while the previous buffer is still on the wire keep its clock, a DMA transfer at most).
+ *          record = channel (u8) | cycles since the previous record (varint) | fields (zigzag varint of the
+ *          difference to the previous record of the channel in the same buffer). Tools/telemetry_decode.py
+ *          decodes the stream, keep its channel table in sync with TelemetryFieldCounts
+ */
+
+
+#ifndef TELEMETRY_TELEMETRY_H_
+#define TELEMETRY_TELEMETRY_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "link.h"
+#include "cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define TELEMETRY_BUFFER_SIZE       (LINK_HEADER_SIZE + LINK_MAX_PAYLOAD + LINK_CRC_SIZE)  // one whole link frame
+#define TELEMETRY_MAX_FIELDS        (4)
+
+#if (LINK_MAX_PAYLOAD > 255)
+#error "a telemetry buffer must fit the one byte length of a link frame"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief record channels, the number of fields of every channel is fixed
+ */
+typedef enum
+{
+    TELEMETRY_WHEEL_SPEEDS = 0,     // 4 fields, mm/s, vehicle_wheel_t order
+    TELEMETRY_MOTOR_DUTIES,         // 4 fields, 1/1000 of full speed, signed
+    TELEMETRY_RANGES,               // 4 fields, mm, front / rear / left / right
+    TELEMETRY_POSE,                 // 3 fields, x mm, y mm, heading mrad
+    TELEMETRY_TASK_TIMING,          // 2 fields, task id, cycles
+    TELEMETRY_LOG,                  // 4 fields, LOGGER_PRINT header and arguments, see logger.h
+    TELEMETRY_CHANNELS,
+}telemetry_channel_t;
+
+/**
+ * @brief counters of the telemetry
+ * @param Records records written
+ * @param Dropped records lost because both buffers were busy
+ * @param Frames buffers handed to the UART
+ */
+typedef struct
+{
+    uint32_t Records;
+    uint32_t Dropped;
+    uint32_t Frames;
+}telemetry_stats_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function resets both buffers, the UART must already be initialized (link_init)
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t telemetry_init(void);
+
+/**
+ * @brief this function appends one record, callable from any context, never waits: a record that finds both
+ *        buffers busy is dropped and counted
+ *
+ * @param p_Channel channel of the record
+ * @param p_Values fields of the record, as many as the channel has
+ * @return ecu_status_t ECU_ERROR if the record was dropped or the channel is unknown
+ */
+ecu_status_t telemetry_record(telemetry_channel_t p_Channel, const int32_t *p_Values);
+
+/**
+ * @brief this function sends the partly filled buffer if the UART is free, call it from a periodic task
+ *        to bound the latency when few records are written. it also resends a full buffer that found the UART busy
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t telemetry_flush(void);
+
+/**
+ * @brief this function copies the counters of the telemetry
+ *
+ * @param p_Stats destination of the counters
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t telemetry_get_stats(telemetry_stats_t *p_Stats);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* TELEMETRY_TELEMETRY_H_ */
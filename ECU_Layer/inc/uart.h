@@ -0,0 +1,114 @@
+/**
+ * @file    uart.h
+ * @author  Ahmed Hani
+ * @brief   USART2 transport to the companion computer, reception by circular DMA with idle line detection,
+ *          transmission by one shot DMA
+ * @date    2026-10-19
+ * @note    the UART HAL driver is not part of the project, USART2 is programmed through CMSIS registers.
+ *          there is no per byte interrupt: the ring is handed to the consumer on DMA half / full and on line idle.
+ *          pins: PA2 TX, PA3 RX
+ */
+
+
+#ifndef UART_UART_H_
+#define UART_UART_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define UART_BAUD_RATE              (2000000UL)     // exact from the 42 MHz APB1 clock with 8x oversampling
+#define UART_RX_RING_SIZE           (512)           // power of two, holds two frames of LINK_MAX_PAYLOAD
+#define UART_IRQ_PRIORITY           (3)
+
+#if (UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1)) != 0
+#error "UART_RX_RING_SIZE must be a power of two"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief called from the interrupt with the unread part of the ring, must be short
+ * @param p_Ring the DMA ring, read in place
+ * @param p_Read offset of the first unread byte
+ * @param p_Write offset where the DMA writes next, the unread bytes are [p_Read, p_Write) modulo the ring size
+ * @return offset of the first byte the consumer still needs (incomplete frame)
+ */
+typedef uint32_t (*uart_rx_callback_t)(const uint8_t *p_Ring, uint32_t p_Read, uint32_t p_Write);
+
+/**
+ * @brief called from the DMA interrupt once a transmit buffer was handed to the USART and can be reused
+ */
+typedef void (*uart_tx_callback_t)(void);
+
+
+
+/***********************************************************************************************************************
+*                                                   EXTERN OBJECTS                                                     *
+***********************************************************************************************************************/
+extern DMA_HandleTypeDef hdma_usart2_rx;
+extern DMA_HandleTypeDef hdma_usart2_tx;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures the pins, USART2 and DMA1 streams 5 (RX) and 6 (TX) then starts reception
+ *
+ * @param p_Callback consumer of the received bytes
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t uart_init(uart_rx_callback_t p_Callback);
+
+/**
+ * @brief this function starts sending a buffer, never waits
+ *
+ * @param p_Data data to send, must stay untouched until p_Done is called
+ * @param p_Length number of bytes
+ * @param p_Done called when the buffer is free again (can be NULL)
+ * @return ecu_status_t ECU_ERROR if a transmission is already running
+ */
+ecu_status_t uart_transmit(const uint8_t *p_Data, uint16_t p_Length, uart_tx_callback_t p_Done);
+
+/**
+ * @brief this function tells if a transmission is running
+ *
+ * @return uint8_t one while the transmit DMA is busy
+ */
+uint8_t uart_is_transmitting(void);
+
+/**
+ * @brief USART2 interrupt, only the idle line is enabled
+ */
+void uart_irq(void);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* UART_UART_H_ */
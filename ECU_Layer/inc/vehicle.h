@@ -0,0 +1,137 @@
+/**
+ * @file    vehicle.h
+ * @author  Ahmed Hani
+ * @brief   skid steer kinematics over the motor bank, one twist (speed, yaw rate) drives all four wheels
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+
+#ifndef VEHICLE_VEHICLE_H_
+#define VEHICLE_VEHICLE_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "morot.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief position of every wheel in the motor bank
+ */
+typedef enum
+{
+    VEHICLE_WHEEL_FRONT_LEFT = 0,
+    VEHICLE_WHEEL_FRONT_RIGHT,
+    VEHICLE_WHEEL_REAR_LEFT,
+    VEHICLE_WHEEL_REAR_RIGHT,
+    VEHICLE_WHEELS,
+}vehicle_wheel_t;
+
+/**
+ * @brief drivetrain geometry
+ * @param TrackWidth distance between left and right wheels in meters
+ * @param MaxWheelSpeed wheel speed at full motor speed in m/s
+ * @param Reversed one for every motor whose wiring / mounting turns it backward on a forward command
+ */
+typedef struct
+{
+    float_t TrackWidth;
+    float_t MaxWheelSpeed;
+    uint8_t Reversed[VEHICLE_WHEELS];
+}vehicle_config_t;
+
+/**
+ * @brief state of the drivetrain
+ * @param Motors motor of every wheel, indexed by vehicle_wheel_t
+ * @param HalfTrack half the track width in meters
+ * @param MaxWheelSpeed see vehicle_config_t
+ * @param WheelToMotor factor from m/s to motor speed units including the sign of every motor
+ * @param WheelSpeeds last commanded wheel speeds in m/s
+ * @param Speed last applied forward speed in m/s (after saturation)
+ * @param YawRate last applied yaw rate in rad/s (after saturation), positive turns left
+ */
+typedef struct
+{
+    motor_t *Motors[VEHICLE_WHEELS];
+    float_t HalfTrack;
+    float_t MaxWheelSpeed;
+    float_t WheelToMotor[VEHICLE_WHEELS];
+    float_t WheelSpeeds[VEHICLE_WHEELS];
+    float_t Speed;
+    float_t YawRate;
+}vehicle_t;
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the drivetrain and its motor bank, the car starts standing still
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @param p_Config geometry of the drivetrain
+ * @param p_Motors motor of every wheel, indexed by vehicle_wheel_t
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t vehicle_init(vehicle_t *p_Vehicle, const vehicle_config_t *p_Config, motor_t *const *p_Motors);
+
+/**
+ * @brief this function drives the car with a forward speed and a yaw rate, if a wheel would exceed its limit both
+ *        are scaled down together so the path curvature is kept, all wheels are written in one batch
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @param p_Speed forward speed in m/s
+ * @param p_YawRate yaw rate in rad/s, positive turns left
+ * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t vehicle_set_twist(vehicle_t *p_Vehicle, float_t p_Speed, float_t p_YawRate);
+
+/**
+ * @brief this function stops all wheels
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t vehicle_stop(vehicle_t *p_Vehicle);
+
+/**
+ * @brief this function brakes all wheels (motor_brake), unlike vehicle_stop it holds the car and is never refused
+ *        by the AEB brake latch
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t vehicle_brake(vehicle_t *p_Vehicle);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* VEHICLE_VEHICLE_H_ */
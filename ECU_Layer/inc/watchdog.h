@@ -0,0 +1,141 @@
+/**
+ * @file    watchdog.h
+ * @author  Ahmed Hani
+ * @brief   independent watchdog (IWDG) kicked by a supervisor only while every critical task checks in on time
+ * @date    2026-10-19
+ * @note    every registered task sets its bit with WATCHDOG_CHECK_IN (one store to the SRAM bit-band alias, atomic
+ *          from any handler) at least once per window. watchdog_supervise() runs on every SysTick, collects the
+ *          bits and kicks the IWDG only when no task is late, a late task is latched and the IWDG resets the MCU
+ *          (pwm and direction pins back to their reset state) WATCHDOG_TIMEOUT_MS later at most. a stalled loop is
+ *          detected after its window + 1 ms, a dead SysTick or a core stuck with the interrupts masked after the
+ *          IWDG timeout. the IWDG of the F401 has no window register, the windows are the task deadlines.
+ *          once started the IWDG can not be stopped, it keeps counting in STOP mode: power_enter_stop stretches it
+ *          to WATCHDOG_STOP_TIMEOUT_MS (watchdog_set_stop) and wakes up on the RTC to kick it.
+ *          a flash sector erase stalls the core for 250 - 500 ms, far past the timeout: param_service never erases
+ *          once the IWDG runs, param_init() erases the spare parameter sector and must run before watchdog_start()
+ */
+
+
+#ifndef WATCHDOG_WATCHDOG_H_
+#define WATCHDOG_WATCHDOG_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "stm32f4xx_hal.h"
+#include "ecu_std.h"
+#include "boot.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define WATCHDOG_MAX_TASKS          (32)
+#define WATCHDOG_TIMEOUT_MS         (30)        // IWDG timeout at the nominal LSI, 20 ms at its fastest (47 kHz)
+#define WATCHDOG_LSI_HZ             (32000UL)   // nominal LSI, 17 .. 47 kHz over temperature and parts
+#define WATCHDOG_PRESCALER          (4)         // LSI / 4, 125 us counts: 30 ms fits the 12 bit reload
+#define WATCHDOG_STOP_PRESCALER     (256)       // LSI / 256 and the full 12 bit reload while in STOP mode
+#define WATCHDOG_STOP_TIMEOUT_MS    ((4096UL * WATCHDOG_STOP_PRESCALER * 1000UL) / WATCHDOG_LSI_HZ)  // 32 s nominal
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* word of the SRAM bit-band alias holding bit b of the word at a */
+#define WATCHDOG_BITBAND(a, b) \
+    (*(volatile uint32_t *)(SRAM1_BB_BASE + (((uint32_t)(a) - SRAM1_BASE) << 5) + ((uint32_t)(b) << 2)))
+/* check in of a task (0 .. WATCHDOG_MAX_TASKS - 1), a single store */
+#define WATCHDOG_CHECK_IN(task)     (WATCHDOG_BITBAND(&WatchdogCheckIns, (task)) = 1U)
+
+
+
+/***********************************************************************************************************************
+*                                                   EXTERN OBJECTS                                                     *
+***********************************************************************************************************************/
+extern volatile uint32_t WatchdogCheckIns;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief this type represents the watchdog state and the cause of the last reset
+ * @param Registered bit of every supervised task
+ * @param Stalled tasks found late in this run (the IWDG is no longer kicked when not 0)
+ * @param ResetByWatchdog the last reset came from the IWDG
+ * @param StalledBeforeReset tasks that were late when the IWDG reset the MCU, 0 if the reset had another cause
+ */
+typedef struct
+{
+    uint32_t Registered;
+    uint32_t Stalled;
+    uint8_t ResetByWatchdog;
+    uint32_t StalledBeforeReset;
+}watchdog_report_t;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function adds a task to the supervision, its window starts now. call before watchdog_start, a task
+ *        can not leave the supervision
+ *
+ * @param p_Task task number, 0 .. WATCHDOG_MAX_TASKS - 1
+ * @param p_WindowMs longest time allowed between two check ins in milliseconds (2 at least)
+ * @return ecu_status_t ECU_ERROR for a wrong task number or window
+ */
+ecu_status_t watchdog_register(uint8_t p_Task, uint32_t p_WindowMs);
+
+/**
+ * @brief this function starts the IWDG (LSI, WATCHDOG_TIMEOUT_MS), it is frozen while the debugger halts the core
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t watchdog_start(void);
+
+/**
+ * @brief this function collects the check ins and kicks the IWDG if no task is late, called from SysTick_Handler
+ */
+void watchdog_supervise(void);
+
+/**
+ * @brief this function stretches the IWDG timeout to WATCHDOG_STOP_TIMEOUT_MS for STOP mode (no SysTick, no
+ *        supervisor) or brings WATCHDOG_TIMEOUT_MS back, the IWDG is kicked either way. nothing is kicked once a
+ *        task is late, a stall is never forgiven
+ *
+ * @param p_Stop one before STOP and on every wake up that goes back to STOP, zero after the last wake up
+ * @return ecu_status_t ECU_ERROR if a task is late, the timeout is left as it was
+ */
+ecu_status_t watchdog_set_stop(uint8_t p_Stop);
+
+/**
+ * @brief this function tells if the IWDG runs
+ *
+ * @return uint8_t nonzero once watchdog_start was called
+ */
+uint8_t watchdog_is_started(void);
+
+/**
+ * @brief this function reports the supervision state and the cause of the last reset (read by watchdog_start)
+ *
+ * @param p_Report destination
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t watchdog_get_report(watchdog_report_t *p_Report);
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* WATCHDOG_WATCHDOG_H_ */
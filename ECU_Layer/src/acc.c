@@ -0,0 +1,211 @@
+/**
+ * @file    acc.c
+ * @author  Ahmed Hani
+ * @brief   adaptive cruise control, keeps a set speed or a time gap to the vehicle ahead
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/acc.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static inline float_t acc_clamp(float_t p_Value, float_t p_Min, float_t p_Max);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the cruise controller, the car starts with zero set speed
+ *
+ * @param p_Acc object of cruise controller
+ * @param p_Config tuning of the controller
+ * @param p_Arbiter arbiter receiving the speed commands
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t acc_init(acc_t *p_Acc, const acc_config_t *p_Config, arbiter_t *p_Arbiter)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Acc) || (NULL == p_Config) || (NULL == p_Arbiter) ||
+        (p_Config->StepPeriod <= 0.0f) || (p_Config->MaxVehicleSpeed <= 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Acc, ZERO, sizeof(acc_t));
+        p_Acc->Config = *p_Config;
+        p_Acc->Arbiter = p_Arbiter;
+        p_Acc->MaxJerkStep = p_Config->MaxJerk * p_Config->StepPeriod;
+
+        l_EcuStatus = cycle_counter_init();
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function changes the driver settings
+ *
+ * @param p_Acc object of cruise controller
+ * @param p_SetSpeed cruise speed in m/s
+ * @param p_TimeGap time gap to the vehicle ahead in seconds
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t acc_set_target(acc_t *p_Acc, float_t p_SetSpeed, float_t p_TimeGap)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Acc) || (p_SetSpeed < 0.0f) || (p_TimeGap < 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Acc->SetSpeed = acc_clamp(p_SetSpeed, 0.0f, p_Acc->Config.MaxVehicleSpeed);
+        p_Acc->TimeGap = p_TimeGap;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function runs one control step and submits the speed command to the arbiter
+ *
+ * @param p_Acc object of cruise controller
+ * @param p_Range filtered forward range and closing speed
+ * @param p_WheelSpeeds measured wheel speeds in m/s
+ * @param p_WheelCount number of wheel speeds
+ * @param p_Aeb emergency brake, while it is braking the controller only follows the real speed (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t acc_step(acc_t *p_Acc, const range_filter_t *p_Range, const float_t *p_WheelSpeeds,
+                      uint8_t p_WheelCount, const aeb_t *p_Aeb)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Acc) || (NULL == p_Range) || (NULL == p_WheelSpeeds) || (ZERO == p_WheelCount))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_StartCycles = CYCLE_COUNTER_NOW();
+        const acc_config_t *l_Config = &p_Acc->Config;
+
+        float_t l_EgoSpeed = 0.0f;
+        for (uint8_t l_Index = ZERO; l_Index < p_WheelCount; l_Index++)
+        {
+            l_EgoSpeed += p_WheelSpeeds[l_Index];
+        }
+        l_EgoSpeed = l_EgoSpeed / (float_t)p_WheelCount;
+
+        if (aeb_is_braking(p_Aeb))
+        {
+            /* AEB owns the motors, track the real speed with zero acceleration so the hand back is bumpless */
+            p_Acc->SpeedCommand = l_EgoSpeed;
+            p_Acc->Accel = 0.0f;
+        }
+        else
+        {
+            float_t l_Accel = l_Config->SpeedGain * (p_Acc->SetSpeed - l_EgoSpeed);
+
+            float_t l_Range = Q16_TO_FLOAT(p_Range->Range);
+            if (l_Range < l_Config->DetectRange)
+            {
+                float_t l_DesiredGap = l_Config->StandstillGap + (p_Acc->TimeGap * l_EgoSpeed);
+                float_t l_GapAccel = (l_Config->GapGain * (l_Range - l_DesiredGap)) -
+                                     (l_Config->ClosingGain * Q16_TO_FLOAT(p_Range->ClosingSpeed));
+                l_Accel = (l_GapAccel < l_Accel) ? l_GapAccel : l_Accel;
+            }
+
+            l_Accel = acc_clamp(l_Accel, -l_Config->MaxDecel, l_Config->MaxAccel);
+            l_Accel = acc_clamp(l_Accel, p_Acc->Accel - p_Acc->MaxJerkStep, p_Acc->Accel + p_Acc->MaxJerkStep);
+            p_Acc->Accel = l_Accel;
+
+            p_Acc->SpeedCommand = acc_clamp(p_Acc->SpeedCommand + (l_Accel * l_Config->StepPeriod),
+                                            0.0f, l_Config->MaxVehicleSpeed);
+            arbiter_command_t l_Command = { p_Acc->SpeedCommand, 0.0f };
+            l_EcuStatus = arbiter_submit(p_Acc->Arbiter, MODE_OWNER_ACC, &l_Command, ARBITER_PRIORITY_ASSIST,
+                                         ACC_COMMAND_TTL_MS);
+        }
+
+        p_Acc->LastStepCycles = CYCLE_COUNTER_ELAPSED(l_StartCycles);
+        if (p_Acc->LastStepCycles > p_Acc->WorstStepCycles)
+        {
+            p_Acc->WorstStepCycles = p_Acc->LastStepCycles;
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief limits a value to a range without calling libm
+ *
+ * @param p_Value value to be limited
+ * @param p_Min lower limit
+ * @param p_Max upper limit
+ * @return float_t limited value
+ */
+static inline float_t acc_clamp(float_t p_Value, float_t p_Min, float_t p_Max)
+{
+    float_t l_Value = (p_Value < p_Min) ? p_Min : p_Value;
+    return (l_Value > p_Max) ? p_Max : l_Value;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
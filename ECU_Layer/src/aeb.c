@@ -0,0 +1,236 @@
+/**
+ * @file    aeb.c
+ * @author  Ahmed Hani
+ * @brief   automatic emergency braking, time-to-collision check run directly in the range sensor context
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/aeb.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+
+
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the emergency brake
+ *
+ * @param p_Aeb object of emergency brake
+ * @param p_Config tuning of the brake
+ * @param p_Motors motors to be braked
+ * @param p_MotorCount number of motors (up to AEB_MAX_MOTORS)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t aeb_init(aeb_t *p_Aeb, const aeb_config_t *p_Config, motor_t *const *p_Motors, uint8_t p_MotorCount)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Aeb) || (NULL == p_Config) || (NULL == p_Motors) ||
+        (ZERO == p_MotorCount) || (p_MotorCount > AEB_MAX_MOTORS))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Aeb, ZERO, sizeof(aeb_t));
+        for (uint8_t l_Index = ZERO; l_Index < p_MotorCount; l_Index++)
+        {
+            p_Aeb->Motors[l_Index] = p_Motors[l_Index];
+        }
+        p_Aeb->MotorCount = p_MotorCount;
+        p_Aeb->BaseTtc = Q16_FROM_FLOAT(p_Config->BaseTtc);
+        p_Aeb->TtcPerSpeed = Q16_FROM_FLOAT(p_Config->TtcPerSpeed);
+        p_Aeb->MinDistance = Q16_FROM_FLOAT(p_Config->MinDistance);
+        p_Aeb->LatencyBoundUs = p_Config->LatencyBoundUs;
+        p_Aeb->FaultCallback = p_Config->FaultCallback;
+
+        l_EcuStatus = cycle_counter_init();
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function evaluates the time-to-collision and brakes if needed, constant time
+ *
+ * @param p_Aeb object of emergency brake
+ * @param p_Range filtered forward range (already updated with the sample of this echo)
+ * @param p_EgoSpeed own speed in m/s (Q16)
+ * @param p_EchoEdgeCycles CYCLE_COUNTER_NOW() taken at the echo edge that produced this sample
+ * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t aeb_on_range(aeb_t *p_Aeb, const range_filter_t *p_Range, q16_t p_EgoSpeed, uint32_t p_EchoEdgeCycles)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Aeb) || (NULL == p_Range))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        /* ttc = range / closing < threshold is evaluated as range < closing * threshold, no divide */
+        q16_t l_TtcThreshold = p_Aeb->BaseTtc + Q16_MUL(p_Aeb->TtcPerSpeed, p_EgoSpeed);
+        q16_t l_BrakeDistance = Q16_MUL(p_Range->ClosingSpeed, l_TtcThreshold);
+        uint8_t l_Hazard = (p_Range->Range <= p_Aeb->MinDistance) ||
+                           ((p_Range->ClosingSpeed > ZERO) && (p_Range->Range < l_BrakeDistance));
+
+        if (l_Hazard)
+        {
+            // latched first: a writer that checked the latch before has finished its masked write already
+            (void)motor_set_brake_latch(1);
+            for (uint8_t l_Index = ZERO; l_Index < p_Aeb->MotorCount; l_Index++)
+            {
+                (void)motor_brake(p_Aeb->Motors[l_Index]);
+            }
+            if (ZERO == p_Aeb->Braking)
+            {
+                p_Aeb->Braking = 1;
+                p_Aeb->Activations++;
+            }
+        }
+        else if ((p_Aeb->Braking) && (p_EgoSpeed <= ZERO))
+        {
+            // release only once the car stands still and the obstacle is no longer a threat
+            p_Aeb->Braking = ZERO;
+            (void)motor_set_brake_latch(ZERO);
+        }
+        else
+        {
+            /* nothing to do */
+        }
+
+        /* measured on every sample so the bound is verified during normal driving too, not only when braking */
+        uint32_t l_Latency = CYCLE_COUNTER_ELAPSED(p_EchoEdgeCycles);
+        p_Aeb->LastLatencyCycles = l_Latency;
+        if (l_Latency > p_Aeb->WorstLatencyCycles)
+        {
+            p_Aeb->WorstLatencyCycles = l_Latency;
+        }
+        // converted on use, the core clock changes with the power profile
+        if (l_Latency > CYCLE_COUNTER_US_TO_CYCLES(p_Aeb->LatencyBoundUs))
+        {
+            p_Aeb->LatencyViolations++;
+            p_Aeb->LatencyFault = 1;
+            if (NULL != p_Aeb->FaultCallback)
+            {
+                p_Aeb->FaultCallback(l_Latency);
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function reports if the brake is latched
+ *
+ * @param p_Aeb object of emergency brake
+ * @return uint8_t one while braking
+ */
+uint8_t aeb_is_braking(const aeb_t *p_Aeb)
+{
+    uint8_t l_Braking = ZERO;
+    if (NULL != p_Aeb)
+    {
+        l_Braking = p_Aeb->Braking;
+    }
+    return l_Braking;
+}
+
+/**
+ * @brief this function reports if a sample missed the latency bound since init or the last aeb_clear_fault()
+ *
+ * @param p_Aeb object of emergency brake
+ * @return uint8_t one on a fault
+ */
+uint8_t aeb_has_fault(const aeb_t *p_Aeb)
+{
+    uint8_t l_Fault = ZERO;
+    if (NULL != p_Aeb)
+    {
+        l_Fault = p_Aeb->LatencyFault;
+    }
+    return l_Fault;
+}
+
+/**
+ * @brief this function acknowledges the latency fault, the violation counter keeps counting
+ *
+ * @param p_Aeb object of emergency brake
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t aeb_clear_fault(aeb_t *p_Aeb)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Aeb)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Aeb->LatencyFault = ZERO;
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,309 @@
+/**
+ * @file    arbiter.c
+ * @author  Ahmed Hani
+ * @brief   motor command arbiter: every producer submits a twist with a priority and a time to live, the live command
+ *          with the highest priority among the sources allowed by the active mode drives the vehicle
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/arbiter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define ARBITER_EMPTY               (0U)    // priority of an empty slot
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* the deadline is in the past or now, safe across the tick counter wrap */
+#define ARBITER_STALE(deadline, now)    ((int32_t)((deadline) - (now)) <= 0)
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static ecu_status_t arbiter_apply(arbiter_t *p_Arbiter);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the arbiter with every slot empty
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Vehicle drivetrain to command (can be NULL)
+ * @param p_Aeb emergency brake (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t arbiter_init(arbiter_t *p_Arbiter, vehicle_t *p_Vehicle, const aeb_t *p_Aeb)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if (NULL == p_Arbiter)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Arbiter->Vehicle = p_Vehicle;
+        p_Arbiter->Aeb = p_Aeb;
+        for (uint8_t l_Source = ZERO; l_Source < ARBITER_SOURCES; l_Source++)
+        {
+            p_Arbiter->Slots[l_Source].Priority = ARBITER_EMPTY;
+            p_Arbiter->Expired[l_Source] = ZERO;
+        }
+        p_Arbiter->Owner = MODE_OWNER_NONE;
+        p_Arbiter->Winner = MODE_OWNER_NONE;
+        p_Arbiter->WorstApplyCycles = ZERO;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function replaces the request of a source and, if the source may drive in the active mode, writes the
+ *        winner to the vehicle at once. safe from any handler (link callback, line sensor DMA, AEB)
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Source source of the request
+ * @param p_Command requested motion
+ * @param p_Priority priority, 1 .. 255
+ * @param p_TtlMs time to live in milliseconds, 1 .. ARBITER_MAX_TTL_MS (clamped)
+ * @return ecu_status_t ECU_ERROR for an unknown source, a zero priority, a zero time to live or a refused write
+ */
+ecu_status_t arbiter_submit(arbiter_t *p_Arbiter, mode_owner_t p_Source, const arbiter_command_t *p_Command,
+                            uint8_t p_Priority, uint32_t p_TtlMs)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if ((NULL == p_Arbiter) || (NULL == p_Command) || (MODE_OWNER_NONE == p_Source) ||
+        (p_Source >= ARBITER_SOURCES) || (ARBITER_EMPTY == p_Priority) || (ZERO == p_TtlMs))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        volatile arbiter_slot_t *l_Slot = &p_Arbiter->Slots[p_Source];
+        uint32_t l_Deadline = HAL_GetTick() + ((p_TtlMs > ARBITER_MAX_TTL_MS) ? ARBITER_MAX_TTL_MS : p_TtlMs);
+        uint32_t l_Primask = __get_PRIMASK();
+
+        // the tick must never see the speed of one request with the yaw rate of another
+        __disable_irq();
+        l_Slot->Command.Speed = p_Command->Speed;
+        l_Slot->Command.YawRate = p_Command->YawRate;
+        l_Slot->Priority = p_Priority;
+        l_Slot->Deadline = l_Deadline;
+        __set_PRIMASK(l_Primask);
+
+        // a source that can not win in the active mode only waits in its slot
+        if ((p_Arbiter->Owner == p_Source) || (p_Priority >= ARBITER_PRIORITY_SAFETY))
+        {
+            l_EcuStatus = arbiter_apply(p_Arbiter);
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function withdraws the request of a source at once, the next live command (or the brake) is written
+ *        right away when the source was driving
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Source source of the request
+ * @return ecu_status_t ECU_ERROR for an unknown source
+ */
+ecu_status_t arbiter_release(arbiter_t *p_Arbiter, mode_owner_t p_Source)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if ((NULL == p_Arbiter) || (p_Source >= ARBITER_SOURCES))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Arbiter->Slots[p_Source].Priority = ARBITER_EMPTY;
+        if (p_Arbiter->Winner == p_Source)
+        {
+            l_EcuStatus = arbiter_apply(p_Arbiter);
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function takes the owner of the active mode and expires the stale requests, then writes the winner to
+ *        the vehicle or brakes it when nothing is live or the AEB brakes. called once per control tick (after
+ *        mode_step), the submits in between are written when they arrive
+ *
+ * @param p_Arbiter object of the arbiter
+ * @param p_Owner owner of the active mode (mode_get_owner)
+ * @return ecu_status_t status of vehicle_set_twist / vehicle_brake
+ */
+ecu_status_t arbiter_tick(arbiter_t *p_Arbiter, mode_owner_t p_Owner)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if (NULL == p_Arbiter)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Arbiter->Owner = p_Owner;
+        l_EcuStatus = arbiter_apply(p_Arbiter);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function tells which source drove the vehicle on the last tick
+ *
+ * @param p_Arbiter object of the arbiter
+ * @return mode_owner_t winner, MODE_OWNER_NONE when the car was braked (or no arbiter)
+ */
+mode_owner_t arbiter_get_winner(const arbiter_t *p_Arbiter)
+{
+    mode_owner_t l_Winner = MODE_OWNER_NONE;
+
+    if (NULL != p_Arbiter)
+    {
+        l_Winner = p_Arbiter->Winner;
+    }
+    return l_Winner;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief expires the stale slots, picks the live command with the highest priority among the eligible sources and
+ *        writes it, all with interrupts masked: a submit from a higher priority handler can not slip its own write
+ *        between the choice and the registers of a lower one
+ *
+ * @param p_Arbiter object of the arbiter
+ * @return ecu_status_t status of vehicle_set_twist / vehicle_brake
+ */
+static ecu_status_t arbiter_apply(arbiter_t *p_Arbiter)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_StartCycles = CYCLE_COUNTER_NOW();
+    uint32_t l_Now = HAL_GetTick();
+    mode_owner_t l_Owner = p_Arbiter->Owner;
+    mode_owner_t l_Winner = MODE_OWNER_NONE;
+    uint8_t l_WinnerPriority = ARBITER_EMPTY;
+    arbiter_command_t l_Command = { 0.0f, 0.0f };
+    uint32_t l_Primask = __get_PRIMASK();
+
+    __disable_irq();
+    // one pass over a fixed number of slots, the first source wins a tie
+    for (uint8_t l_Source = MODE_OWNER_NONE + 1; l_Source < ARBITER_SOURCES; l_Source++)
+    {
+        volatile arbiter_slot_t *l_Slot = &p_Arbiter->Slots[l_Source];
+
+        if ((ARBITER_EMPTY != l_Slot->Priority) && ARBITER_STALE(l_Slot->Deadline, l_Now))
+        {
+            l_Slot->Priority = ARBITER_EMPTY;
+            p_Arbiter->Expired[l_Source]++;
+        }
+        else
+        {
+            /* Nothing */
+        }
+
+        if ((l_Slot->Priority > l_WinnerPriority) &&
+            ((l_Owner == l_Source) || (l_Slot->Priority >= ARBITER_PRIORITY_SAFETY)))
+        {
+            l_Winner = (mode_owner_t)l_Source;
+            l_WinnerPriority = l_Slot->Priority;
+            l_Command.Speed = l_Slot->Command.Speed;
+            l_Command.YawRate = l_Slot->Command.YawRate;
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+
+    if (aeb_is_braking(p_Arbiter->Aeb))
+    {
+        // a twist would be refused by the brake latch anyway, the brake is written again instead
+        p_Arbiter->Winner = MODE_OWNER_AEB;
+        l_EcuStatus = (NULL != p_Arbiter->Vehicle) ? vehicle_brake(p_Arbiter->Vehicle) : ECU_OK;
+    }
+    else if (MODE_OWNER_NONE == l_Winner)
+    {
+        // nothing live: the car is held, a zero twist would only let it coast
+        p_Arbiter->Winner = MODE_OWNER_NONE;
+        l_EcuStatus = (NULL != p_Arbiter->Vehicle) ? vehicle_brake(p_Arbiter->Vehicle) : ECU_OK;
+    }
+    else
+    {
+        p_Arbiter->Winner = l_Winner;
+        l_EcuStatus = (NULL != p_Arbiter->Vehicle) ?
+                      vehicle_set_twist(p_Arbiter->Vehicle, l_Command.Speed, l_Command.YawRate) : ECU_OK;
+    }
+    __set_PRIMASK(l_Primask);
+
+    l_StartCycles = CYCLE_COUNTER_ELAPSED(l_StartCycles);
+    if (l_StartCycles > p_Arbiter->WorstApplyCycles)
+    {
+        p_Arbiter->WorstApplyCycles = l_StartCycles;
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,286 @@
+/**
+ * @file    attitude.c
+ * @author  Ahmed Hani
+ * @brief   Mahony complementary attitude filter (quaternion) fed by the IMU samples
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/attitude.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define ATTITUDE_INV_SQRT_MAGIC     (0x5F375A86UL)
+#define ATTITUDE_Q16_TO_FLOAT       (1.0f / 65536.0f)
+#define ATTITUDE_MAX_PERIOD_FACTOR  (4.0f)      // longer gaps (FIFO flush) fall back to the nominal period
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static inline float_t attitude_inv_sqrt(float_t p_Value);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the filter at level with zero yaw
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Config tuning of the filter
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_init(attitude_t *p_Attitude, const attitude_config_t *p_Config)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Attitude) || (NULL == p_Config) || (p_Config->Kp < 0.0f) ||
+        (p_Config->Ki < 0.0f) || (p_Config->SamplePeriod <= 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Attitude, ZERO, sizeof(attitude_t));
+        p_Attitude->Config = *p_Config;
+        p_Attitude->Q[0] = 1.0f;
+        (void)cycle_counter_init();
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function runs one filter step
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Gyro angular rate around x, y, z in rad/s
+ * @param p_Accel acceleration along x, y, z (any unit, only the direction is used)
+ * @param p_Period time since the previous step in seconds
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_update(attitude_t *p_Attitude, const float_t *p_Gyro, const float_t *p_Accel, float_t p_Period)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Attitude) || (NULL == p_Gyro) || (NULL == p_Accel))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        float_t l_Q0 = p_Attitude->Q[0], l_Q1 = p_Attitude->Q[1], l_Q2 = p_Attitude->Q[2], l_Q3 = p_Attitude->Q[3];
+        float_t l_Gx = p_Gyro[0] - p_Attitude->GyroBias[0];
+        float_t l_Gy = p_Gyro[1] - p_Attitude->GyroBias[1];
+        float_t l_Gz = p_Gyro[2] - p_Attitude->GyroBias[2];
+        float_t l_Ax = p_Accel[0], l_Ay = p_Accel[1], l_Az = p_Accel[2];
+        float_t l_Norm = fmaf(l_Ax, l_Ax, fmaf(l_Ay, l_Ay, l_Az * l_Az));
+
+        // free fall (or no accel) leaves the gyro alone in charge
+        if (l_Norm > 0.0f)
+        {
+            l_Norm = attitude_inv_sqrt(l_Norm);
+            l_Ax *= l_Norm;
+            l_Ay *= l_Norm;
+            l_Az *= l_Norm;
+
+            /* gravity direction predicted by the quaternion (third row of the rotation matrix) */
+            float_t l_Vx = 2.0f * fmaf(l_Q1, l_Q3, -l_Q0 * l_Q2);
+            float_t l_Vy = 2.0f * fmaf(l_Q0, l_Q1, l_Q2 * l_Q3);
+            float_t l_Vz = fmaf(l_Q0, l_Q0, fmaf(-l_Q1, l_Q1, fmaf(-l_Q2, l_Q2, l_Q3 * l_Q3)));
+
+            /* error is the rotation from the predicted to the measured gravity */
+            float_t l_Ex = fmaf(l_Ay, l_Vz, -l_Az * l_Vy);
+            float_t l_Ey = fmaf(l_Az, l_Vx, -l_Ax * l_Vz);
+            float_t l_Ez = fmaf(l_Ax, l_Vy, -l_Ay * l_Vx);
+
+            if (p_Attitude->Config.Ki > 0.0f)
+            {
+                float_t l_KiDt = p_Attitude->Config.Ki * p_Period;
+                p_Attitude->GyroBias[0] = fmaf(-l_KiDt, l_Ex, p_Attitude->GyroBias[0]);
+                p_Attitude->GyroBias[1] = fmaf(-l_KiDt, l_Ey, p_Attitude->GyroBias[1]);
+                p_Attitude->GyroBias[2] = fmaf(-l_KiDt, l_Ez, p_Attitude->GyroBias[2]);
+                l_Gx = fmaf(l_KiDt, l_Ex, l_Gx);
+                l_Gy = fmaf(l_KiDt, l_Ey, l_Gy);
+                l_Gz = fmaf(l_KiDt, l_Ez, l_Gz);
+            }
+            l_Gx = fmaf(p_Attitude->Config.Kp, l_Ex, l_Gx);
+            l_Gy = fmaf(p_Attitude->Config.Kp, l_Ey, l_Gy);
+            l_Gz = fmaf(p_Attitude->Config.Kp, l_Ez, l_Gz);
+        }
+
+        /* q += 0.5 * q x (0, g) * dt */
+        float_t l_HalfPeriod = 0.5f * p_Period;
+        l_Gx *= l_HalfPeriod;
+        l_Gy *= l_HalfPeriod;
+        l_Gz *= l_HalfPeriod;
+        float_t l_N0 = fmaf(-l_Q1, l_Gx, fmaf(-l_Q2, l_Gy, fmaf(-l_Q3, l_Gz, l_Q0)));
+        float_t l_N1 = fmaf(l_Q0, l_Gx, fmaf(l_Q2, l_Gz, fmaf(-l_Q3, l_Gy, l_Q1)));
+        float_t l_N2 = fmaf(l_Q0, l_Gy, fmaf(-l_Q1, l_Gz, fmaf(l_Q3, l_Gx, l_Q2)));
+        float_t l_N3 = fmaf(l_Q0, l_Gz, fmaf(l_Q1, l_Gy, fmaf(-l_Q2, l_Gx, l_Q3)));
+
+        l_Norm = attitude_inv_sqrt(fmaf(l_N0, l_N0, fmaf(l_N1, l_N1, fmaf(l_N2, l_N2, l_N3 * l_N3))));
+        p_Attitude->Q[0] = l_N0 * l_Norm;
+        p_Attitude->Q[1] = l_N1 * l_Norm;
+        p_Attitude->Q[2] = l_N2 * l_Norm;
+        p_Attitude->Q[3] = l_N3 * l_Norm;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function runs the filter over a burst of IMU samples, the period of every step comes from the
+ *        sample timestamps converted with the core clock running now (power profiles change it)
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Samples samples, oldest first
+ * @param p_Count number of samples
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_update_batch(attitude_t *p_Attitude, const imu_sample_t *p_Samples, uint8_t p_Count)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Attitude) || (NULL == p_Samples) || (ZERO == p_Count))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_StartCycles = CYCLE_COUNTER_NOW();
+        float_t l_MaxPeriod = ATTITUDE_MAX_PERIOD_FACTOR * p_Attitude->Config.SamplePeriod;
+        /* one divide per burst: a gap spanning a clock switch is off by the clock ratio at most, and only once */
+        float_t l_SecondsPerCycle = 1.0f / (float_t)SystemCoreClock;
+
+        for (uint8_t l_Index = ZERO; l_Index < p_Count; l_Index++)
+        {
+            const imu_sample_t *l_Sample = &p_Samples[l_Index];
+            float_t l_Gyro[3];
+            float_t l_Accel[3];
+            float_t l_Period = p_Attitude->Config.SamplePeriod;
+
+            // Q16 to float is a single vcvt + vmul per axis
+            for (uint8_t l_Axis = ZERO; l_Axis < 3; l_Axis++)
+            {
+                l_Gyro[l_Axis] = (float_t)l_Sample->Gyro[l_Axis] * ATTITUDE_Q16_TO_FLOAT;
+                l_Accel[l_Axis] = (float_t)l_Sample->Accel[l_Axis] * ATTITUDE_Q16_TO_FLOAT;
+            }
+            if (p_Attitude->HasTimestamp)
+            {
+                l_Period = (float_t)(l_Sample->Timestamp - p_Attitude->LastTimestamp) * l_SecondsPerCycle;
+                if ((l_Period <= 0.0f) || (l_Period > l_MaxPeriod))
+                {
+                    l_Period = p_Attitude->Config.SamplePeriod;
+                }
+            }
+            p_Attitude->LastTimestamp = l_Sample->Timestamp;
+            p_Attitude->HasTimestamp = 1;
+
+            (void)attitude_update(p_Attitude, l_Gyro, l_Accel, l_Period);
+        }
+
+        p_Attitude->CyclesPerSample = CYCLE_COUNTER_ELAPSED(l_StartCycles) / p_Count;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function converts the quaternion to euler angles, uses the libm trigonometry so keep it out of the
+ *        sample rate path
+ *
+ * @param p_Attitude object of attitude filter
+ * @param p_Euler destination of the angles
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t attitude_get_euler(const attitude_t *p_Attitude, attitude_euler_t *p_Euler)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Attitude) || (NULL == p_Euler))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        float_t l_Q0 = p_Attitude->Q[0], l_Q1 = p_Attitude->Q[1], l_Q2 = p_Attitude->Q[2], l_Q3 = p_Attitude->Q[3];
+        float_t l_SinPitch = 2.0f * fmaf(l_Q0, l_Q2, -l_Q3 * l_Q1);
+
+        l_SinPitch = (l_SinPitch > 1.0f) ? 1.0f : ((l_SinPitch < -1.0f) ? -1.0f : l_SinPitch);
+        p_Euler->Roll = atan2f(2.0f * fmaf(l_Q0, l_Q1, l_Q2 * l_Q3), 1.0f - (2.0f * fmaf(l_Q1, l_Q1, l_Q2 * l_Q2)));
+        p_Euler->Pitch = asinf(l_SinPitch);
+        p_Euler->Yaw = atan2f(2.0f * fmaf(l_Q0, l_Q3, l_Q1 * l_Q2), 1.0f - (2.0f * fmaf(l_Q2, l_Q2, l_Q3 * l_Q3)));
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief 1 / sqrt(x) from the exponent trick and two newton steps (relative error below 5e-6),
+ *        cheaper than vsqrt followed by vdiv (14 + 14 cycles)
+ *
+ * @param p_Value positive value
+ * @return float_t inverse square root
+ */
+static inline float_t attitude_inv_sqrt(float_t p_Value)
+{
+    union
+    {
+        float_t Float;
+        uint32_t Bits;
+    }l_Conv = {p_Value};
+    float_t l_Half = 0.5f * p_Value;
+
+    l_Conv.Bits = ATTITUDE_INV_SQRT_MAGIC - (l_Conv.Bits >> 1);
+    l_Conv.Float *= fmaf(-l_Half, l_Conv.Float * l_Conv.Float, 1.5f);
+    l_Conv.Float *= fmaf(-l_Half, l_Conv.Float * l_Conv.Float, 1.5f);
+    return l_Conv.Float;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,244 @@
+/**
+ * @file    boot.c
+ * @author  Ahmed Hani
+ * @brief   boot time profile (DWT timestamps of every start-up phase kept in .noinit) and the fast boot clock
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/boot.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define BOOT_PLLCFGR_MASK           (RCC_PLLCFGR_PLLM | RCC_PLLCFGR_PLLN | RCC_PLLCFGR_PLLP | RCC_PLLCFGR_PLLSRC | \
+                                     RCC_PLLCFGR_PLLQ)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static uint32_t boot_core_clock(void);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+/* written before .bss is cleared and kept over a reset, the debugger or the application reads it after boot */
+static boot_table_t BootTable ECU_NOINIT;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function records the end of a boot phase, BOOT_STAMP_RESET also starts the DWT and the table
+ *
+ * @param p_Stamp phase that just ended
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t boot_mark(boot_stamp_t p_Stamp)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (p_Stamp >= BOOT_STAMPS)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        if (BOOT_STAMP_RESET == p_Stamp)
+        {
+            // the DWT is only reset at power up, restart it so every boot has the same origin
+            CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+            DWT->CYCCNT = ZERO;
+            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+            if (BOOT_MAGIC != BootTable.Magic)
+            {
+                BootTable.Magic = BOOT_MAGIC;
+                BootTable.BootCount = ZERO;
+            }
+            BootTable.BootCount++;
+            BootTable.ResetFlags = RCC->CSR;
+            RCC->CSR |= RCC_CSR_RMVF;
+
+            // a zero clock marks a phase this boot did not reach
+            for (uint8_t l_Index = ZERO; l_Index < BOOT_STAMPS; l_Index++)
+            {
+                BootTable.Cycles[l_Index] = ZERO;
+                BootTable.Clock[l_Index] = ZERO;
+            }
+        }
+        BootTable.Cycles[p_Stamp] = DWT->CYCCNT;
+        BootTable.Clock[p_Stamp] = boot_core_clock();
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function runs the core on the PLL (84 MHz) with the flash wait states and ART caches set, called from
+ *        SystemInit when BOOT_FAST_CLOCK is set. SystemCoreClock is not updated (.data is not copied yet)
+ *
+ * @return ecu_status_t ECU_ERROR if the HSE did not start, the core then stays on HSI
+ */
+ecu_status_t boot_fast_clock(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Timeout = BOOT_HSE_TIMEOUT;
+
+    // bypass has to be selected while the HSE is off
+    RCC->CR |= RCC_CR_HSEBYP;
+    RCC->CR |= RCC_CR_HSEON;
+    while ((ZERO == (RCC->CR & RCC_CR_HSERDY)) && (l_Timeout > ZERO))
+    {
+        l_Timeout--;
+    }
+
+    if (ZERO == (RCC->CR & RCC_CR_HSERDY))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // the regulator resets to scale 2 on the F401, enough for 84 MHz
+        RCC->PLLCFGR = (RCC->PLLCFGR & ~BOOT_PLLCFGR_MASK) | RCC_PLLCFGR_PLLSRC_HSE |
+                       ((uint32_t)BOOT_PLL_M << RCC_PLLCFGR_PLLM_Pos) |
+                       ((uint32_t)BOOT_PLL_N << RCC_PLLCFGR_PLLN_Pos) |
+                       ((uint32_t)((BOOT_PLL_P >> 1) - 1) << RCC_PLLCFGR_PLLP_Pos) |
+                       ((uint32_t)BOOT_PLL_Q << RCC_PLLCFGR_PLLQ_Pos);
+        RCC->CR |= RCC_CR_PLLON;
+
+        // wait states and bus dividers first, while the PLL locks: 2 wait states at 84 MHz, APB1 at most 42 MHz
+        FLASH->ACR = FLASH_ACR_LATENCY_2WS | FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN;
+        while ((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_2WS)
+        {
+            /* Nothing */
+        }
+        RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2)) | RCC_CFGR_PPRE1_DIV2;
+
+        while (ZERO == (RCC->CR & RCC_CR_PLLRDY))
+        {
+            /* Nothing */
+        }
+        RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_PLL;
+        while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL)
+        {
+            /* Nothing */
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function converts the profile of the last boot, every phase is timed with the clock it started on
+ *
+ * @param p_Report destination of the profile
+ * @return ecu_status_t ECU_ERROR if the table was never written
+ */
+ecu_status_t boot_get_report(boot_report_t *p_Report)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Report) || (BOOT_MAGIC != BootTable.Magic))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint8_t l_Last = BOOT_STAMP_RESET;
+
+        p_Report->PhaseUs[BOOT_STAMP_RESET] = ZERO;
+        p_Report->TotalUs = ZERO;
+        for (uint8_t l_Index = BOOT_STAMP_RESET + 1; l_Index < BOOT_STAMPS; l_Index++)
+        {
+            p_Report->PhaseUs[l_Index] = ZERO;
+            if (ZERO != BootTable.Clock[l_Index])
+            {
+                // a phase after a skipped one is timed from the last stamp taken
+                uint32_t l_Cycles = BootTable.Cycles[l_Index] - BootTable.Cycles[l_Last];
+                p_Report->PhaseUs[l_Index] = l_Cycles / (BootTable.Clock[l_Last] / 1000000U);
+                p_Report->TotalUs += p_Report->PhaseUs[l_Index];
+                l_Last = l_Index;
+            }
+        }
+        p_Report->BootCount = BootTable.BootCount;
+        p_Report->ResetFlags = BootTable.ResetFlags;
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief core clock read back from the RCC registers, SystemCoreClock cannot be used before .data is copied
+ *
+ * @return uint32_t HCLK in Hz
+ */
+static uint32_t boot_core_clock(void)
+{
+    uint32_t l_Clock = HSI_VALUE;
+    uint32_t l_Source = RCC->CFGR & RCC_CFGR_SWS;
+
+    if (RCC_CFGR_SWS_HSE == l_Source)
+    {
+        l_Clock = HSE_VALUE;
+    }
+    else if (RCC_CFGR_SWS_PLL == l_Source)
+    {
+        uint32_t l_Pll = RCC->PLLCFGR;
+        uint32_t l_Input = (l_Pll & RCC_PLLCFGR_PLLSRC) ? HSE_VALUE : HSI_VALUE;
+        uint32_t l_M = (l_Pll & RCC_PLLCFGR_PLLM) >> RCC_PLLCFGR_PLLM_Pos;
+        uint32_t l_N = (l_Pll & RCC_PLLCFGR_PLLN) >> RCC_PLLCFGR_PLLN_Pos;
+        uint32_t l_P = (((l_Pll & RCC_PLLCFGR_PLLP) >> RCC_PLLCFGR_PLLP_Pos) + 1U) * 2U;
+        l_Clock = ((l_Input / l_M) * l_N) / l_P;
+    }
+    else
+    {
+        /* Nothing */
+    }
+    return l_Clock >> AHBPrescTable[(RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
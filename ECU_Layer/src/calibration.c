@@ -0,0 +1,394 @@
+/**
+ * @file    calibration.c
+ * @author  Ahmed Hani
+ * @brief   automatic motor calibration: duty sweep with encoder feedback, builds the speed to duty curve of every motor
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/calibration.h"
+#include "../inc/ecu.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+_Static_assert((CALIBRATION_CURVE_WORDS * MOTOR_BANK_MAX_MOTORS) == (PARAM_MOTOR_CURVES_END - PARAM_MOTOR_CURVES),
+               "the parameter keys of the curves do not match MOTOR_CURVE_POINTS");
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define CALIBRATION_LEVEL_COMPARE(level)    ((uint32_t)(level) * TIMER_AUTO_RELOAD_VAL / CALIBRATION_DUTY_STEPS)
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void calibration_apply_level(calibration_t *p_Calibration);
+static ecu_status_t calibration_build(calibration_t *p_Calibration);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the calibration in idle
+ *
+ * @param p_Calibration object of calibration
+ * @param p_Config tuning of the calibration
+ * @param p_Motors motors to calibrate, same order as the measured speeds
+ * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_init(calibration_t *p_Calibration, const calibration_config_t *p_Config,
+                              motor_t *const *p_Motors, uint8_t p_Count)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Calibration) || (NULL == p_Config) || (NULL == p_Motors) || (ZERO == p_Count) ||
+        (p_Count > MOTOR_BANK_MAX_MOTORS) || (ZERO == p_Config->SamplePeriods) ||
+        (p_Config->MovingFraction <= 0.0f) || (p_Config->MovingFraction >= 1.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Calibration, ZERO, sizeof(calibration_t));
+        p_Calibration->Config = *p_Config;
+        p_Calibration->Count = p_Count;
+        p_Calibration->State = CALIBRATION_IDLE;
+        for (uint8_t l_Motor = ZERO; (l_Motor < p_Count) && (ECU_OK == l_EcuStatus); l_Motor++)
+        {
+            if (NULL == p_Motors[l_Motor])
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                p_Calibration->Motors[l_Motor] = p_Motors[l_Motor];
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function starts the sweep, the motors turn forward
+ *
+ * @param p_Calibration object of calibration
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_start(calibration_t *p_Calibration)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Calibration)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Calibration->Level = ZERO;
+        p_Calibration->Period = ZERO;
+        for (uint8_t l_Motor = ZERO; l_Motor < p_Calibration->Count; l_Motor++)
+        {
+            p_Calibration->Sums[l_Motor] = 0.0f;
+            (void)motor_move_forward(p_Calibration->Motors[l_Motor], 0.0f);
+        }
+        calibration_apply_level(p_Calibration);
+        p_Calibration->State = CALIBRATION_SWEEP;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function stops the motors and returns to idle
+ *
+ * @param p_Calibration object of calibration
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_cancel(calibration_t *p_Calibration)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Calibration)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Calibration->Level = ZERO;
+        calibration_apply_level(p_Calibration);
+        for (uint8_t l_Motor = ZERO; l_Motor < p_Calibration->Count; l_Motor++)
+        {
+            (void)motor_stop(p_Calibration->Motors[l_Motor]);
+        }
+        p_Calibration->State = CALIBRATION_IDLE;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function runs one period of the sweep, call it at a fixed rate with the encoder speeds
+ *
+ * @param p_Calibration object of calibration
+ * @param p_Speeds measured speed of every motor (magnitude, any unit common to all motors, e.g. ticks per period)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_step(calibration_t *p_Calibration, const float_t *p_Speeds)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Calibration) || (NULL == p_Speeds))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else if (CALIBRATION_SWEEP != p_Calibration->State)
+    {
+        /* Nothing */
+    }
+    else
+    {
+        p_Calibration->Period++;
+        if (p_Calibration->Period > p_Calibration->Config.SettlePeriods)
+        {
+            for (uint8_t l_Motor = ZERO; l_Motor < p_Calibration->Count; l_Motor++)
+            {
+                p_Calibration->Sums[l_Motor] += p_Speeds[l_Motor];
+            }
+        }
+
+        if (p_Calibration->Period >= (p_Calibration->Config.SettlePeriods + p_Calibration->Config.SamplePeriods))
+        {
+            float_t l_Scale = 1.0f / (float_t)p_Calibration->Config.SamplePeriods;
+            for (uint8_t l_Motor = ZERO; l_Motor < p_Calibration->Count; l_Motor++)
+            {
+                p_Calibration->Speeds[l_Motor][p_Calibration->Level] = p_Calibration->Sums[l_Motor] * l_Scale;
+                p_Calibration->Sums[l_Motor] = 0.0f;
+            }
+            p_Calibration->Period = ZERO;
+            p_Calibration->Level++;
+
+            if (p_Calibration->Level > CALIBRATION_DUTY_STEPS)
+            {
+                (void)calibration_cancel(p_Calibration);
+                p_Calibration->State = (ECU_OK == calibration_build(p_Calibration)) ? CALIBRATION_DONE
+                                                                                     : CALIBRATION_FAILED;
+            }
+            else
+            {
+                calibration_apply_level(p_Calibration);
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function writes the curves to the parameter store and hands them to the motors
+ *
+ * @param p_Calibration object of calibration, in CALIBRATION_DONE
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t calibration_save(calibration_t *p_Calibration)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Calibration) || (CALIBRATION_DONE != p_Calibration->State))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        for (uint8_t l_Motor = ZERO; (l_Motor < p_Calibration->Count) && (ECU_OK == l_EcuStatus); l_Motor++)
+        {
+            const uint16_t *l_Points = p_Calibration->Curves[l_Motor].Compare;
+            for (uint32_t l_Word = ZERO; (l_Word < CALIBRATION_CURVE_WORDS) && (ECU_OK == l_EcuStatus); l_Word++)
+            {
+                uint32_t l_Point = 2U * l_Word;
+                uint32_t l_Value = l_Points[l_Point];
+                if ((l_Point + 1U) < MOTOR_CURVE_POINTS)
+                {
+                    l_Value |= ((uint32_t)l_Points[l_Point + 1U] << 16);
+                }
+                l_EcuStatus = param_set((param_key_t)(PARAM_MOTOR_CURVES + (l_Motor * CALIBRATION_CURVE_WORDS) +
+                                                      l_Word), l_Value);
+            }
+            p_Calibration->Motors[l_Motor]->Curve = &p_Calibration->Curves[l_Motor];
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function reads the stored curves at boot and hands them to the motors (param_init must run before)
+ *
+ * @param p_Motors motors, same order as during the calibration
+ * @param p_Curves storage of the curves, must outlive the motors
+ * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+ * @return ecu_status_t ECU_ERROR if no complete calibration is stored, the motors keep the linear mapping
+ */
+ecu_status_t calibration_load(motor_t *const *p_Motors, motor_curve_t *p_Curves, uint8_t p_Count)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Motors) || (NULL == p_Curves) || (ZERO == p_Count) || (p_Count > MOTOR_BANK_MAX_MOTORS))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // every word first, a motor only gets its curve when the whole set is stored
+        for (uint8_t l_Motor = ZERO; (l_Motor < p_Count) && (ECU_OK == l_EcuStatus); l_Motor++)
+        {
+            for (uint32_t l_Word = ZERO; (l_Word < CALIBRATION_CURVE_WORDS) && (ECU_OK == l_EcuStatus); l_Word++)
+            {
+                uint32_t l_Point = 2U * l_Word;
+                uint32_t l_Value = ZERO;
+                l_EcuStatus = param_get((param_key_t)(PARAM_MOTOR_CURVES + (l_Motor * CALIBRATION_CURVE_WORDS) +
+                                                      l_Word), &l_Value);
+                p_Curves[l_Motor].Compare[l_Point] = (uint16_t)l_Value;
+                if ((l_Point + 1U) < MOTOR_CURVE_POINTS)
+                {
+                    p_Curves[l_Motor].Compare[l_Point + 1U] = (uint16_t)(l_Value >> 16);
+                }
+            }
+        }
+        for (uint8_t l_Motor = ZERO; (l_Motor < p_Count) && (ECU_OK == l_EcuStatus); l_Motor++)
+        {
+            if (NULL == p_Motors[l_Motor])
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                p_Motors[l_Motor]->Curve = &p_Curves[l_Motor];
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief writes the duty of the current level to every motor
+ *
+ * @param p_Calibration object of calibration
+ */
+static void calibration_apply_level(calibration_t *p_Calibration)
+{
+    uint32_t l_Compare = motor_scale_compare(CALIBRATION_LEVEL_COMPARE(p_Calibration->Level));
+    for (uint8_t l_Motor = ZERO; l_Motor < p_Calibration->Count; l_Motor++)
+    {
+        __HAL_TIM_SetCompare(p_Calibration->Motors[l_Motor]->SelectedTimer,
+                             p_Calibration->Motors[l_Motor]->SelectedChannel, l_Compare);
+    }
+}
+
+/**
+ * @brief turns the sweep into curves: dead zone, full duty speed, then for every curve point the duty giving an
+ *        even fraction of the slowest motor's full speed (inverse linear interpolation of the sweep)
+ *
+ * @param p_Calibration object of calibration
+ * @return ecu_status_t ECU_ERROR if a motor never moved
+ */
+static ecu_status_t calibration_build(calibration_t *p_Calibration)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    float_t l_Common = 0.0f;
+
+    for (uint8_t l_Motor = ZERO; (l_Motor < p_Calibration->Count) && (ECU_OK == l_EcuStatus); l_Motor++)
+    {
+        float_t *l_Speeds = p_Calibration->Speeds[l_Motor];
+        // encoder noise can make the sweep dip, the curve must be monotonic to be inverted
+        for (uint32_t l_Level = 1U; l_Level <= CALIBRATION_DUTY_STEPS; l_Level++)
+        {
+            l_Speeds[l_Level] = (l_Speeds[l_Level] < l_Speeds[l_Level - 1U]) ? l_Speeds[l_Level - 1U]
+                                                                                : l_Speeds[l_Level];
+        }
+        p_Calibration->MaxSpeed[l_Motor] = l_Speeds[CALIBRATION_DUTY_STEPS];
+        if (p_Calibration->MaxSpeed[l_Motor] <= 0.0f)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else if ((ZERO == l_Motor) || (p_Calibration->MaxSpeed[l_Motor] < l_Common))
+        {
+            l_Common = p_Calibration->MaxSpeed[l_Motor];
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+
+    for (uint8_t l_Motor = ZERO; (l_Motor < p_Calibration->Count) && (ECU_OK == l_EcuStatus); l_Motor++)
+    {
+        const float_t *l_Speeds = p_Calibration->Speeds[l_Motor];
+        float_t l_Moving = p_Calibration->Config.MovingFraction * p_Calibration->MaxSpeed[l_Motor];
+        uint32_t l_Level = ZERO;
+        while ((l_Level < CALIBRATION_DUTY_STEPS) && (l_Speeds[l_Level + 1U] <= l_Moving))
+        {
+            l_Level++;
+        }
+        // l_Level is the last level where the motor stands still
+        p_Calibration->DeadZone[l_Motor] = (uint16_t)CALIBRATION_LEVEL_COMPARE(l_Level);
+        p_Calibration->Curves[l_Motor].Compare[0] = p_Calibration->DeadZone[l_Motor];
+
+        for (uint32_t l_Point = 1U; l_Point < MOTOR_CURVE_POINTS; l_Point++)
+        {
+            float_t l_Target = l_Common * (float_t)l_Point / (float_t)(MOTOR_CURVE_POINTS - 1);
+            while (((l_Level + 1U) < CALIBRATION_DUTY_STEPS) && (l_Speeds[l_Level + 1U] < l_Target))
+            {
+                l_Level++;
+            }
+            float_t l_Span = l_Speeds[l_Level + 1U] - l_Speeds[l_Level];
+            float_t l_Share = (l_Span > 0.0f) ? ((l_Target - l_Speeds[l_Level]) / l_Span) : 1.0f;
+            l_Share = (l_Share < 0.0f) ? 0.0f : ((l_Share > 1.0f) ? 1.0f : l_Share);
+            float_t l_Low = (float_t)CALIBRATION_LEVEL_COMPARE(l_Level);
+            float_t l_High = (float_t)CALIBRATION_LEVEL_COMPARE(l_Level + 1U);
+            p_Calibration->Curves[l_Motor].Compare[l_Point] = (uint16_t)(l_Low + (l_Share * (l_High - l_Low)) + 0.5f);
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,307 @@
+/**
+ * @file    console.c
+ * @author  Ahmed Hani
+ * @brief   non blocking text output behind printf (_write), a byte ring drained by UART TX DMA or ITM port 0
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/console.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define CONSOLE_MASK                (CONSOLE_RING_SIZE - 1U)
+#define CONSOLE_DRAIN_IDLE          (0U)
+#define CONSOLE_DRAIN_RUNNING       (1U)    // one context sends, the others only ask it for another pass
+#define CONSOLE_DRAIN_AGAIN         (2U)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+#if CONSOLE_OUTPUT != CONSOLE_OUTPUT_NONE
+static uint8_t console_drain_enter(void);
+static uint8_t console_drain_leave(void);
+static void console_send(void);
+#endif
+#if CONSOLE_OUTPUT == CONSOLE_OUTPUT_UART
+static void console_tx_done(void);
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+#if CONSOLE_OUTPUT != CONSOLE_OUTPUT_NONE
+/* free running indexes: Tail <= Head <= Reserved <= Tail + CONSOLE_RING_SIZE */
+static uint8_t ConsoleRing[CONSOLE_RING_SIZE] ECU_NOINIT;
+static volatile uint32_t ConsoleReserved = ZERO;    // end of the space claimed by writers
+static volatile uint32_t ConsoleHead = ZERO;        // end of the bytes ready to send
+static volatile uint32_t ConsoleTail = ZERO;        // first byte not sent yet
+static volatile uint32_t ConsoleWriters = ZERO;     // writers running, nested by preemption
+static volatile uint32_t ConsoleInFlight = ZERO;    // bytes handed to the UART DMA
+static volatile uint32_t ConsoleDrainState = CONSOLE_DRAIN_IDLE;
+#endif
+static volatile uint32_t ConsoleDropped = ZERO;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function queues text and starts draining it, callable from any context, never waits
+ *
+ * @param p_Data text to send
+ * @param p_Length number of bytes
+ * @return uint32_t bytes queued, the rest was dropped
+ */
+uint32_t console_write(const char *p_Data, uint32_t p_Length)
+{
+    uint32_t l_Count = ZERO;
+#if CONSOLE_OUTPUT != CONSOLE_OUTPUT_NONE
+    uint32_t l_Start = ZERO;
+    uint32_t l_Value = ZERO;
+    if (NULL == p_Data)
+    {
+        /* Nothing */
+    }
+    else
+    {
+        // a writer that preempts this one enters and leaves before it resumes, so the count is always balanced
+        ConsoleWriters++;
+
+        // claim the space, the store fails and retries if an interrupt claimed some in between
+        do
+        {
+            l_Start = __LDREXW(&ConsoleReserved);
+            l_Count = CONSOLE_RING_SIZE - (l_Start - ConsoleTail);
+            if (p_Length < l_Count)
+            {
+                l_Count = p_Length;
+            }
+            else
+            {
+                /* Nothing */
+            }
+        } while (__STREXW(l_Start + l_Count, &ConsoleReserved) != ZERO);
+
+        for (uint32_t l_Byte = ZERO; l_Byte < l_Count; l_Byte++)
+        {
+            ConsoleRing[(l_Start + l_Byte) & CONSOLE_MASK] = (uint8_t)p_Data[l_Byte];
+        }
+
+        if (l_Count < p_Length)
+        {
+            do
+            {
+                l_Value = __LDREXW(&ConsoleDropped) + (p_Length - l_Count);
+            } while (__STREXW(l_Value, &ConsoleDropped) != ZERO);
+        }
+        else
+        {
+            /* Nothing */
+        }
+
+        // the outermost writer publishes everything the nested ones reserved, all of it is written by now
+        if (ZERO == --ConsoleWriters)
+        {
+            __DMB();
+            do
+            {
+                (void)__LDREXW(&ConsoleHead);
+                l_Value = ConsoleReserved;
+            } while (__STREXW(l_Value, &ConsoleHead) != ZERO);
+            console_drain();
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+#else
+    (void)p_Data;
+    (void)p_Length;
+#endif
+    return l_Count;
+}
+
+/**
+ * @brief this function sends the next part of the ring if the output is free. it runs after every write and
+ *        every UART transfer, call it from the background loop too so output blocked by other UART users or by
+ *        a full ITM FIFO resumes
+ */
+void console_drain(void)
+{
+#if CONSOLE_OUTPUT != CONSOLE_OUTPUT_NONE
+    // a drain that finds another one running (preempted or preempting) leaves it a second pass and returns
+    if (console_drain_enter())
+    {
+        do
+        {
+            console_send();
+        } while (console_drain_leave());
+    }
+    else
+    {
+        /* Nothing */
+    }
+#endif
+}
+
+/**
+ * @brief this function tells how many bytes were dropped because the ring was full
+ *
+ * @return uint32_t dropped bytes since reset
+ */
+uint32_t console_get_dropped(void)
+{
+    return ConsoleDropped;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+#if CONSOLE_OUTPUT != CONSOLE_OUTPUT_NONE
+/**
+ * @brief claims the drain, or asks the context holding it for another pass
+ *
+ * @return uint8_t one if the caller holds the drain and must send
+ */
+static uint8_t console_drain_enter(void)
+{
+    uint32_t l_State = ZERO;
+    do
+    {
+        l_State = __LDREXW(&ConsoleDrainState);
+    } while (__STREXW((CONSOLE_DRAIN_IDLE == l_State) ? CONSOLE_DRAIN_RUNNING : CONSOLE_DRAIN_AGAIN,
+                      &ConsoleDrainState) != ZERO);
+    return (CONSOLE_DRAIN_IDLE == l_State);
+}
+
+/**
+ * @brief releases the drain unless a pass was asked for while sending
+ *
+ * @return uint8_t one if the caller still holds the drain and must send again
+ */
+static uint8_t console_drain_leave(void)
+{
+    uint32_t l_State = ZERO;
+    do
+    {
+        l_State = __LDREXW(&ConsoleDrainState);
+    } while (__STREXW((CONSOLE_DRAIN_AGAIN == l_State) ? CONSOLE_DRAIN_RUNNING : CONSOLE_DRAIN_IDLE,
+                      &ConsoleDrainState) != ZERO);
+    return (CONSOLE_DRAIN_AGAIN == l_State);
+}
+
+/**
+ * @brief one pass of the drain, only the context holding it runs here so the tail needs no lock
+ */
+static void console_send(void)
+{
+#if CONSOLE_OUTPUT == CONSOLE_OUTPUT_UART
+    uint32_t l_Tail = ConsoleTail;
+    uint32_t l_Pending = ConsoleHead - l_Tail;
+    if ((ZERO == ConsoleInFlight) && (ZERO != l_Pending))
+    {
+        uint32_t l_Offset = l_Tail & CONSOLE_MASK;
+        if (l_Pending > (CONSOLE_RING_SIZE - l_Offset))
+        {
+            l_Pending = CONSOLE_RING_SIZE - l_Offset;
+        }
+        else
+        {
+            /* Nothing */
+        }
+        // stored first: the completion can run before uart_transmit returns
+        ConsoleInFlight = l_Pending;
+        if (ECU_OK != uart_transmit(&ConsoleRing[l_Offset], (uint16_t)l_Pending, console_tx_done))
+        {
+            /* the link holds the UART, the next drain retries */
+            ConsoleInFlight = ZERO;
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+    else
+    {
+        /* Nothing */
+    }
+#else
+    if (((ITM->TCR & ITM_TCR_ITMENA_Msk) == ZERO) || ((ITM->TER & (1UL << CONSOLE_ITM_PORT)) == ZERO))
+    {
+        /* Nothing: no debugger listening, the ring fills and drops */
+    }
+    else
+    {
+        // bounded by CONSOLE_ITM_BURST, stops as soon as the stimulus FIFO is full
+        uint32_t l_Tail = ConsoleTail;
+        uint32_t l_End = l_Tail + CONSOLE_ITM_BURST;
+        while ((l_Tail != ConsoleHead) && (l_Tail != l_End) && (ZERO != ITM->PORT[CONSOLE_ITM_PORT].u32))
+        {
+            ITM->PORT[CONSOLE_ITM_PORT].u8 = ConsoleRing[l_Tail & CONSOLE_MASK];
+            l_Tail++;
+        }
+        ConsoleTail = l_Tail;
+    }
+#endif
+}
+#endif
+
+#if CONSOLE_OUTPUT == CONSOLE_OUTPUT_UART
+/**
+ * @brief the chunk on the wire is sent, frees it and sends what was written meanwhile
+ */
+static void console_tx_done(void)
+{
+    ConsoleTail += ConsoleInFlight;
+    ConsoleInFlight = ZERO;
+    console_drain();
+}
+#endif
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,228 @@
+/**
+ * @file    control.c
+ * @author  Ahmed Hani
+ * @brief   control tick: owns the mode machine and the motor command arbiter and feeds them from the link
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/control.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void control_on_command(const link_command_t *p_Command);
+static void control_post_faults(void);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static mode_machine_t ControlMode;
+static arbiter_t ControlArbiter;
+static volatile uint8_t ControlReady = ZERO;
+static uint32_t ControlTicks = ZERO;
+static uint8_t ControlWasBraking = ZERO;        // AEB state of the previous tick, OBSTACLE is posted on the rise
+static uint32_t ControlLinkExpired = ZERO;      // link commands expired up to the previous tick
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the mode machine (MANUAL) and the arbiter, then starts the link
+ *
+ * @param p_Vehicle drivetrain (can be NULL: the winner is only recorded)
+ * @param p_Parking parking assist cancelled when PARK is left (can be NULL)
+ * @param p_Aeb emergency brake whose brake is held while it brakes (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t control_init(vehicle_t *p_Vehicle, parking_t *p_Parking, const aeb_t *p_Aeb)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    ControlReady = ZERO;
+    if ((ECU_OK != mode_init(&ControlMode, p_Vehicle, p_Parking)) ||
+        (ECU_OK != arbiter_init(&ControlArbiter, p_Vehicle, p_Aeb)))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        ControlTicks = ZERO;
+        ControlWasBraking = ZERO;
+        ControlLinkExpired = ZERO;
+        ControlReady = 1;
+        l_EcuStatus = link_init(control_on_command);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function counts SysTick periods and runs the control tick every CONTROL_PERIOD_MS, call it from
+ *        SysTick_Handler
+ */
+void control_on_tick(void)
+{
+    if (ZERO == ControlReady)
+    {
+        /* Nothing */
+    }
+    else if (++ControlTicks >= CONTROL_PERIOD_MS)
+    {
+        ControlTicks = ZERO;
+        // the mode first, so a mode change takes the motors from the old owner on this very tick
+        (void)mode_step(&ControlMode);
+        (void)arbiter_tick(&ControlArbiter, mode_get_owner(&ControlMode));
+        // applied by the next mode_step, the AEB already holds the brake meanwhile
+        control_post_faults();
+    }
+    else
+    {
+        /* Nothing */
+    }
+}
+
+/**
+ * @brief this function gives the arbiter the producers submit to
+ *
+ * @return arbiter_t* arbiter of the control tick
+ */
+arbiter_t *control_get_arbiter(void)
+{
+    return &ControlArbiter;
+}
+
+/**
+ * @brief this function gives the mode machine, to post events (mode_post) or read the active mode
+ *
+ * @return mode_machine_t* mode machine of the control tick
+ */
+mode_machine_t *control_get_mode(void)
+{
+    return &ControlMode;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief receives the link commands (UART interrupt): drive commands go to the arbiter, mode requests to the mode
+ *        machine, both only queue and return
+ *
+ * @param p_Command decoded command
+ */
+static void control_on_command(const link_command_t *p_Command)
+{
+    switch (p_Command->Type)
+    {
+        case LINK_MSG_DRIVE:
+        {
+            arbiter_command_t l_Command = { p_Command->Speed, p_Command->YawRate };
+            (void)arbiter_submit(&ControlArbiter, MODE_OWNER_LINK, &l_Command, ARBITER_PRIORITY_DRIVER,
+                                 CONTROL_LINK_TTL_MS);
+            break;
+        }
+        case LINK_MSG_MODE:
+        {
+            // the companion can not fake an obstacle nor clear an emergency while the AEB still brakes
+            if ((p_Command->Mode >= MODE_EVENTS) || (MODE_EVENT_OBSTACLE == p_Command->Mode) ||
+                ((MODE_EVENT_CLEAR == p_Command->Mode) && (NULL != ControlArbiter.Aeb) &&
+                 aeb_is_braking(ControlArbiter.Aeb)))
+            {
+                /* Nothing */
+            }
+            else
+            {
+                (void)mode_post(&ControlMode, (mode_event_t)p_Command->Mode);
+            }
+            break;
+        }
+        default:
+        {
+            /* Nothing */
+            break;
+        }
+    }
+}
+
+/**
+ * @brief posts OBSTACLE when the AEB starts braking and LINK_LOST when a link command runs out of time while the
+ *        link owns the motors (MANUAL), both lead to EMERGENCY. called by the control tick after arbiter_tick
+ */
+static void control_post_faults(void)
+{
+    uint8_t l_Braking = (NULL != ControlArbiter.Aeb) && aeb_is_braking(ControlArbiter.Aeb);
+    uint32_t l_Expired = ControlArbiter.Expired[MODE_OWNER_LINK];
+
+    if (l_Braking && (ZERO == ControlWasBraking))
+    {
+        (void)mode_post(&ControlMode, MODE_EVENT_OBSTACLE);
+    }
+    else
+    {
+        /* Nothing */
+    }
+    ControlWasBraking = l_Braking;
+
+    // a drive command expires in the arbiter (submit or tick), the count is read here once per tick
+    if ((l_Expired != ControlLinkExpired) && (MODE_OWNER_LINK == mode_get_owner(&ControlMode)))
+    {
+        (void)mode_post(&ControlMode, MODE_EVENT_LINK_LOST);
+    }
+    else
+    {
+        /* Nothing */
+    }
+    ControlLinkExpired = l_Expired;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
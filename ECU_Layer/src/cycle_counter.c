@@ -0,0 +1,103 @@
+/**
+ * @file    cycle_counter.c
+ * @author  Ahmed Hani
+ * @brief   DWT cycle counter used to timestamp events and measure execution time / latency
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/cycle_counter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+
+
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function enables the DWT cycle counter, must be called once before any CYCLE_COUNTER_NOW()
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t cycle_counter_init(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    // already counting when boot_mark() started it, keep the origin of the boot profile
+    if (ZERO == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        DWT->CYCCNT = ZERO;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    // some parts need the debugger to unlock the DWT, report it instead of returning garbage timestamps
+    if (ZERO == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
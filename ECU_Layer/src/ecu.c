@@ -18,6 +18,8 @@
 /***********************************************************************************************************************
 *                                                    MACRO DEFINES                                                     *
 ***********************************************************************************************************************/
+#define ECU_MOTOR_DIRECTION_PINS    (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3 | \
+                                     GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7)
 
 
 
@@ -40,25 +42,55 @@
 /***********************************************************************************************************************
 *                                                     GLOBAL OBJECTS                                                   *
 ***********************************************************************************************************************/
-// motor_t MotorFrontLeft =
-// {
-
-// };
-
-// motor_t MotorFrontLeft =
-// {
-
-// };
-
-// motor_t MotorFrontLeft =
-// {
-
-// };
-
-// motor_t MotorFrontLeft =
-// {
-
-// };
+/* the two motors of a side share one channel of the pwm timer, TIM4 CH3 / CH4 (PB8 / PB9) carry I2C1 */
+motor_t MotorFrontLeft =
+{
+    .GpioxMotor = { GPIOC, GPIOC },
+    .GpioPinMotor = { GPIO_PIN_0, GPIO_PIN_1 },
+    .SelectedTimer = &htim4,
+    .SelectedChannel = TIM_CHANNEL_1,
+    .Curve = NULL,
+    .Lut = NULL,
+};
+
+motor_t MotorFrontRight =
+{
+    .GpioxMotor = { GPIOC, GPIOC },
+    .GpioPinMotor = { GPIO_PIN_2, GPIO_PIN_3 },
+    .SelectedTimer = &htim4,
+    .SelectedChannel = TIM_CHANNEL_2,
+    .Curve = NULL,
+    .Lut = NULL,
+};
+
+motor_t MotorRearLeft =
+{
+    .GpioxMotor = { GPIOC, GPIOC },
+    .GpioPinMotor = { GPIO_PIN_4, GPIO_PIN_5 },
+    .SelectedTimer = &htim4,
+    .SelectedChannel = TIM_CHANNEL_1,
+    .Curve = NULL,
+    .Lut = NULL,
+};
+
+motor_t MotorRearRight =
+{
+    .GpioxMotor = { GPIOC, GPIOC },
+    .GpioPinMotor = { GPIO_PIN_6, GPIO_PIN_7 },
+    .SelectedTimer = &htim4,
+    .SelectedChannel = TIM_CHANNEL_2,
+    .Curve = NULL,
+    .Lut = NULL,
+};
+
+/* same order as vehicle_wheel_t */
+motor_t *const EcuMotors[ECU_MOTORS] =
+{
+    &MotorFrontLeft,
+    &MotorFrontRight,
+    &MotorRearLeft,
+    &MotorRearRight,
+};
 
 
 
@@ -83,6 +115,46 @@
 *                                                  FUNCTION DECLARATION                                                *
 ***********************************************************************************************************************/
 
+/**
+ * @brief this function configures what CubeMX does not: the direction pins of the motors (PC0 .. PC7, low) and the
+ *        second pwm channel (TIM4 CH2 on PB7, same settings as CH1). MX_TIM4_Init must run before
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t ecu_init(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    GPIO_InitTypeDef l_GpioInit = {0};
+    TIM_OC_InitTypeDef l_OcInit = {0};
+
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    HAL_GPIO_WritePin(GPIOC, ECU_MOTOR_DIRECTION_PINS, GPIO_PIN_RESET);
+    l_GpioInit.Pin = ECU_MOTOR_DIRECTION_PINS;
+    l_GpioInit.Mode = GPIO_MODE_OUTPUT_PP;
+    l_GpioInit.Pull = GPIO_NOPULL;
+    l_GpioInit.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(GPIOC, &l_GpioInit);
+
+    l_OcInit.OCMode = TIM_OCMODE_PWM1;
+    l_OcInit.Pulse = 0;
+    l_OcInit.OCPolarity = TIM_OCPOLARITY_HIGH;
+    l_OcInit.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_PWM_ConfigChannel(&htim4, &l_OcInit, TIM_CHANNEL_2) != HAL_OK)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        __HAL_RCC_GPIOB_CLK_ENABLE();
+        l_GpioInit.Pin = GPIO_PIN_7;
+        l_GpioInit.Mode = GPIO_MODE_AF_PP;
+        l_GpioInit.Alternate = GPIO_AF2_TIM4;
+        HAL_GPIO_Init(GPIOB, &l_GpioInit);
+    }
+    return l_EcuStatus;
+}
+
+
 
 
 
@@ -0,0 +1,215 @@
+/**
+ * @file    fixed_math.c
+ * @author  Ahmed Hani
+ * @brief   table based fixed point helpers for the control loops (reciprocal instead of divide)
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/fixed_math.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define RECIPROCAL_TABLE_BITS   (8)         // denominator normalized to [256, 512]
+#define RECIPROCAL_TABLE_Q      (23)        // table entry = 2^23 / (256 + i)
+#define SINE_TABLE_BITS         (8)         // 256 steps per turn, interpolated with the next 16 bits
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static inline int32_t fixed_math_scaled_div(int32_t p_Num, uint32_t p_Den, int32_t p_NumShift);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static const uint16_t ReciprocalTable[(1 << RECIPROCAL_TABLE_BITS) + 1] =
+{
+    32768, 32640, 32514, 32388, 32264, 32140, 32018, 31896, 31775, 31655, 31536, 31418, 31301, 31184, 31069, 30954,
+    30840, 30728, 30615, 30504, 30394, 30284, 30175, 30067, 29959, 29853, 29747, 29642, 29537, 29434, 29331, 29229,
+    29127, 29026, 28926, 28827, 28728, 28630, 28533, 28436, 28340, 28244, 28150, 28056, 27962, 27869, 27777, 27685,
+    27594, 27504, 27414, 27324, 27236, 27148, 27060, 26973, 26887, 26801, 26715, 26631, 26546, 26462, 26379, 26297,
+    26214, 26133, 26052, 25971, 25891, 25811, 25732, 25653, 25575, 25497, 25420, 25343, 25267, 25191, 25116, 25041,
+    24966, 24892, 24818, 24745, 24672, 24600, 24528, 24457, 24385, 24315, 24245, 24175, 24105, 24036, 23967, 23899,
+    23831, 23764, 23697, 23630, 23564, 23498, 23432, 23367, 23302, 23237, 23173, 23109, 23046, 22982, 22920, 22857,
+    22795, 22733, 22672, 22611, 22550, 22490, 22429, 22370, 22310, 22251, 22192, 22134, 22075, 22017, 21960, 21902,
+    21845, 21789, 21732, 21676, 21620, 21565, 21509, 21454, 21400, 21345, 21291, 21237, 21183, 21130, 21077, 21024,
+    20972, 20919, 20867, 20815, 20764, 20713, 20662, 20611, 20560, 20510, 20460, 20410, 20361, 20311, 20262, 20214,
+    20165, 20117, 20068, 20021, 19973, 19925, 19878, 19831, 19784, 19738, 19692, 19645, 19600, 19554, 19508, 19463,
+    19418, 19373, 19329, 19284, 19240, 19196, 19152, 19108, 19065, 19022, 18979, 18936, 18893, 18851, 18809, 18766,
+    18725, 18683, 18641, 18600, 18559, 18518, 18477, 18437, 18396, 18356, 18316, 18276, 18236, 18197, 18157, 18118,
+    18079, 18040, 18001, 17963, 17924, 17886, 17848, 17810, 17772, 17735, 17697, 17660, 17623, 17586, 17549, 17513,
+    17476, 17440, 17404, 17368, 17332, 17296, 17261, 17225, 17190, 17155, 17120, 17085, 17050, 17015, 16981, 16947,
+    16913, 16878, 16845, 16811, 16777, 16744, 16710, 16677, 16644, 16611, 16578, 16546, 16513, 16481, 16448, 16416,
+    16384
+};
+
+static const q16_t SineTable[(1 << SINE_TABLE_BITS) + 1] =
+{
+         0,   1608,   3216,   4821,   6424,   8022,   9616,  11204,  12785,  14359,  15924,  17479,
+     19024,  20557,  22078,  23586,  25080,  26558,  28020,  29466,  30893,  32303,  33692,  35062,
+     36410,  37736,  39040,  40320,  41576,  42806,  44011,  45190,  46341,  47464,  48559,  49624,
+     50660,  51665,  52639,  53581,  54491,  55368,  56212,  57022,  57798,  58538,  59244,  59914,
+     60547,  61145,  61705,  62228,  62714,  63162,  63572,  63944,  64277,  64571,  64827,  65043,
+     65220,  65358,  65457,  65516,  65536,  65516,  65457,  65358,  65220,  65043,  64827,  64571,
+     64277,  63944,  63572,  63162,  62714,  62228,  61705,  61145,  60547,  59914,  59244,  58538,
+     57798,  57022,  56212,  55368,  54491,  53581,  52639,  51665,  50660,  49624,  48559,  47464,
+     46341,  45190,  44011,  42806,  41576,  40320,  39040,  37736,  36410,  35062,  33692,  32303,
+     30893,  29466,  28020,  26558,  25080,  23586,  22078,  20557,  19024,  17479,  15924,  14359,
+     12785,  11204,   9616,   8022,   6424,   4821,   3216,   1608,      0,  -1608,  -3216,  -4821,
+     -6424,  -8022,  -9616, -11204, -12785, -14359, -15924, -17479, -19024, -20557, -22078, -23586,
+    -25080, -26558, -28020, -29466, -30893, -32303, -33692, -35062, -36410, -37736, -39040, -40320,
+    -41576, -42806, -44011, -45190, -46341, -47464, -48559, -49624, -50660, -51665, -52639, -53581,
+    -54491, -55368, -56212, -57022, -57798, -58538, -59244, -59914, -60547, -61145, -61705, -62228,
+    -62714, -63162, -63572, -63944, -64277, -64571, -64827, -65043, -65220, -65358, -65457, -65516,
+    -65536, -65516, -65457, -65358, -65220, -65043, -64827, -64571, -64277, -63944, -63572, -63162,
+    -62714, -62228, -61705, -61145, -60547, -59914, -59244, -58538, -57798, -57022, -56212, -55368,
+    -54491, -53581, -52639, -51665, -50660, -49624, -48559, -47464, -46341, -45190, -44011, -42806,
+    -41576, -40320, -39040, -37736, -36410, -35062, -33692, -32303, -30893, -29466, -28020, -26558,
+    -25080, -23586, -22078, -20557, -19024, -17479, -15924, -14359, -12785, -11204,  -9616,  -8022,
+     -6424,  -4821,  -3216,  -1608,      0
+};
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function divides two integers through the reciprocal table, constant time
+ *
+ * @param p_Num numerator
+ * @param p_Den denominator (> 0)
+ * @return int32_t p_Num / p_Den, saturated if p_Den is zero
+ */
+int32_t fixed_math_div(int32_t p_Num, uint32_t p_Den)
+{
+    return fixed_math_scaled_div(p_Num, p_Den, ZERO);
+}
+
+/**
+ * @brief this function divides two Q16 numbers through the reciprocal table, constant time
+ *
+ * @param p_Num numerator (Q16)
+ * @param p_Den denominator (Q16, > 0)
+ * @return q16_t p_Num / p_Den (Q16), saturated if p_Den is zero
+ */
+q16_t fixed_math_div_q16(q16_t p_Num, q16_t p_Den)
+{
+    q16_t l_Result = ZERO;
+    if (p_Den <= ZERO)
+    {
+        l_Result = (p_Num < ZERO) ? INT32_MIN : INT32_MAX;
+    }
+    else
+    {
+        l_Result = fixed_math_scaled_div(p_Num, (uint32_t)p_Den, Q16_SHIFT);
+    }
+    return l_Result;
+}
+
+
+
+
+/**
+ * @brief this function returns the sine of a binary angle from a 256 entry table with linear interpolation
+ *
+ * @param p_Angle binary angle (2^32 = one turn)
+ * @return q16_t sine (Q16)
+ */
+q16_t fixed_math_sin(uint32_t p_Angle)
+{
+    uint32_t l_Index = p_Angle >> (32 - SINE_TABLE_BITS);
+    int32_t l_Fraction = (int32_t)((p_Angle >> (16 - SINE_TABLE_BITS)) & 0xFFFFUL);
+    q16_t l_Low = SineTable[l_Index];
+    return l_Low + (((SineTable[l_Index + 1] - l_Low) * l_Fraction) >> 16);
+}
+
+/**
+ * @brief this function returns the cosine of a binary angle from a 256 entry table with linear interpolation
+ *
+ * @param p_Angle binary angle (2^32 = one turn)
+ * @return q16_t cosine (Q16)
+ */
+q16_t fixed_math_cos(uint32_t p_Angle)
+{
+    return fixed_math_sin(p_Angle + FIXED_MATH_BAM_QUARTER_TURN);
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief (p_Num * 2^p_NumShift) / p_Den, the denominator is normalized with CLZ to 9 significant bits and
+ *        replaced by its reciprocal from the table, so the cost never depends on the operands
+ *
+ * @param p_Num numerator
+ * @param p_Den denominator
+ * @param p_NumShift extra scaling of the numerator
+ * @return int32_t quotient, saturated to int32
+ */
+static inline int32_t fixed_math_scaled_div(int32_t p_Num, uint32_t p_Den, int32_t p_NumShift)
+{
+    int32_t l_Result = ZERO;
+    if (ZERO == p_Den)
+    {
+        l_Result = (p_Num < ZERO) ? INT32_MIN : INT32_MAX;
+    }
+    else
+    {
+        int32_t l_Shift = (31 - __builtin_clz(p_Den)) - RECIPROCAL_TABLE_BITS;
+        uint32_t l_Normalized = (l_Shift > ZERO) ? ((p_Den + (1UL << (l_Shift - 1))) >> l_Shift)
+                                                 : (p_Den << -l_Shift);
+        int64_t l_Product = (int64_t)p_Num * ReciprocalTable[l_Normalized - (1UL << RECIPROCAL_TABLE_BITS)];
+        int32_t l_Total = RECIPROCAL_TABLE_Q + l_Shift - p_NumShift;
+        l_Product = (l_Total >= ZERO) ? (l_Product >> l_Total) : (l_Product << -l_Total);
+
+        l_Result = (l_Product > INT32_MAX) ? INT32_MAX : ((l_Product < INT32_MIN) ? INT32_MIN : (int32_t)l_Product);
+    }
+    return l_Result;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,392 @@
+/**
+ * @file    fsm.c
+ * @author  Ahmed Hani
+ * @brief   table driven hierarchical state machine with an event queue
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/fsm.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define FSM_NO_STATE                (0xFFU)
+#define FSM_MAX_STATES              (254U)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* table entries back to state numbers, FSM_NONE gives FSM_NO_STATE */
+#define FSM_STATE_OF(entry)         ((uint8_t)((entry) - 1U))
+#define FSM_PARENT(table, state)    FSM_STATE_OF((table)->States[(state)].Parent)
+#define FSM_ENTRY(table, state, event) \
+    ((table)->Transitions[((uint32_t)(state) * (table)->EventCount) + (event)])
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static ecu_status_t fsm_check_table(const fsm_table_t *p_Table);
+static void fsm_transition(fsm_t *p_Fsm, uint8_t p_Target);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function checks the table and enters its initial state (and the initial children below it)
+ *
+ * @param p_Fsm object of the machine
+ * @param p_Table machine description
+ * @param p_Context argument given to every action
+ * @return ecu_status_t ECU_ERROR if a parent, an initial child or a target is out of range or the nesting is deeper
+ *         than FSM_MAX_DEPTH
+ */
+ecu_status_t fsm_init(fsm_t *p_Fsm, const fsm_table_t *p_Table, void *p_Context)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if ((NULL == p_Fsm) || (ECU_OK != fsm_check_table(p_Table)))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Fsm->Table = p_Table;
+        p_Fsm->Context = p_Context;
+        p_Fsm->Current = FSM_NO_STATE;
+        p_Fsm->Head = ZERO;
+        p_Fsm->Tail = ZERO;
+        p_Fsm->Dropped = ZERO;
+        p_Fsm->WorstDispatchCycles = ZERO;
+
+        // nothing active yet: every ancestor of the initial state is entered from the top
+        fsm_transition(p_Fsm, p_Table->Initial);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function queues an event, safe from any handler
+ *
+ * @param p_Fsm object of the machine
+ * @param p_Event event number
+ * @return ecu_status_t ECU_ERROR for an unknown event or a full queue
+ */
+ecu_status_t fsm_post(fsm_t *p_Fsm, uint8_t p_Event)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if ((NULL == p_Fsm) || (NULL == p_Fsm->Table) || (p_Event >= p_Fsm->Table->EventCount))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_Primask = __get_PRIMASK();
+
+        // several producers (link, AEB, sensors) may post from different priorities
+        __disable_irq();
+        if ((uint8_t)(p_Fsm->Tail - p_Fsm->Head) >= FSM_QUEUE_SIZE)
+        {
+            p_Fsm->Dropped++;
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            p_Fsm->Queue[p_Fsm->Tail & (FSM_QUEUE_SIZE - 1U)] = p_Event;
+            p_Fsm->Tail++;
+        }
+        __set_PRIMASK(l_Primask);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function handles up to FSM_DISPATCH_BUDGET queued events, called from the control tick (one context)
+ *
+ * @param p_Fsm object of the machine
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t fsm_dispatch(fsm_t *p_Fsm)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if ((NULL == p_Fsm) || (NULL == p_Fsm->Table))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_StartCycles = CYCLE_COUNTER_NOW();
+        const fsm_table_t *l_Table = p_Fsm->Table;
+        uint8_t l_Budget = FSM_DISPATCH_BUDGET;
+
+        while ((ZERO != l_Budget) && (p_Fsm->Head != p_Fsm->Tail))
+        {
+            uint8_t l_Event = p_Fsm->Queue[p_Fsm->Head & (FSM_QUEUE_SIZE - 1U)];
+            uint8_t l_State = p_Fsm->Current;
+            uint8_t l_Entry = FSM_NONE;
+
+            p_Fsm->Head++;
+            l_Budget--;
+
+            // the innermost state handling the event wins, at most one lookup per level
+            for (uint8_t l_Level = ZERO; (l_Level < FSM_MAX_DEPTH) && (FSM_NO_STATE != l_State) &&
+                                         (FSM_NONE == l_Entry); l_Level++)
+            {
+                l_Entry = FSM_ENTRY(l_Table, l_State, l_Event);
+                l_State = FSM_PARENT(l_Table, l_State);
+            }
+
+            if ((FSM_NONE != l_Entry) && (FSM_IGNORE != l_Entry))
+            {
+                fsm_transition(p_Fsm, FSM_STATE_OF(l_Entry));
+            }
+            else
+            {
+                /* Nothing */
+            }
+        }
+
+        l_StartCycles = CYCLE_COUNTER_ELAPSED(l_StartCycles);
+        if (l_StartCycles > p_Fsm->WorstDispatchCycles)
+        {
+            p_Fsm->WorstDispatchCycles = l_StartCycles;
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function tells the active leaf state
+ *
+ * @param p_Fsm object of the machine
+ * @return uint8_t state number
+ */
+uint8_t fsm_get_state(const fsm_t *p_Fsm)
+{
+    return p_Fsm->Current;
+}
+
+/**
+ * @brief this function tells if a state is the active leaf or one of its ancestors
+ *
+ * @param p_Fsm object of the machine
+ * @param p_State state number
+ * @return uint8_t nonzero if the state is active
+ */
+uint8_t fsm_in_state(const fsm_t *p_Fsm, uint8_t p_State)
+{
+    uint8_t l_Active = ZERO;
+    uint8_t l_State = p_Fsm->Current;
+
+    for (uint8_t l_Level = ZERO; (l_Level < FSM_MAX_DEPTH) && (FSM_NO_STATE != l_State); l_Level++)
+    {
+        if (l_State == p_State)
+        {
+            l_Active = 1U;
+        }
+        l_State = FSM_PARENT(p_Fsm->Table, l_State);
+    }
+    return l_Active;
+}
+
+/**
+ * @brief this function tells the owner value of the active leaf state
+ *
+ * @param p_Fsm object of the machine
+ * @return uint8_t Owner of the state
+ */
+uint8_t fsm_get_owner(const fsm_t *p_Fsm)
+{
+    return p_Fsm->Table->States[p_Fsm->Current].Owner;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief checks every reference of a table and the nesting depth, run once so dispatch needs no check
+ *
+ * @param p_Table machine description
+ * @return ecu_status_t ECU_ERROR on the first wrong entry
+ */
+static ecu_status_t fsm_check_table(const fsm_table_t *p_Table)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if ((NULL == p_Table) || (NULL == p_Table->States) || (NULL == p_Table->Transitions) ||
+        (ZERO == p_Table->StateCount) || (p_Table->StateCount > FSM_MAX_STATES) ||
+        (p_Table->Initial >= p_Table->StateCount))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // every index first: the chain walk below reads the parents of states not visited yet
+        for (uint8_t l_Index = ZERO; (l_Index < p_Table->StateCount) && (ECU_OK == l_EcuStatus); l_Index++)
+        {
+            const fsm_state_t *l_State = &p_Table->States[l_Index];
+
+            if ((l_State->Parent > p_Table->StateCount) || (l_State->Initial > p_Table->StateCount))
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                for (uint8_t l_Event = ZERO; l_Event < p_Table->EventCount; l_Event++)
+                {
+                    uint8_t l_Entry = FSM_ENTRY(p_Table, l_Index, l_Event);
+
+                    if ((FSM_IGNORE != l_Entry) && (l_Entry > p_Table->StateCount))
+                    {
+                        l_EcuStatus = ECU_ERROR;
+                    }
+                }
+            }
+        }
+
+        for (uint8_t l_Index = ZERO; (l_Index < p_Table->StateCount) && (ECU_OK == l_EcuStatus); l_Index++)
+        {
+            const fsm_state_t *l_State = &p_Table->States[l_Index];
+            uint8_t l_Child = FSM_STATE_OF(l_State->Initial);
+            uint8_t l_Ancestor = l_Index;
+            uint8_t l_Depth = ZERO;
+
+            // a loop in the parents also ends here
+            while ((FSM_NO_STATE != l_Ancestor) && (l_Depth <= FSM_MAX_DEPTH))
+            {
+                l_Ancestor = FSM_PARENT(p_Table, l_Ancestor);
+                l_Depth++;
+            }
+            if ((l_Depth > FSM_MAX_DEPTH) ||
+                ((FSM_NONE != l_State->Initial) && (FSM_PARENT(p_Table, l_Child) != l_Index)))
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                /* Nothing */
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief leaves the active states up to the lowest common ancestor with the target (the target itself is left and
+ *        entered again when it is active), enters down to the target then its initial children
+ *
+ * @param p_Fsm object of the machine
+ * @param p_Target state to reach
+ */
+static void fsm_transition(fsm_t *p_Fsm, uint8_t p_Target)
+{
+    const fsm_table_t *l_Table = p_Fsm->Table;
+    uint8_t l_Path[FSM_MAX_DEPTH];
+    uint8_t l_Count = ZERO;
+    uint8_t l_Common = ZERO;
+    uint8_t l_State = p_Target;
+
+    // target and its ancestors, innermost first
+    while ((FSM_NO_STATE != l_State) && (l_Count < FSM_MAX_DEPTH))
+    {
+        l_Path[l_Count++] = l_State;
+        l_State = FSM_PARENT(l_Table, l_State);
+    }
+
+    // exit from the leaf until a strict ancestor of the target is reached
+    l_Common = l_Count;
+    l_State = p_Fsm->Current;
+    while (FSM_NO_STATE != l_State)
+    {
+        uint8_t l_Index = 1U;
+
+        while ((l_Index < l_Count) && (l_Path[l_Index] != l_State))
+        {
+            l_Index++;
+        }
+        if (l_Index < l_Count)
+        {
+            l_Common = l_Index;
+            break;
+        }
+
+        if (NULL != l_Table->States[l_State].Exit)
+        {
+            l_Table->States[l_State].Exit(p_Fsm->Context);
+        }
+        l_State = FSM_PARENT(l_Table, l_State);
+    }
+
+    // enter below the common ancestor down to the target
+    while (l_Common > ZERO)
+    {
+        l_Common--;
+        l_State = l_Path[l_Common];
+        if (NULL != l_Table->States[l_State].Entry)
+        {
+            l_Table->States[l_State].Entry(p_Fsm->Context);
+        }
+    }
+
+    // a composite target goes on to its initial leaf
+    l_State = p_Target;
+    while (FSM_NONE != l_Table->States[l_State].Initial)
+    {
+        l_State = FSM_STATE_OF(l_Table->States[l_State].Initial);
+        if (NULL != l_Table->States[l_State].Entry)
+        {
+            l_Table->States[l_State].Entry(p_Fsm->Context);
+        }
+    }
+
+    p_Fsm->Current = l_State;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,318 @@
+/**
+ * @file    idle.c
+ * @author  Ahmed Hani
+ * @brief   idle policy: the main loop sleeps (WFI, Sleep mode) when it has nothing to run, with wake up latency and
+ *          sleep residency measurement
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/idle.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define IDLE_PERMILLE               (1000U)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define IDLE_TICK_PENDING()         (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static uint64_t idle_now_us(void);
+static uint64_t idle_to_us(uint32_t p_Ms, uint32_t p_Value);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static idle_stats_t IdleStats;
+static uint64_t IdleStartUs;
+
+static volatile uint8_t IdleTickWake = ZERO;    // the SysTick woke the core, its handler measures the latency
+static volatile uint8_t IdleSleepOnExit = ZERO;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function starts the measurement (HAL_Init must run before)
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_init(void)
+{
+    // Sleep mode, not STOP (power_enter_stop), and WFI returns to the caller
+    SCB->SCR &= ~(SCB_SCR_SLEEPDEEP_Msk | SCB_SCR_SLEEPONEXIT_Msk);
+    IdleSleepOnExit = ZERO;
+    return idle_reset_stats();
+}
+
+/**
+ * @brief this function sleeps until the next interrupt unless work is ready, the handler that woke the core has run
+ *        when it returns. with sleep on exit enabled it does not return: everything then runs in handlers
+ *
+ * @param p_Ready work ready check, NULL to sleep anyway
+ * @return ecu_status_t ECU_ERROR if work was ready and the core did not sleep
+ */
+ecu_status_t idle_enter(idle_ready_t p_Ready)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Primask = __get_PRIMASK();
+    uint64_t l_AsleepUs = ZERO;
+    uint32_t l_WakeMs = ZERO;
+    uint32_t l_WakeValue = ZERO;
+
+    // masked: a handler making work ready after the check still wakes the WFI, it runs once PRIMASK is restored
+    __disable_irq();
+    if ((NULL != p_Ready) && (ZERO != p_Ready()))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        l_AsleepUs = idle_now_us();
+
+        __DSB();
+        __WFI();
+
+        // only the raw SysTick snapshot before the waking handler runs, it clears the pending tick
+        l_WakeValue = SysTick->VAL;
+        l_WakeMs = uwTick;
+        IdleTickWake = IDLE_TICK_PENDING() ? 1U : ZERO;
+        if (ZERO != IdleTickWake)
+        {
+            l_WakeValue = SysTick->VAL;
+            l_WakeMs += (uint32_t)uwTickFreq;
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+    __set_PRIMASK(l_Primask);
+
+    if (ECU_OK == l_EcuStatus)
+    {
+        IdleStats.SleepUs += idle_to_us(l_WakeMs, l_WakeValue) - l_AsleepUs;
+        IdleStats.Wakeups++;
+    }
+    else
+    {
+        /* Nothing */
+    }
+
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function enables or disables sleep on exit: the core goes back to sleep at the end of the last handler
+ *        instead of returning to the main loop, for purely interrupt driven configurations
+ *
+ * @param p_Enable nonzero to enable
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_set_sleep_on_exit(uint8_t p_Enable)
+{
+    // the main loop never runs again, every tick is taken from sleep and measured
+    IdleSleepOnExit = (ZERO != p_Enable) ? 1U : ZERO;
+    if (IdleSleepOnExit)
+    {
+        SCB->SCR |= SCB_SCR_SLEEPONEXIT_Msk;
+    }
+    else
+    {
+        SCB->SCR &= ~SCB_SCR_SLEEPONEXIT_Msk;
+    }
+    return ECU_OK;
+}
+
+/**
+ * @brief this function measures the wake up latency, called first in SysTick_Handler
+ */
+void idle_on_tick(void)
+{
+    if (IdleTickWake || IdleSleepOnExit)
+    {
+        // SysTick counts HCLK down from LOAD, the event was its reload
+        uint32_t l_Cycles = SysTick->LOAD - SysTick->VAL;
+
+        IdleTickWake = ZERO;
+        IdleStats.LastWakeCycles = l_Cycles;
+        if (l_Cycles > IdleStats.WorstWakeCycles)
+        {
+            IdleStats.WorstWakeCycles = l_Cycles;
+        }
+        if (l_Cycles > IDLE_WAKE_BOUND_CYCLES)
+        {
+            IdleStats.WakeViolations++;
+        }
+    }
+}
+
+/**
+ * @brief this function copies the statistics and computes the residency and the current estimate
+ *
+ * @param p_Stats destination
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_get_stats(idle_stats_t *p_Stats)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if (NULL == p_Stats)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_Primask = __get_PRIMASK();
+        uint32_t l_RunUa = IDLE_RUN_CURRENT_UA;
+        uint32_t l_SleepUa = IDLE_SLEEP_CURRENT_UA;
+
+        __disable_irq();
+        *p_Stats = IdleStats;
+        p_Stats->TotalUs = idle_now_us() - IdleStartUs;
+        __set_PRIMASK(l_Primask);
+
+        if (POWER_PROFILE_PARKED == power_get_profile())
+        {
+            l_RunUa = IDLE_PARKED_RUN_CURRENT_UA;
+            l_SleepUa = IDLE_PARKED_SLEEP_CURRENT_UA;
+        }
+        else
+        {
+            /* Nothing */
+        }
+
+        if (ZERO != p_Stats->TotalUs)
+        {
+            p_Stats->ResidencyPermille = (uint32_t)((p_Stats->SleepUs * IDLE_PERMILLE) / p_Stats->TotalUs);
+        }
+        else
+        {
+            p_Stats->ResidencyPermille = ZERO;
+        }
+        p_Stats->CurrentUa = ((l_RunUa * (IDLE_PERMILLE - p_Stats->ResidencyPermille)) +
+                              (l_SleepUa * p_Stats->ResidencyPermille)) / IDLE_PERMILLE;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function clears the statistics
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t idle_reset_stats(void)
+{
+    uint32_t l_Primask = __get_PRIMASK();
+
+    __disable_irq();
+    memset(&IdleStats, ZERO, sizeof(IdleStats));
+    IdleStartUs = idle_now_us();
+    __set_PRIMASK(l_Primask);
+
+    return ECU_OK;
+}
+
+/**
+ * @brief HAL_Delay sleeping between the ticks instead of spinning (overrides the weak HAL version), same minimum wait
+ *
+ * @param Delay delay in milliseconds
+ */
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t l_Start = HAL_GetTick();
+    uint32_t l_Wait = Delay;
+
+    if (l_Wait < HAL_MAX_DELAY)
+    {
+        l_Wait += (uint32_t)uwTickFreq;
+    }
+
+    while ((HAL_GetTick() - l_Start) < l_Wait)
+    {
+        (void)idle_enter(NULL);
+    }
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief time from the SysTick in microseconds, it keeps counting in Sleep mode and follows the profile changes.
+ *        called with the interrupts masked: a reload not counted by HAL_IncTick yet is added here
+ *
+ * @return uint64_t microseconds since HAL_Init
+ */
+static uint64_t idle_now_us(void)
+{
+    uint32_t l_Value = SysTick->VAL;
+    uint32_t l_Ms = uwTick;
+
+    if (IDLE_TICK_PENDING())
+    {
+        // the reload happened before or right after the first read, the second read is after it
+        l_Value = SysTick->VAL;
+        l_Ms += (uint32_t)uwTickFreq;
+    }
+
+    return idle_to_us(l_Ms, l_Value);
+}
+
+/**
+ * @brief this function converts a SysTick snapshot to microseconds since HAL_Init
+ *
+ * @param p_Ms uwTick, plus one tick if the reload was pending
+ * @param p_Value SysTick->VAL read with it
+ * @return uint64_t microseconds
+ */
+static uint64_t idle_to_us(uint32_t p_Ms, uint32_t p_Value)
+{
+    return ((uint64_t)p_Ms * 1000U) + ((SysTick->LOAD - p_Value) / (SystemCoreClock / 1000000U));
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
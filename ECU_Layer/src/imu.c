@@ -0,0 +1,694 @@
+/**
+ * @file    imu.c
+ * @author  Ahmed Hani
+ * @brief   MPU-6050 class IMU read through its FIFO in DMA bursts on I2C1, paced by the data ready EXTI
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/imu.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+/* registers of the sensor */
+#define IMU_REG_SMPLRT_DIV          (0x19)
+#define IMU_REG_CONFIG              (0x1A)
+#define IMU_REG_GYRO_CONFIG         (0x1B)
+#define IMU_REG_ACCEL_CONFIG        (0x1C)
+#define IMU_REG_FIFO_EN             (0x23)
+#define IMU_REG_INT_PIN_CFG         (0x37)
+#define IMU_REG_INT_ENABLE          (0x38)
+#define IMU_REG_USER_CTRL           (0x6A)
+#define IMU_REG_PWR_MGMT_1          (0x6B)
+#define IMU_REG_FIFO_R_W            (0x74)
+
+#define IMU_PWR_RESET               (0x80)
+#define IMU_PWR_CLOCK_PLL_GYRO_X    (0x01)
+#define IMU_CONFIG_DLPF_188HZ       (0x01)
+#define IMU_GYRO_500DPS             (0x08)
+#define IMU_ACCEL_4G                (0x08)
+#define IMU_FIFO_GYRO_ACCEL         (0x78)
+#define IMU_INT_ACTIVE_HIGH_PULSE   (0x00)
+#define IMU_INT_DATA_READY          (0x01)
+#define IMU_USER_FIFO_ENABLE        (0x40)
+#define IMU_USER_FIFO_RESET         (0x44)      // keeps the FIFO enabled while flushing it
+
+#define IMU_RESET_TIME_MS           (100)
+#define IMU_TRANSFER_TIMEOUT_MS     (5)
+#define IMU_FRAME_BYTES             (12)        // accel x y z then gyro x y z, big endian (FIFO follows register order)
+#define IMU_TIMESTAMP_SLOTS         (16)        // data ready edges remembered, more unread samples is an overrun
+#define IMU_I2C_ERRORS              (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR | I2C_SR1_TIMEOUT)
+
+/* Q24 of one LSB in SI units, (raw * scale) >> 8 gives Q16 without overflowing 32 bits */
+#define IMU_GYRO_SCALE              ((int32_t)(((3.14159265f / 180.0f) / 65.5f) * 16777216.0f + 0.5f))
+#define IMU_ACCEL_SCALE             ((int32_t)((9.80665f / 8192.0f) * 16777216.0f + 0.5f))
+
+#if (IMU_TIMESTAMP_SLOTS & (IMU_TIMESTAMP_SLOTS - 1)) != 0
+#error "IMU_TIMESTAMP_SLOTS must be a power of two"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define IMU_BE16(p)                 ((int32_t)(int16_t)(((uint16_t)(p)[0] << 8) | (uint16_t)(p)[1]))
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief what a transfer is for, decides what happens when it completes
+ */
+typedef enum
+{
+    IMU_TRANSFER_REGISTER = 0,
+    IMU_TRANSFER_FIFO,
+    IMU_TRANSFER_FIFO_RESET,
+}imu_transfer_kind_t;
+
+/**
+ * @brief state of the transfer on the bus
+ * @param Busy set from the start condition until the payload is done
+ * @param Failed set by the error interrupt, cleared by the next transfer
+ * @param Read one for register read (repeated start), zero for a single register write
+ * @param Receiving set once the repeated start of a read was requested
+ * @param ValueSent set once the value of a write was put in DR
+ * @param Kind see imu_transfer_kind_t
+ * @param Register first register of the transfer
+ * @param Value value of a write
+ */
+typedef struct
+{
+    volatile uint8_t Busy;
+    volatile uint8_t Failed;
+    uint8_t Read;
+    uint8_t Receiving;
+    uint8_t ValueSent;
+    imu_transfer_kind_t Kind;
+    uint8_t Register;
+    uint8_t Value;
+}imu_transfer_t;
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void imu_start_write(uint8_t p_Register, uint8_t p_Value, imu_transfer_kind_t p_Kind);
+static void imu_start_read(uint8_t p_Register, uint8_t *p_Destination, uint16_t p_Length, imu_transfer_kind_t p_Kind);
+static ecu_status_t imu_wait_bus(void);
+static ecu_status_t imu_write_register(uint8_t p_Register, uint8_t p_Value);
+static ecu_status_t imu_read_registers(uint8_t p_Register, uint8_t *p_Destination, uint16_t p_Length);
+static void imu_schedule(void);
+static void imu_transfer_done(void);
+static void imu_bus_fault(void);
+static void imu_convert_burst(void);
+static void imu_data_ready(void);
+static void imu_dma_complete(DMA_HandleTypeDef *p_Dma);
+static void imu_dma_error(DMA_HandleTypeDef *p_Dma);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+DMA_HandleTypeDef hdma_i2c1_rx;
+EXTI_HandleTypeDef hexti_imu;
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static uint8_t ImuBurst[IMU_SAMPLES_PER_BURST * IMU_FRAME_BYTES] __attribute__((aligned(4))) ECU_NOINIT;
+static imu_transfer_t ImuTransfer;
+
+/* every data ready edge is timestamped, the n-th sample read from the FIFO belongs to the n-th edge */
+static volatile uint32_t ImuEdgeTimestamps[IMU_TIMESTAMP_SLOTS];
+static volatile uint32_t ImuEdges = ZERO;
+static volatile uint32_t ImuSamplesRead = ZERO;
+static volatile uint8_t ImuStreaming = ZERO;
+static volatile uint8_t ImuResetPending = ZERO;
+
+/* single producer (DMA interrupt), single consumer (imu_read) */
+static imu_sample_t ImuRing[IMU_RING_SIZE];
+static volatile uint32_t ImuRingHead = ZERO;
+static volatile uint32_t ImuRingTail = ZERO;
+static imu_stats_t ImuStats;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures I2C1, DMA1 stream 0 and the sensor then starts streaming,
+ *        blocks for about 100 ms while the sensor resets
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t imu_init(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    GPIO_InitTypeDef l_GpioInit = {0};
+    EXTI_ConfigTypeDef l_ExtiConfig = {0};
+    uint32_t l_Pclk1 = HAL_RCC_GetPCLK1Freq();
+    uint32_t l_Pclk1Mhz = l_Pclk1 / 1000000UL;
+    uint8_t l_Readback[2] = {0};
+
+    (void)cycle_counter_init();
+    ImuStreaming = ZERO;
+    ImuResetPending = ZERO;
+    ImuEdges = ZERO;
+    ImuSamplesRead = ZERO;
+    ImuRingHead = ZERO;
+    ImuRingTail = ZERO;
+    memset(&ImuTransfer, ZERO, sizeof(imu_transfer_t));
+    memset(&ImuStats, ZERO, sizeof(imu_stats_t));
+
+    /* pins, PB8 SCL / PB9 SDA open drain, PB5 data ready input */
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    l_GpioInit.Pin = GPIO_PIN_8 | GPIO_PIN_9;
+    l_GpioInit.Mode = GPIO_MODE_AF_OD;
+    l_GpioInit.Pull = GPIO_PULLUP;
+    l_GpioInit.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    l_GpioInit.Alternate = GPIO_AF4_I2C1;
+    HAL_GPIO_Init(GPIOB, &l_GpioInit);
+    l_GpioInit.Pin = GPIO_PIN_5;
+    l_GpioInit.Mode = GPIO_MODE_INPUT;
+    l_GpioInit.Pull = GPIO_NOPULL;
+    l_GpioInit.Alternate = ZERO;
+    HAL_GPIO_Init(GPIOB, &l_GpioInit);
+
+    /* I2C1 fast mode, duty 2:1 so CCR = PCLK1 / (3 * speed), error interrupt always on */
+    __HAL_RCC_I2C1_CLK_ENABLE();
+    __HAL_RCC_I2C1_FORCE_RESET();
+    __HAL_RCC_I2C1_RELEASE_RESET();
+    I2C1->CR2 = (l_Pclk1Mhz << I2C_CR2_FREQ_Pos) | I2C_CR2_ITERREN;
+    I2C1->CCR = I2C_CCR_FS | (l_Pclk1 / (3UL * IMU_I2C_SPEED));
+    I2C1->TRISE = ((l_Pclk1Mhz * 300UL) / 1000UL) + 1UL;
+    I2C1->CR1 = I2C_CR1_PE;
+
+    /* DMA1 stream 0 channel 1, one normal transfer per burst */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    hdma_i2c1_rx.Instance = DMA1_Stream0;
+    hdma_i2c1_rx.Init.Channel = DMA_CHANNEL_1;
+    hdma_i2c1_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_i2c1_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_i2c1_rx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_i2c1_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_i2c1_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_i2c1_rx.Init.Mode = DMA_NORMAL;
+    hdma_i2c1_rx.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_i2c1_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_i2c1_rx) != HAL_OK)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        hdma_i2c1_rx.XferCpltCallback = imu_dma_complete;
+        hdma_i2c1_rx.XferErrorCallback = imu_dma_error;
+        HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, IMU_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
+        HAL_NVIC_SetPriority(I2C1_EV_IRQn, IMU_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+        HAL_NVIC_SetPriority(I2C1_ER_IRQn, IMU_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+
+        /* sensor, the reset bit gives no acknowledge of its own so the clock source is read back instead */
+        l_EcuStatus = imu_write_register(IMU_REG_PWR_MGMT_1, IMU_PWR_RESET);
+        HAL_Delay(IMU_RESET_TIME_MS);
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_PWR_MGMT_1, IMU_PWR_CLOCK_PLL_GYRO_X);
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_read_registers(IMU_REG_PWR_MGMT_1, l_Readback, sizeof(l_Readback));
+        }
+        if ((ECU_OK == l_EcuStatus) && (IMU_PWR_CLOCK_PLL_GYRO_X != l_Readback[0]))
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_SMPLRT_DIV, IMU_SAMPLE_RATE_DIVIDER);
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_CONFIG, IMU_CONFIG_DLPF_188HZ);
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_GYRO_CONFIG, IMU_GYRO_500DPS);
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_ACCEL_CONFIG, IMU_ACCEL_4G);
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_FIFO_EN, IMU_FIFO_GYRO_ACCEL);
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_INT_PIN_CFG, IMU_INT_ACTIVE_HIGH_PULSE);
+        }
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = imu_write_register(IMU_REG_USER_CTRL, IMU_USER_FIFO_ENABLE);
+        }
+    }
+
+    if (ECU_OK == l_EcuStatus)
+    {
+        /* data ready edge on EXTI line 5 */
+        __HAL_RCC_SYSCFG_CLK_ENABLE();
+        l_ExtiConfig.Line = EXTI_LINE_5;
+        l_ExtiConfig.Mode = EXTI_MODE_INTERRUPT;
+        l_ExtiConfig.Trigger = EXTI_TRIGGER_RISING;
+        l_ExtiConfig.GPIOSel = EXTI_GPIOB;
+        if ((HAL_EXTI_SetConfigLine(&hexti_imu, &l_ExtiConfig) != HAL_OK) ||
+            (HAL_EXTI_RegisterCallback(&hexti_imu, HAL_EXTI_COMMON_CB_ID, imu_data_ready) != HAL_OK))
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            HAL_NVIC_SetPriority(EXTI9_5_IRQn, IMU_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+            l_EcuStatus = imu_write_register(IMU_REG_INT_ENABLE, IMU_INT_DATA_READY);
+        }
+    }
+
+    if (ECU_OK == l_EcuStatus)
+    {
+        // the FIFO filled without edges being counted, the first transfer of the stream flushes it
+        ImuResetPending = 1;
+        ImuStreaming = 1;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function takes the oldest sample out of the ring, single reader
+ *
+ * @param p_Sample destination of the sample
+ * @return ecu_status_t ECU_OK if a sample was copied, ECU_ERROR if the ring is empty
+ */
+ecu_status_t imu_read(imu_sample_t *p_Sample)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Tail = ImuRingTail;
+    if ((NULL == p_Sample) || (l_Tail == ImuRingHead))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        __DMB();
+        *p_Sample = ImuRing[l_Tail & (IMU_RING_SIZE - 1)];
+        __DMB();
+        ImuRingTail = l_Tail + 1U;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function copies the acquisition counters
+ *
+ * @param p_Stats destination of the counters
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t imu_get_stats(imu_stats_t *p_Stats)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Stats)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        *p_Stats = ImuStats;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief I2C1 event interrupt, drives the address phase of every transfer
+ */
+void imu_i2c_event_irq(void)
+{
+    uint32_t l_Status = I2C1->SR1;
+    if (l_Status & I2C_SR1_SB)
+    {
+        if (ImuTransfer.Receiving)
+        {
+            // the DMA is armed before the address so no byte can be missed, LAST makes the final byte a NACK
+            I2C1->CR2 |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+            I2C1->DR = (IMU_I2C_ADDRESS << 1) | 1U;
+        }
+        else
+        {
+            I2C1->DR = (IMU_I2C_ADDRESS << 1);
+        }
+    }
+    else if (l_Status & I2C_SR1_ADDR)
+    {
+        if (ImuTransfer.Receiving)
+        {
+            // from here the DMA moves the payload, no more events until the next transfer
+            I2C1->CR2 &= ~I2C_CR2_ITEVTEN;
+            (void)I2C1->SR2;
+        }
+        else
+        {
+            (void)I2C1->SR2;
+            I2C1->DR = ImuTransfer.Register;
+        }
+    }
+    else if (l_Status & I2C_SR1_BTF)
+    {
+        if (ImuTransfer.Read)
+        {
+            // BTF stays set until the repeated start goes out, only request it once
+            if (ZERO == ImuTransfer.Receiving)
+            {
+                ImuTransfer.Receiving = 1;
+                I2C1->CR1 |= I2C_CR1_START;
+            }
+        }
+        else if (ZERO == ImuTransfer.ValueSent)
+        {
+            ImuTransfer.ValueSent = 1;
+            I2C1->DR = ImuTransfer.Value;
+        }
+        else
+        {
+            I2C1->CR2 &= ~I2C_CR2_ITEVTEN;
+            I2C1->CR1 |= I2C_CR1_STOP;
+            imu_transfer_done();
+        }
+    }
+    else
+    {
+        /* Nothing */
+    }
+}
+
+/**
+ * @brief I2C1 error interrupt, aborts the transfer and schedules a FIFO reset
+ */
+void imu_i2c_error_irq(void)
+{
+    I2C1->SR1 &= ~IMU_I2C_ERRORS;
+    imu_bus_fault();
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief starts a single register write, the rest runs from the event interrupt
+ *
+ * @param p_Register register to write
+ * @param p_Value value to write
+ * @param p_Kind purpose of the transfer
+ */
+static void imu_start_write(uint8_t p_Register, uint8_t p_Value, imu_transfer_kind_t p_Kind)
+{
+    ImuTransfer.Busy = 1;
+    ImuTransfer.Failed = ZERO;
+    ImuTransfer.Read = ZERO;
+    ImuTransfer.Receiving = ZERO;
+    ImuTransfer.ValueSent = ZERO;
+    ImuTransfer.Kind = p_Kind;
+    ImuTransfer.Register = p_Register;
+    ImuTransfer.Value = p_Value;
+    I2C1->CR2 |= I2C_CR2_ITEVTEN;
+    I2C1->CR1 |= I2C_CR1_START;
+}
+
+/**
+ * @brief starts a burst read, the address phase runs from the event interrupt and the payload from the DMA
+ *
+ * @param p_Register first register to read (the FIFO port does not auto increment)
+ * @param p_Destination destination of the payload
+ * @param p_Length bytes to read, at least two (LAST needs it)
+ * @param p_Kind purpose of the transfer
+ */
+static void imu_start_read(uint8_t p_Register, uint8_t *p_Destination, uint16_t p_Length, imu_transfer_kind_t p_Kind)
+{
+    ImuTransfer.Busy = 1;
+    ImuTransfer.Failed = ZERO;
+    ImuTransfer.Read = 1;
+    ImuTransfer.Receiving = ZERO;
+    ImuTransfer.Kind = p_Kind;
+    ImuTransfer.Register = p_Register;
+    if (HAL_DMA_Start_IT(&hdma_i2c1_rx, (uint32_t)&I2C1->DR, (uint32_t)p_Destination, p_Length) != HAL_OK)
+    {
+        imu_bus_fault();
+    }
+    else
+    {
+        I2C1->CR1 |= I2C_CR1_ACK;
+        I2C1->CR2 |= I2C_CR2_ITEVTEN;
+        I2C1->CR1 |= I2C_CR1_START;
+    }
+}
+
+/**
+ * @brief waits for the stop condition of the previous transfer to be sent, used before streaming only
+ *
+ * @return ecu_status_t ECU_ERROR on timeout
+ */
+static ecu_status_t imu_wait_bus(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Start = HAL_GetTick();
+    while ((I2C1->CR1 & I2C_CR1_STOP) && ((HAL_GetTick() - l_Start) < IMU_TRANSFER_TIMEOUT_MS))
+    {
+        /* Nothing */
+    }
+    if (I2C1->CR1 & I2C_CR1_STOP)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief blocking register write through the interrupt path, used before streaming only
+ *
+ * @param p_Register register to write
+ * @param p_Value value to write
+ * @return ecu_status_t status of the operation
+ */
+static ecu_status_t imu_write_register(uint8_t p_Register, uint8_t p_Value)
+{
+    ecu_status_t l_EcuStatus = imu_wait_bus();
+    if (ECU_OK == l_EcuStatus)
+    {
+        uint32_t l_Start = HAL_GetTick();
+        imu_start_write(p_Register, p_Value, IMU_TRANSFER_REGISTER);
+        while (ImuTransfer.Busy && ((HAL_GetTick() - l_Start) < IMU_TRANSFER_TIMEOUT_MS))
+        {
+            /* Nothing */
+        }
+        if (ImuTransfer.Busy || ImuTransfer.Failed)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief blocking register read through the interrupt and DMA path, used before streaming only
+ *
+ * @param p_Register first register to read
+ * @param p_Destination destination of the registers
+ * @param p_Length registers to read, at least two
+ * @return ecu_status_t status of the operation
+ */
+static ecu_status_t imu_read_registers(uint8_t p_Register, uint8_t *p_Destination, uint16_t p_Length)
+{
+    ecu_status_t l_EcuStatus = imu_wait_bus();
+    if (ECU_OK == l_EcuStatus)
+    {
+        uint32_t l_Start = HAL_GetTick();
+        imu_start_read(p_Register, p_Destination, p_Length, IMU_TRANSFER_REGISTER);
+        while (ImuTransfer.Busy && ((HAL_GetTick() - l_Start) < IMU_TRANSFER_TIMEOUT_MS))
+        {
+            /* Nothing */
+        }
+        if (ImuTransfer.Busy || ImuTransfer.Failed)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief starts the next streaming transfer if the bus is free, called from the IMU interrupts only
+ */
+static void imu_schedule(void)
+{
+    // a start requested while the previous stop is still pending is not reliable, the next edge retries
+    if (ImuStreaming && (ZERO == ImuTransfer.Busy) && (ZERO == (I2C1->CR1 & (I2C_CR1_STOP | I2C_CR1_START))))
+    {
+        if (ImuResetPending)
+        {
+            imu_start_write(IMU_REG_USER_CTRL, IMU_USER_FIFO_RESET, IMU_TRANSFER_FIFO_RESET);
+        }
+        else if ((ImuEdges - ImuSamplesRead) >= IMU_SAMPLES_PER_BURST)
+        {
+            imu_start_read(IMU_REG_FIFO_R_W, ImuBurst, sizeof(ImuBurst), IMU_TRANSFER_FIFO);
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+}
+
+/**
+ * @brief ends the current transfer and chains the next one
+ */
+static void imu_transfer_done(void)
+{
+    if (IMU_TRANSFER_FIFO_RESET == ImuTransfer.Kind)
+    {
+        // the FIFO is empty as of now, samples of the edges counted so far are gone
+        ImuSamplesRead = ImuEdges;
+        ImuResetPending = ZERO;
+    }
+    ImuTransfer.Busy = ZERO;
+    imu_schedule();
+}
+
+/**
+ * @brief aborts the current transfer, the FIFO position is unknown afterwards so it gets flushed
+ */
+static void imu_bus_fault(void)
+{
+    I2C1->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+    I2C1->CR1 |= I2C_CR1_STOP;
+    (void)HAL_DMA_Abort(&hdma_i2c1_rx);
+    ImuStats.BusErrors++;
+    ImuResetPending = 1;
+    ImuTransfer.Failed = 1;
+    ImuTransfer.Busy = ZERO;
+}
+
+/**
+ * @brief converts the burst in place of the DMA buffer straight into the ring, integer only
+ */
+static void imu_convert_burst(void)
+{
+    uint32_t l_StartCycles = CYCLE_COUNTER_NOW();
+    uint32_t l_Head = ImuRingHead;
+    uint32_t l_Edge = ImuSamplesRead;
+
+    for (uint8_t l_Sample = ZERO; l_Sample < IMU_SAMPLES_PER_BURST; l_Sample++)
+    {
+        const uint8_t *l_Frame = &ImuBurst[l_Sample * IMU_FRAME_BYTES];
+        if ((l_Head - ImuRingTail) >= IMU_RING_SIZE)
+        {
+            ImuStats.Dropped++;
+        }
+        else
+        {
+            imu_sample_t *l_Out = &ImuRing[l_Head & (IMU_RING_SIZE - 1)];
+            for (uint8_t l_Axis = ZERO; l_Axis < 3; l_Axis++)
+            {
+                l_Out->Accel[l_Axis] = (IMU_BE16(&l_Frame[2 * l_Axis]) * IMU_ACCEL_SCALE) >> 8;
+                l_Out->Gyro[l_Axis] = (IMU_BE16(&l_Frame[6 + (2 * l_Axis)]) * IMU_GYRO_SCALE) >> 8;
+            }
+            l_Out->Timestamp = ImuEdgeTimestamps[(l_Edge + l_Sample) & (IMU_TIMESTAMP_SLOTS - 1)];
+            l_Head++;
+        }
+    }
+    __DMB();
+    ImuRingHead = l_Head;
+    ImuSamplesRead = l_Edge + IMU_SAMPLES_PER_BURST;
+
+    uint32_t l_Cycles = CYCLE_COUNTER_ELAPSED(l_StartCycles);
+    if (l_Cycles > ImuStats.WorstCycles)
+    {
+        ImuStats.WorstCycles = l_Cycles;
+    }
+}
+
+/**
+ * @brief data ready edge, timestamps the sample and starts a burst once enough are waiting in the FIFO
+ */
+static void imu_data_ready(void)
+{
+    ImuEdgeTimestamps[ImuEdges & (IMU_TIMESTAMP_SLOTS - 1)] = CYCLE_COUNTER_NOW();
+    ImuEdges++;
+    if ((ImuEdges - ImuSamplesRead) > IMU_TIMESTAMP_SLOTS)
+    {
+        // the bus fell behind, the timestamps of the oldest samples are already overwritten
+        if (ZERO == ImuResetPending)
+        {
+            ImuStats.BusErrors++;
+            ImuResetPending = 1;
+        }
+    }
+    imu_schedule();
+}
+
+/**
+ * @brief the DMA received the whole payload, the last byte was already NACKed
+ *
+ * @param p_Dma DMA handle
+ */
+static void imu_dma_complete(DMA_HandleTypeDef *p_Dma)
+{
+    (void)p_Dma;
+    I2C1->CR1 |= I2C_CR1_STOP;
+    I2C1->CR2 &= ~(I2C_CR2_DMAEN | I2C_CR2_LAST);
+    if ((IMU_TRANSFER_FIFO == ImuTransfer.Kind) && (ZERO == ImuResetPending))
+    {
+        imu_convert_burst();
+    }
+    imu_transfer_done();
+}
+
+/**
+ * @brief the DMA reported a transfer error
+ *
+ * @param p_Dma DMA handle
+ */
+static void imu_dma_error(DMA_HandleTypeDef *p_Dma)
+{
+    (void)p_Dma;
+    imu_bus_fault();
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
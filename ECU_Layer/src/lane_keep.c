@@ -0,0 +1,227 @@
+/**
+ * @file    lane_keep.c
+ * @author  Ahmed Hani
+ * @brief   lane keeping steering from the line sensor centroid (pure pursuit on offset and heading)
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/lane_keep.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define LANE_KEEP_MIN_STEP_DISTANCE (Q16_ONE / 10000)   // 0.1 mm, shorter steps keep the last heading
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the lane keeping, it starts disengaged (zero speed)
+ *
+ * @param p_LaneKeep object of lane keeping
+ * @param p_Config tuning of the lane keeping
+ * @param p_Arbiter arbiter receiving the twist
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t lane_keep_init(lane_keep_t *p_LaneKeep, const lane_keep_config_t *p_Config, arbiter_t *p_Arbiter)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_LaneKeep) || (NULL == p_Config) || (NULL == p_Arbiter) ||
+        (p_Config->LookAhead <= 0.0f) || (ZERO == p_Config->FramesPerStep))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_LaneKeep, ZERO, sizeof(lane_keep_t));
+        p_LaneKeep->Arbiter = p_Arbiter;
+
+        /* pure pursuit: the look ahead point is offset + L * heading, curvature = 2 * that / L^2 */
+        p_LaneKeep->SensorPitch = Q16_FROM_FLOAT(p_Config->SensorPitch);
+        p_LaneKeep->OffsetGain = Q16_FROM_FLOAT(2.0f / (p_Config->LookAhead * p_Config->LookAhead));
+        p_LaneKeep->HeadingGain = Q16_FROM_FLOAT(2.0f / p_Config->LookAhead);
+        p_LaneKeep->MaxCurvature = Q16_FROM_FLOAT(p_Config->MaxCurvature);
+        p_LaneKeep->HeadingFilter = Q16_FROM_FLOAT(p_Config->HeadingFilter);
+        p_LaneKeep->StepPeriod = Q16_FROM_FLOAT(p_Config->StepPeriod);
+        p_LaneKeep->FramesPerStep = p_Config->FramesPerStep;
+        p_LaneKeep->MaxLostSteps = p_Config->MaxLostSteps;
+
+        l_EcuStatus = cycle_counter_init();
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function sets the forward speed, zero disengages the lane keeping
+ *
+ * @param p_LaneKeep object of lane keeping
+ * @param p_Speed forward speed in m/s
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t lane_keep_set_speed(lane_keep_t *p_LaneKeep, float_t p_Speed)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_LaneKeep) || (p_Speed < 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_LaneKeep->Speed = Q16_FROM_FLOAT(p_Speed);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function consumes one line sensor frame and runs the steering law every FramesPerStep frames
+ *
+ * @param p_LaneKeep object of lane keeping
+ * @param p_Frame frame given by the line sensor callback
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t lane_keep_on_frame(lane_keep_t *p_LaneKeep, const line_sensor_frame_t *p_Frame)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_LaneKeep) || (NULL == p_Frame))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_LaneKeep->FrameCount++;
+        if ((p_LaneKeep->FrameCount >= p_LaneKeep->FramesPerStep) && (p_LaneKeep->Speed > ZERO))
+        {
+            q16_t l_Speed = p_LaneKeep->Speed;
+            p_LaneKeep->FrameCount = ZERO;
+
+            if (p_Frame->LineFound)
+            {
+                // position is in 1/256 of the sensor pitch
+                q16_t l_Offset = (p_Frame->Position * p_LaneKeep->SensorPitch) >> 8;
+
+                /* heading = d(offset) / d(distance), the distance of one step comes from the speed command. a
+                   crawling car rounds it to zero or a few LSB, the division would saturate: the heading is kept */
+                q16_t l_Distance = Q16_MUL(l_Speed, p_LaneKeep->StepPeriod);
+                if ((ZERO == p_LaneKeep->LostSteps) && (l_Distance >= LANE_KEEP_MIN_STEP_DISTANCE))
+                {
+                    q16_t l_Heading = fixed_math_div_q16(l_Offset - p_LaneKeep->Offset, l_Distance);
+                    p_LaneKeep->Heading += Q16_MUL(p_LaneKeep->HeadingFilter, l_Heading - p_LaneKeep->Heading);
+                }
+                p_LaneKeep->Offset = l_Offset;
+                p_LaneKeep->LostSteps = ZERO;
+
+                q16_t l_Curvature = Q16_MUL(p_LaneKeep->OffsetGain, l_Offset) +
+                                    Q16_MUL(p_LaneKeep->HeadingGain, p_LaneKeep->Heading);
+                if (l_Curvature > p_LaneKeep->MaxCurvature)
+                {
+                    l_Curvature = p_LaneKeep->MaxCurvature;
+                }
+                else if (l_Curvature < -p_LaneKeep->MaxCurvature)
+                {
+                    l_Curvature = -p_LaneKeep->MaxCurvature;
+                }
+                else
+                {
+                    /* inside the limits */
+                }
+                p_LaneKeep->Curvature = l_Curvature;
+            }
+            else if (p_LaneKeep->LostSteps < p_LaneKeep->MaxLostSteps)
+            {
+                // keep the last curvature for a short gap in the line
+                p_LaneKeep->LostSteps++;
+            }
+            else
+            {
+                l_Speed = ZERO;
+            }
+
+            if (motor_is_brake_latched())
+            {
+                /* the AEB holds the brake: the law keeps its state, nothing is submitted until the brake is released */
+                p_LaneKeep->BrakeHeldSteps++;
+            }
+            else if (ZERO == l_Speed)
+            {
+                // line lost for too long: withdrawn, the arbiter brakes
+                l_EcuStatus = arbiter_release(p_LaneKeep->Arbiter, MODE_OWNER_LANE_KEEP);
+            }
+            else
+            {
+                /* yaw rate = v * curvature, a right turn is a negative (clockwise) yaw rate */
+                q16_t l_YawRate = Q16_MUL(p_LaneKeep->Curvature, l_Speed);
+                arbiter_command_t l_Command = { Q16_TO_FLOAT(l_Speed), -Q16_TO_FLOAT(l_YawRate) };
+                l_EcuStatus = arbiter_submit(p_LaneKeep->Arbiter, MODE_OWNER_LANE_KEEP, &l_Command,
+                                             ARBITER_PRIORITY_ASSIST, LANE_KEEP_COMMAND_TTL_MS);
+            }
+
+            // taken after the submit: it includes the choice of the arbiter and the compare register write
+            uint32_t l_Latency = CYCLE_COUNTER_ELAPSED(p_Frame->Timestamp);
+            if (l_Latency > p_LaneKeep->WorstLatencyCycles)
+            {
+                p_LaneKeep->WorstLatencyCycles = l_Latency;
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,375 @@
+/**
+ * @file    line_sensor.c
+ * @author  Ahmed Hani
+ * @brief   IR reflectance line sensor array sampled by ADC1 in scan mode with circular double buffered DMA
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/line_sensor.h"
+#include "../inc/ecu.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define LINE_SENSOR_ADC_MAX             (4095)
+#define LINE_SENSOR_MIN_CONTRAST        (64)        // raw counts between surface and line needed to calibrate
+#define LINE_SENSOR_SAMPLE_TIME         (3)         // SMPx = 011 -> 56 ADC cycles
+#define LINE_SENSOR_CONVERSION_CYCLES   (56 + 12)   // sampling + 12 bit conversion, ADC cycles per channel
+#define LINE_SENSOR_TICKS_PER_ADC_CYCLE (4)         // 84 MHz TIM4 / 21 MHz ADC in the drive profile, see below
+#define LINE_SENSOR_SCAN_TICKS          (LINE_SENSOR_CHANNELS * LINE_SENSOR_CONVERSION_CYCLES * \
+                                         LINE_SENSOR_TICKS_PER_ADC_CYCLE)
+#define LINE_SENSOR_EXTSEL_TIM4_CC4     (9)         // EXTSEL = 1001
+#define LINE_SENSOR_TIM4_OC_PWM2        (7)
+#define LINE_SENSOR_HALF_SAMPLES        (LINE_SENSOR_SCANS_PER_FRAME * LINE_SENSOR_CHANNELS)
+
+/* 8 channels take 2176 ticks (26 us) of the 4200 tick period: started mid-period the scan would cross the update.
+   checked in drive profile ticks: PARKED halves the TIM4 clock and power_set_profile halves ARR and CCR4 with it,
+   the ADC stays at 21 MHz, so the trigger and the scan keep their place in microseconds */
+#if ((LINE_SENSOR_TRIGGER_DELAY + LINE_SENSOR_SCAN_TICKS + LINE_SENSOR_GUARD_TICKS) > TIMER_AUTO_RELOAD_VAL)
+#error "the line sensor scan does not end before the next PWM update, lower LINE_SENSOR_TRIGGER_DELAY"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* position of sensor i in 1/256 of the pitch from the array center */
+#define LINE_SENSOR_WEIGHT(i)           ((int32_t)((2 * (i)) - (LINE_SENSOR_CHANNELS - 1)) * 128)
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void line_sensor_process(const uint16_t *p_Samples);
+static void line_sensor_half_complete(DMA_HandleTypeDef *p_Dma);
+static void line_sensor_complete(DMA_HandleTypeDef *p_Dma);
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief one sensor of the array
+ * @param AdcChannel ADC1 input number
+ * @param GpioPort port of the pin
+ * @param GpioPin pin number
+ */
+typedef struct
+{
+    uint8_t AdcChannel;
+    GPIO_TypeDef *GpioPort;
+    uint16_t GpioPin;
+}line_sensor_channel_t;
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+DMA_HandleTypeDef hdma_adc1;
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+/* PA2 / PA3 are left free for the USART */
+static const line_sensor_channel_t LineSensorChannels[8] =
+{
+    {0, GPIOA, GPIO_PIN_0},
+    {1, GPIOA, GPIO_PIN_1},
+    {4, GPIOA, GPIO_PIN_4},
+    {5, GPIOA, GPIO_PIN_5},
+    {6, GPIOA, GPIO_PIN_6},
+    {7, GPIOA, GPIO_PIN_7},
+    {8, GPIOB, GPIO_PIN_0},
+    {9, GPIOB, GPIO_PIN_1},
+};
+
+/* DMA target, first half is processed while the second one fills and the other way around */
+static uint16_t LineSensorSamples[2 * LINE_SENSOR_HALF_SAMPLES] __attribute__((aligned(4))) ECU_NOINIT;
+
+static int32_t LineSensorSurface[LINE_SENSOR_CHANNELS];     // surface level summed over one frame
+static int32_t LineSensorGain[LINE_SENSOR_CHANNELS];        // Q16 factor to 0 .. 255
+
+static line_sensor_frame_t LineSensorFrames[2];
+static volatile uint8_t LineSensorLatest = ZERO;
+static line_sensor_callback_t LineSensorCallback = NULL;
+static volatile uint32_t LineSensorWorstCycles = ZERO;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures the pins, ADC1, TIM4 channel 4 and DMA2 stream 0 then starts sampling,
+ *        TIM4 must already run (MX_TIM4_Init)
+ *
+ * @param p_Callback called with every frame from the DMA interrupt (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t line_sensor_init(line_sensor_callback_t p_Callback)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    GPIO_InitTypeDef l_GpioInit = {0};
+    uint16_t l_Surface[LINE_SENSOR_CHANNELS];
+    uint16_t l_Line[LINE_SENSOR_CHANNELS];
+
+    LineSensorCallback = p_Callback;
+    (void)cycle_counter_init();
+
+    /* until calibrated the full ADC range maps to 0 .. 255 */
+    for (uint8_t l_Index = ZERO; l_Index < LINE_SENSOR_CHANNELS; l_Index++)
+    {
+        l_Surface[l_Index] = ZERO;
+        l_Line[l_Index] = LINE_SENSOR_ADC_MAX;
+    }
+    (void)line_sensor_calibrate(l_Surface, l_Line);
+
+    /* pins */
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    l_GpioInit.Mode = GPIO_MODE_ANALOG;
+    l_GpioInit.Pull = GPIO_NOPULL;
+    for (uint8_t l_Index = ZERO; l_Index < LINE_SENSOR_CHANNELS; l_Index++)
+    {
+        l_GpioInit.Pin = LineSensorChannels[l_Index].GpioPin;
+        HAL_GPIO_Init(LineSensorChannels[l_Index].GpioPort, &l_GpioInit);
+    }
+
+    /* ADC1: 12 bit scan of all channels per trigger, DMA requests kept on for circular mode */
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    ADC->CCR = (ADC->CCR & ~ADC_CCR_ADCPRE_Msk) | ADC_CCR_ADCPRE_0;        // PCLK2 / 4 = 21 MHz
+    ADC1->CR1 = ADC_CR1_SCAN;
+    ADC1->SMPR1 = ZERO;
+    ADC1->SMPR2 = ZERO;
+    ADC1->SQR1 = (uint32_t)(LINE_SENSOR_CHANNELS - 1) << ADC_SQR1_L_Pos;
+    ADC1->SQR2 = ZERO;
+    ADC1->SQR3 = ZERO;
+    for (uint8_t l_Index = ZERO; l_Index < LINE_SENSOR_CHANNELS; l_Index++)
+    {
+        uint32_t l_Channel = LineSensorChannels[l_Index].AdcChannel;
+        ADC1->SMPR2 |= (uint32_t)LINE_SENSOR_SAMPLE_TIME << (3U * l_Channel);       // channels 0 .. 9 only
+        if (l_Index < 6)
+        {
+            ADC1->SQR3 |= l_Channel << (5U * l_Index);
+        }
+        else
+        {
+            ADC1->SQR2 |= l_Channel << (5U * (l_Index - 6U));
+        }
+    }
+    ADC1->CR2 = ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_EXTEN_0 |
+                ((uint32_t)LINE_SENSOR_EXTSEL_TIM4_CC4 << ADC_CR2_EXTSEL_Pos) | ADC_CR2_ADON;
+
+    /* DMA2 stream 0 channel 0, circular over both halves */
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    hdma_adc1.Instance = DMA2_Stream0;
+    hdma_adc1.Init.Channel = DMA_CHANNEL_0;
+    hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_adc1.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_adc1.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_adc1.Init.Mode = DMA_CIRCULAR;
+    hdma_adc1.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_adc1.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_adc1) != HAL_OK)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        hdma_adc1.XferHalfCpltCallback = line_sensor_half_complete;
+        hdma_adc1.XferCpltCallback = line_sensor_complete;
+        HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, LINE_SENSOR_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+        if (HAL_DMA_Start_IT(&hdma_adc1, (uint32_t)&ADC1->DR, (uint32_t)LineSensorSamples,
+                             2 * LINE_SENSOR_HALF_SAMPLES) != HAL_OK)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+    }
+
+    /* TIM4 OC4REF rises LINE_SENSOR_TRIGGER_DELAY ticks after every update (PWM2), the ADC starts on that edge.
+       CC4E only enables the trigger, PB9 stays on I2C1 (AF4) and never sees the channel */
+    TIM4->CCR4 = LINE_SENSOR_TRIGGER_DELAY;
+    TIM4->CCMR2 = (TIM4->CCMR2 & ~(TIM_CCMR2_CC4S | TIM_CCMR2_OC4M)) |
+                  ((uint32_t)LINE_SENSOR_TIM4_OC_PWM2 << TIM_CCMR2_OC4M_Pos) | TIM_CCMR2_OC4PE;
+    TIM4->CCER |= TIM_CCER_CC4E;
+
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function sets the normalization from raw readings taken over the surface and over the line
+ *
+ * @param p_Surface raw ADC reading (0 .. 4095) of every sensor over the surface
+ * @param p_Line raw ADC reading (0 .. 4095) of every sensor over the line
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t line_sensor_calibrate(const uint16_t *p_Surface, const uint16_t *p_Line)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Surface) || (NULL == p_Line))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        for (uint8_t l_Index = ZERO; (l_Index < LINE_SENSOR_CHANNELS) && (ECU_OK == l_EcuStatus); l_Index++)
+        {
+            int32_t l_Contrast = (int32_t)p_Line[l_Index] - (int32_t)p_Surface[l_Index];
+            if ((l_Contrast < LINE_SENSOR_MIN_CONTRAST) && (l_Contrast > -LINE_SENSOR_MIN_CONTRAST))
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                // a negative gain handles sensors that read lower over the line
+                LineSensorSurface[l_Index] = (int32_t)p_Surface[l_Index] * LINE_SENSOR_SCANS_PER_FRAME;
+                LineSensorGain[l_Index] = (int32_t)((255 << Q16_SHIFT) / (l_Contrast * LINE_SENSOR_SCANS_PER_FRAME));
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function copies the latest frame for readers outside the interrupt
+ *
+ * @param p_Frame destination of the frame
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t line_sensor_get_frame(line_sensor_frame_t *p_Frame)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Frame)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // retry if a new frame was published while copying
+        do
+        {
+            *p_Frame = LineSensorFrames[LineSensorLatest];
+        } while (p_Frame->Sequence != LineSensorFrames[LineSensorLatest].Sequence);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function returns the worst processing time of one frame in cpu cycles
+ *
+ * @return uint32_t cycles
+ */
+uint32_t line_sensor_get_worst_cycles(void)
+{
+    return LineSensorWorstCycles;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief builds one frame directly from the DMA half that just completed (no copy of the samples)
+ *
+ * @param p_Samples LINE_SENSOR_SCANS_PER_FRAME scans of LINE_SENSOR_CHANNELS samples
+ */
+static void line_sensor_process(const uint16_t *p_Samples)
+{
+    uint32_t l_StartCycles = CYCLE_COUNTER_NOW();
+    uint8_t l_Next = LineSensorLatest ^ 1U;
+    line_sensor_frame_t *l_Frame = &LineSensorFrames[l_Next];
+    int32_t l_SumStrength = ZERO;
+    int32_t l_SumMoment = ZERO;
+
+    for (uint8_t l_Index = ZERO; l_Index < LINE_SENSOR_CHANNELS; l_Index++)
+    {
+        int32_t l_Raw = ZERO;
+        for (uint8_t l_Scan = ZERO; l_Scan < LINE_SENSOR_SCANS_PER_FRAME; l_Scan++)
+        {
+            l_Raw += p_Samples[(l_Scan * LINE_SENSOR_CHANNELS) + l_Index];
+        }
+
+        int32_t l_Strength = ((l_Raw - LineSensorSurface[l_Index]) * LineSensorGain[l_Index]) >> Q16_SHIFT;
+        l_Strength = (l_Strength < 0) ? 0 : ((l_Strength > 255) ? 255 : l_Strength);
+
+        l_Frame->Strength[l_Index] = (uint8_t)l_Strength;
+        l_SumStrength += l_Strength;
+        l_SumMoment += l_Strength * LINE_SENSOR_WEIGHT(l_Index);
+    }
+
+    if (l_SumStrength >= LINE_SENSOR_MIN_STRENGTH)
+    {
+        l_Frame->Position = (int16_t)fixed_math_div(l_SumMoment, (uint32_t)l_SumStrength);
+        l_Frame->LineFound = 1;
+    }
+    else
+    {
+        l_Frame->Position = LineSensorFrames[LineSensorLatest].Position;
+        l_Frame->LineFound = ZERO;
+    }
+    l_Frame->Sequence = LineSensorFrames[LineSensorLatest].Sequence + 1U;
+    l_Frame->Timestamp = l_StartCycles;
+    LineSensorLatest = l_Next;
+
+    if (NULL != LineSensorCallback)
+    {
+        LineSensorCallback(l_Frame);
+    }
+
+    uint32_t l_Cycles = CYCLE_COUNTER_ELAPSED(l_StartCycles);
+    if (l_Cycles > LineSensorWorstCycles)
+    {
+        LineSensorWorstCycles = l_Cycles;
+    }
+}
+
+/**
+ * @brief DMA filled the first half, it is processed while the second half fills
+ *
+ * @param p_Dma DMA handle
+ */
+static void line_sensor_half_complete(DMA_HandleTypeDef *p_Dma)
+{
+    (void)p_Dma;
+    line_sensor_process(&LineSensorSamples[0]);
+}
+
+/**
+ * @brief DMA filled the second half, it is processed while the first half fills
+ *
+ * @param p_Dma DMA handle
+ */
+static void line_sensor_complete(DMA_HandleTypeDef *p_Dma)
+{
+    (void)p_Dma;
+    line_sensor_process(&LineSensorSamples[LINE_SENSOR_HALF_SAMPLES]);
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
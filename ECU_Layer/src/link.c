@@ -0,0 +1,131 @@
+/**
+ * @file    link.c
+ * @author  Ahmed Hani
+ * @brief   binary command link with the companion computer, frames parsed in place from the UART DMA ring
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/link.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#if (LINK_HEADER_SIZE + LINK_MAX_PAYLOAD + LINK_CRC_SIZE) > (UART_RX_RING_SIZE / 2)
+#error "a whole frame must fit in half of the UART ring"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static uint32_t link_on_rx(const uint8_t *p_Ring, uint32_t p_Read, uint32_t p_Write);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static link_parser_t LinkParser;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function starts the link on the UART
+ *
+ * @param p_Callback receiver of the commands
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t link_init(link_command_callback_t p_Callback)
+{
+    ecu_status_t l_EcuStatus = link_parser_init(&LinkParser, p_Callback, UART_RX_RING_SIZE);
+    if (ECU_OK == l_EcuStatus)
+    {
+        l_EcuStatus = uart_init(link_on_rx);
+    }
+    else
+    {
+        /* Nothing */
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function copies the counters of the link
+ *
+ * @param p_Stats destination of the counters
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t link_get_stats(link_stats_t *p_Stats)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Stats)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        *p_Stats = LinkParser.Stats;
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief scans the unread bytes for complete frames, an incomplete frame stays in the ring for the next call
+ *
+ * @param p_Ring the DMA ring
+ * @param p_Read offset of the first unread byte
+ * @param p_Write offset where the DMA writes next
+ * @return uint32_t offset of the first byte still needed
+ */
+static uint32_t link_on_rx(const uint8_t *p_Ring, uint32_t p_Read, uint32_t p_Write)
+{
+    return link_parser_scan(&LinkParser, p_Ring, p_Read, p_Write);
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,156 @@
+/**
+ * @file    logger.c
+ * @author  Ahmed Hani
+ * @brief   deferred logging: the format string stays on the host, the target only sends its id and the raw arguments
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/logger.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define LOGGER_ITM_PORTS            ((1UL << LOGGER_ITM_PORT) | (1UL << LOGGER_ITM_ARG_PORT))
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static volatile uint32_t LoggerDropped = ZERO;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function sends one message, use LOGGER_PRINT instead, never waits. a message that finds the transport
+ *        busy is dropped and counted, over ITM it is cut at the first word the stimulus FIFO refuses
+ *
+ * @param p_Header argument count and string id
+ * @param p_Arg0 first argument
+ * @param p_Arg1 second argument
+ * @param p_Arg2 third argument
+ */
+void logger_write(uint32_t p_Header, uint32_t p_Arg0, uint32_t p_Arg1, uint32_t p_Arg2)
+{
+#if LOGGER_TRANSPORT == LOGGER_TRANSPORT_ITM
+    uint32_t l_Args[LOGGER_MAX_ARGS] = {p_Arg0, p_Arg1, p_Arg2};
+    uint32_t l_Count = p_Header >> LOGGER_COUNT_SHIFT;
+    uint32_t l_Primask = __get_PRIMASK();
+    if ((ZERO == (ITM->TCR & ITM_TCR_ITMENA_Msk)) || (LOGGER_ITM_PORTS != (ITM->TER & LOGGER_ITM_PORTS)))
+    {
+        /* Nothing: no debugger listening */
+    }
+    else
+    {
+        // masked for the stores only so the words of two messages never interleave, nothing waits for the SWO
+        __disable_irq();
+        uint8_t l_Sent = (ZERO != ITM->PORT[LOGGER_ITM_PORT].u32);
+        if (l_Sent)
+        {
+            ITM->PORT[LOGGER_ITM_PORT].u32 = p_Header;
+        }
+        else
+        {
+            /* Nothing */
+        }
+        for (uint32_t l_Arg = ZERO; l_Sent && (l_Arg < l_Count) && (l_Arg < LOGGER_MAX_ARGS); l_Arg++)
+        {
+            l_Sent = (ZERO != ITM->PORT[LOGGER_ITM_ARG_PORT].u32);
+            if (l_Sent)
+            {
+                ITM->PORT[LOGGER_ITM_ARG_PORT].u32 = l_Args[l_Arg];
+            }
+            else
+            {
+                /* Nothing */
+            }
+        }
+        __set_PRIMASK(l_Primask);
+
+        if (ZERO == l_Sent)
+        {
+            LoggerDropped++;
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+#else
+    int32_t l_Fields[TELEMETRY_MAX_FIELDS] = {(int32_t)p_Header, (int32_t)p_Arg0, (int32_t)p_Arg1, (int32_t)p_Arg2};
+    if (ECU_OK != telemetry_record(TELEMETRY_LOG, l_Fields))
+    {
+        LoggerDropped++;
+    }
+    else
+    {
+        /* Nothing */
+    }
+#endif
+}
+
+/**
+ * @brief this function tells how many messages were dropped
+ *
+ * @return uint32_t dropped messages since reset
+ */
+uint32_t logger_get_dropped(void)
+{
+    return LoggerDropped;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
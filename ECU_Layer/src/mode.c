@@ -0,0 +1,264 @@
+/**
+ * @file    mode.c
+ * @author  Ahmed Hani
+ * @brief   ADAS driving modes (manual, cruise, ACC, lane keep, park, emergency) and the owner of the motor bank
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/mode.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void mode_brake_vehicle(void *p_Context);
+static void mode_cancel_parking(void *p_Context);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static const fsm_state_t ModeStates[MODE_STATES] =
+{
+    [MODE_STATE_DRIVE]      = { FSM_NONE, FSM_TO(MODE_STATE_MANUAL), MODE_OWNER_NONE, NULL, NULL },
+    [MODE_STATE_MANUAL]     = { FSM_TO(MODE_STATE_DRIVE), FSM_NONE, MODE_OWNER_LINK, NULL, NULL },
+    [MODE_STATE_ASSIST]     = { FSM_TO(MODE_STATE_DRIVE), FSM_TO(MODE_STATE_CRUISE), MODE_OWNER_NONE,
+                                NULL, mode_brake_vehicle },
+    [MODE_STATE_CRUISE]     = { FSM_TO(MODE_STATE_ASSIST), FSM_NONE, MODE_OWNER_ACC, NULL, NULL },
+    [MODE_STATE_ACC]        = { FSM_TO(MODE_STATE_ASSIST), FSM_NONE, MODE_OWNER_ACC, NULL, NULL },
+    [MODE_STATE_LANE_KEEP]  = { FSM_TO(MODE_STATE_ASSIST), FSM_NONE, MODE_OWNER_LANE_KEEP, NULL, NULL },
+    [MODE_STATE_PARK]       = { FSM_TO(MODE_STATE_DRIVE), FSM_NONE, MODE_OWNER_PARKING, NULL, mode_cancel_parking },
+    [MODE_STATE_EMERGENCY]  = { FSM_NONE, FSM_NONE, MODE_OWNER_AEB, mode_brake_vehicle, NULL },
+};
+
+/* unlisted entries are FSM_NONE: the event goes to the parent */
+static const uint8_t ModeTransitions[MODE_STATES][MODE_EVENTS] =
+{
+    [MODE_STATE_DRIVE] =
+    {
+        [MODE_EVENT_OBSTACLE]   = FSM_TO(MODE_STATE_EMERGENCY),
+        [MODE_EVENT_LINK_LOST]  = FSM_TO(MODE_STATE_EMERGENCY),
+        [MODE_EVENT_MANUAL]     = FSM_IGNORE,
+        [MODE_EVENT_PARK_DONE]  = FSM_IGNORE,
+        [MODE_EVENT_CLEAR]      = FSM_IGNORE,
+    },
+    [MODE_STATE_MANUAL] =
+    {
+        [MODE_EVENT_CRUISE]     = FSM_TO(MODE_STATE_CRUISE),
+        [MODE_EVENT_ACC]        = FSM_TO(MODE_STATE_ACC),
+        [MODE_EVENT_LANE_KEEP]  = FSM_TO(MODE_STATE_LANE_KEEP),
+        [MODE_EVENT_PARK]       = FSM_TO(MODE_STATE_PARK),
+    },
+    [MODE_STATE_ASSIST] =
+    {
+        [MODE_EVENT_MANUAL]     = FSM_TO(MODE_STATE_MANUAL),
+        [MODE_EVENT_CRUISE]     = FSM_TO(MODE_STATE_CRUISE),
+        [MODE_EVENT_ACC]        = FSM_TO(MODE_STATE_ACC),
+        [MODE_EVENT_LANE_KEEP]  = FSM_TO(MODE_STATE_LANE_KEEP),
+        [MODE_EVENT_PARK]       = FSM_TO(MODE_STATE_PARK),
+    },
+    [MODE_STATE_CRUISE] =
+    {
+        [MODE_EVENT_CRUISE]     = FSM_IGNORE,
+    },
+    [MODE_STATE_ACC] =
+    {
+        [MODE_EVENT_ACC]        = FSM_IGNORE,
+    },
+    [MODE_STATE_LANE_KEEP] =
+    {
+        [MODE_EVENT_LANE_KEEP]  = FSM_IGNORE,
+    },
+    [MODE_STATE_PARK] =
+    {
+        [MODE_EVENT_MANUAL]     = FSM_TO(MODE_STATE_MANUAL),
+        [MODE_EVENT_PARK_DONE]  = FSM_TO(MODE_STATE_MANUAL),
+        [MODE_EVENT_CRUISE]     = FSM_IGNORE,
+        [MODE_EVENT_ACC]        = FSM_IGNORE,
+        [MODE_EVENT_LANE_KEEP]  = FSM_IGNORE,
+        [MODE_EVENT_PARK]       = FSM_IGNORE,
+    },
+    [MODE_STATE_EMERGENCY] =
+    {
+        [MODE_EVENT_CLEAR]      = FSM_TO(MODE_STATE_MANUAL),
+    },
+};
+
+static const fsm_table_t ModeTable =
+{
+    .States = ModeStates,
+    .Transitions = &ModeTransitions[0][0],
+    .StateCount = MODE_STATES,
+    .EventCount = MODE_EVENTS,
+    .Initial = MODE_STATE_DRIVE,
+};
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the mode machine in MANUAL
+ *
+ * @param p_Mode object of the mode machine
+ * @param p_Vehicle drivetrain (can be NULL)
+ * @param p_Parking parking assist (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t mode_init(mode_machine_t *p_Mode, vehicle_t *p_Vehicle, parking_t *p_Parking)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if (NULL == p_Mode)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Mode->Vehicle = p_Vehicle;
+        p_Mode->Parking = p_Parking;
+        l_EcuStatus = fsm_init(&p_Mode->Fsm, &ModeTable, p_Mode);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function queues an event, safe from any handler
+ *
+ * @param p_Mode object of the mode machine
+ * @param p_Event event
+ * @return ecu_status_t ECU_ERROR if the queue is full
+ */
+ecu_status_t mode_post(mode_machine_t *p_Mode, mode_event_t p_Event)
+{
+    ecu_status_t l_EcuStatus = ECU_ERROR;
+
+    if (NULL != p_Mode)
+    {
+        l_EcuStatus = fsm_post(&p_Mode->Fsm, (uint8_t)p_Event);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function applies the queued events, called once per control tick before the motors are commanded
+ *
+ * @param p_Mode object of the mode machine
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t mode_step(mode_machine_t *p_Mode)
+{
+    ecu_status_t l_EcuStatus = ECU_ERROR;
+
+    if (NULL != p_Mode)
+    {
+        l_EcuStatus = fsm_dispatch(&p_Mode->Fsm);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function tells the active mode
+ *
+ * @param p_Mode object of the mode machine
+ * @return mode_state_t active leaf state
+ */
+mode_state_t mode_get(const mode_machine_t *p_Mode)
+{
+    return (mode_state_t)fsm_get_state(&p_Mode->Fsm);
+}
+
+/**
+ * @brief this function tells which module owns the motor bank in the active mode
+ *
+ * @param p_Mode object of the mode machine
+ * @return mode_owner_t owner
+ */
+mode_owner_t mode_get_owner(const mode_machine_t *p_Mode)
+{
+    return (mode_owner_t)fsm_get_owner(&p_Mode->Fsm);
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief brakes all wheels, the next owner starts from rest. a brake and not a coast: it never undoes the brake the
+ *        AEB may hold at the same time
+ *
+ * @param p_Context object of the mode machine
+ */
+static void mode_brake_vehicle(void *p_Context)
+{
+    mode_machine_t *l_Mode = (mode_machine_t *)p_Context;
+
+    if (NULL != l_Mode->Vehicle)
+    {
+        (void)vehicle_brake(l_Mode->Vehicle);
+    }
+}
+
+/**
+ * @brief stops the parking assist wherever it is in its manoeuvre
+ *
+ * @param p_Context object of the mode machine
+ */
+static void mode_cancel_parking(void *p_Context)
+{
+    mode_machine_t *l_Mode = (mode_machine_t *)p_Context;
+
+    if (NULL != l_Mode->Parking)
+    {
+        (void)parking_cancel(l_Mode->Parking);
+    }
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -11,18 +11,26 @@
 ***********************************************************************************************************************/
 #include "../inc/morot.h"
 #include "../inc/ecu.h"
+#include "../inc/param.h"
 
 
 /***********************************************************************************************************************
 *                                                    MACRO DEFINES                                                     *
 ***********************************************************************************************************************/
 #define DEFUALT_SPEED (100.0)
+#define MOTOR_CURVE_SCALE ((float_t)((MOTOR_CURVE_POINTS - 1) << 16) / (float_t)MOTOR_MAX_SPEED)
+#define MOTOR_CURVE_LAST ((float_t)(((MOTOR_CURVE_POINTS - 1) << 16) - 1))   // keeps point + 1 inside the curve
+#define MOTOR_LUT_SCALE(maxSpeed) ((float_t)(MOTOR_LUT_SEGMENTS << 16) / (float_t)(maxSpeed))
+#define MOTOR_LUT_LAST ((float_t)((MOTOR_LUT_SEGMENTS << 16) - 1))
+#define MOTOR_NOMINAL_SCALE ((uint32_t)Q16_ONE)      // running period equals TIMER_AUTO_RELOAD_VAL
 
 
 
 /***********************************************************************************************************************
 *                                                   MACRO FUNCTIONS                                                    *
 ***********************************************************************************************************************/
+/* compare in TIMER_AUTO_RELOAD_VAL units to the running pwm period, at most 4200 * 2^16 so it stays in 32 bit */
+#define MOTOR_SCALE_COMPARE(compare) (((uint32_t)(compare) * MotorCompareScale) >> Q16_SHIFT)
 
 
 
@@ -30,7 +38,8 @@
 /***********************************************************************************************************************
 *                                               STATIC FUNCTION DEFINITION                                             *
 ***********************************************************************************************************************/
-
+ECU_RAMFUNC static inline uint32_t motor_speed_to_compare(const motor_t *p_Motor, float_t p_Speed);
+ECU_RAMFUNC static inline uint32_t motor_table_interpolate(const uint16_t *p_Table, float_t p_Position, float_t p_Last);
 
 
 
@@ -47,6 +56,10 @@ float_t MaxClibratedSpeed = DEFUALT_SPEED;          // defualt speed before cali
 /***********************************************************************************************************************
 *                                                     STATIC OBJECTS                                                   *
 ***********************************************************************************************************************/
+static const motor_lut_t MotorDefaultLut = MOTOR_LUT_INIT(MOTOR_DEFAULT_DEAD_ZONE, MOTOR_DEFAULT_CURVATURE);
+static float_t MotorSpeedToLut = MOTOR_LUT_SCALE(DEFUALT_SPEED);     // follows MaxClibratedSpeed, no divide per call
+static volatile uint32_t MotorCompareScale = MOTOR_NOMINAL_SCALE;  // Q16 running period / TIMER_AUTO_RELOAD_VAL
+static volatile uint8_t MotorBrakeLatched = ZERO;                   // set by the AEB, every drive write is refused
 
 
 
@@ -101,8 +114,18 @@ ecu_status_t motor_move_forward(motor_t *p_Motor , float_t p_Speed)
     }
     else
     {
-        HAL_GPIO_WritePin(p_Motor->GpioxMotor[0] , p_Motor->GpioPinMotor[0] , GPIO_PIN_SET);
-        HAL_GPIO_WritePin(p_Motor->GpioxMotor[1] , p_Motor->GpioPinMotor[1] , GPIO_PIN_RESET);
+        uint32_t l_Primask = __get_PRIMASK();
+        __disable_irq();
+        if (MotorBrakeLatched)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            HAL_GPIO_WritePin(p_Motor->GpioxMotor[0] , p_Motor->GpioPinMotor[0] , GPIO_PIN_SET);
+            HAL_GPIO_WritePin(p_Motor->GpioxMotor[1] , p_Motor->GpioPinMotor[1] , GPIO_PIN_RESET);
+        }
+        __set_PRIMASK(l_Primask);
     }
     return l_EcuStatus;
 }
@@ -122,8 +145,18 @@ ecu_status_t motor_move_backward(motor_t *p_Motor , float_t p_Speed)
     }
     else
     {
-        HAL_GPIO_WritePin(p_Motor->GpioxMotor[0] , p_Motor->GpioPinMotor[0] , GPIO_PIN_RESET);
-        HAL_GPIO_WritePin(p_Motor->GpioxMotor[1] , p_Motor->GpioPinMotor[1] , GPIO_PIN_SET);
+        uint32_t l_Primask = __get_PRIMASK();
+        __disable_irq();
+        if (MotorBrakeLatched)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            HAL_GPIO_WritePin(p_Motor->GpioxMotor[0] , p_Motor->GpioPinMotor[0] , GPIO_PIN_RESET);
+            HAL_GPIO_WritePin(p_Motor->GpioxMotor[1] , p_Motor->GpioPinMotor[1] , GPIO_PIN_SET);
+        }
+        __set_PRIMASK(l_Primask);
     }
     return l_EcuStatus;
 }
@@ -142,12 +175,67 @@ ecu_status_t motor_stop(motor_t *p_Motor)
     }
     else
     {
-        HAL_GPIO_WritePin(p_Motor->GpioxMotor[0] , p_Motor->GpioPinMotor[0] , GPIO_PIN_RESET);
-        HAL_GPIO_WritePin(p_Motor->GpioxMotor[1] , p_Motor->GpioPinMotor[1] , GPIO_PIN_RESET);
+        uint32_t l_Primask = __get_PRIMASK();
+        __disable_irq();
+        if (MotorBrakeLatched)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            HAL_GPIO_WritePin(p_Motor->GpioxMotor[0] , p_Motor->GpioPinMotor[0] , GPIO_PIN_RESET);
+            HAL_GPIO_WritePin(p_Motor->GpioxMotor[1] , p_Motor->GpioPinMotor[1] , GPIO_PIN_RESET);
+        }
+        __set_PRIMASK(l_Primask);
     }
     return l_EcuStatus;
 }
 
+/**
+  * @brief This function actively brakes the motor by shorting its terminals (both pins high, full duty)
+  * @param p_Motor object of motor
+  * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t motor_brake(motor_t *p_Motor)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Motor)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // BSRR directly instead of HAL_GPIO_WritePin so the brake path never runs from flash
+        p_Motor->GpioxMotor[0]->BSRR = (uint32_t)p_Motor->GpioPinMotor[0];
+        p_Motor->GpioxMotor[1]->BSRR = (uint32_t)p_Motor->GpioPinMotor[1];
+        __HAL_TIM_SetCompare(p_Motor->SelectedTimer, p_Motor->SelectedChannel,
+                             MOTOR_SCALE_COMPARE(TIMER_AUTO_RELOAD_VAL));
+    }
+    return l_EcuStatus;
+}
+
+/**
+  * @brief This function latches or releases the brake: while latched every drive write (forward, backward, stop,
+  *        change speed, bank set) is refused with ECU_ERROR and only motor_brake reaches the motors. the latch is
+  *        set before the motors are braked, a writer checks it with interrupts masked around its register writes
+  * @param p_Latched nonzero latches the brake, zero releases it
+  * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t motor_set_brake_latch(uint8_t p_Latched)
+{
+    MotorBrakeLatched = (ZERO != p_Latched);
+    return ECU_OK;
+}
+
+/**
+  * @brief This function tells if the brake is latched
+  * @return uint8_t one while latched
+ */
+uint8_t motor_is_brake_latched(void)
+{
+    return MotorBrakeLatched;
+}
+
 /**
   *
   * @brief This function change the speed of motor
@@ -164,12 +252,225 @@ ecu_status_t motor_change_speed(motor_t *p_Motor , float_t p_Speed)
     }
     else
     {
-        // get the value of duty cycle in percentage
-        float_t l_PwmDutyCycle = (float_t)((float_t)p_Speed / (float_t)MaxClibratedSpeed);
-        // get the value of CCRx Register
-        uint32_t l_PwmCCR = (uint32_t)(l_PwmDutyCycle * TIMER_AUTO_RELOAD_VAL);
-        // change the output duty cycle of the timer
-        __HAL_TIM_SetCompare(p_Motor->SelectedTimer, p_Motor->SelectedChannel, l_PwmCCR);
+        uint32_t l_PwmCCR = motor_speed_to_compare(p_Motor, p_Speed);
+        uint32_t l_Primask = __get_PRIMASK();
+        __disable_irq();
+        if (MotorBrakeLatched)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            // change the output duty cycle of the timer
+            __HAL_TIM_SetCompare(p_Motor->SelectedTimer, p_Motor->SelectedChannel, l_PwmCCR);
+        }
+        __set_PRIMASK(l_Primask);
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/**
+  * @brief This function loads the calibrated speed from the parameter store (param_init must run before),
+  *        the default stays when it was never calibrated
+  * @return ecu_status_t ECU_ERROR if no calibration is stored
+ */
+ecu_status_t motor_load_calibration(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    float_t l_Speed = ZERO;
+    l_EcuStatus = param_get_float(PARAM_MAX_CALIBRATED_SPEED, &l_Speed);
+    if ((ECU_OK == l_EcuStatus) && (l_Speed > 0.0f))
+    {
+        MaxClibratedSpeed = l_Speed;
+        MotorSpeedToLut = MOTOR_LUT_SCALE(l_Speed);
+    }
+    else
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    return l_EcuStatus;
+}
+
+/**
+  * @brief This function changes the speed mapped to full duty and keeps it in the parameter store
+  * @param p_Speed calibrated speed (positive)
+  * @return ecu_status_t status of the operation
+ */
+ecu_status_t motor_set_calibration(float_t p_Speed)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (!(p_Speed > 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        MaxClibratedSpeed = p_Speed;
+        MotorSpeedToLut = MOTOR_LUT_SCALE(p_Speed);
+        l_EcuStatus = param_set_float(PARAM_MAX_CALIBRATED_SPEED, p_Speed);
+    }
+    return l_EcuStatus;
+}
+
+/**
+  * @brief This function follows a change of the pwm timer clock (power.h): compares are still given in
+  *        TIMER_AUTO_RELOAD_VAL units and scaled to the new period. called with interrupts masked
+  * @param p_Period auto reload + 1 now loaded in the timer
+  * @return ecu_status_t status of the operation
+ */
+ecu_status_t motor_set_pwm_period(uint32_t p_Period)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((ZERO == p_Period) || (p_Period > TIMER_AUTO_RELOAD_VAL))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        MotorCompareScale = (p_Period << Q16_SHIFT) / TIMER_AUTO_RELOAD_VAL;
+    }
+    return l_EcuStatus;
+}
+
+/**
+  * @brief This function converts a compare value in TIMER_AUTO_RELOAD_VAL units to the running pwm period
+  * @param p_Compare compare at the nominal period
+  * @return uint32_t value of the compare register
+ */
+uint32_t motor_scale_compare(uint32_t p_Compare)
+{
+    return MOTOR_SCALE_COMPARE(p_Compare);
+}
+
+/**
+  * @brief This function initializes the motors of a bank and enables the compare preload used by motor_bank_set
+  * @param p_Motors array of motors
+  * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+  * @return ecu_status_t status of the operation
+ */
+ecu_status_t motor_bank_init(motor_t *const *p_Motors, uint8_t p_Count)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Motors) || (ZERO == p_Count) || (p_Count > MOTOR_BANK_MAX_MOTORS))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        for (uint8_t l_Index = ZERO; (l_Index < p_Count) && (ECU_OK == l_EcuStatus); l_Index++)
+        {
+            l_EcuStatus = motor_init(p_Motors[l_Index]);
+            if (ECU_OK == l_EcuStatus)
+            {
+                // new duties wait for the update event, so the whole bank switches together
+                __HAL_TIM_ENABLE_OCxPRELOAD(p_Motors[l_Index]->SelectedTimer, p_Motors[l_Index]->SelectedChannel);
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+  * @brief This function sets direction and speed of several motors in one batch
+  * @param p_Motors array of motors
+  * @param p_Speeds signed speed of every motor, negative moves it backward
+  * @param p_Count number of motors (up to MOTOR_BANK_MAX_MOTORS)
+  * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t motor_bank_set(motor_t *const *p_Motors, const float_t *p_Speeds, uint8_t p_Count)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    GPIO_TypeDef *l_Ports[2 * MOTOR_BANK_MAX_MOTORS];
+    uint32_t l_PortBsrr[2 * MOTOR_BANK_MAX_MOTORS];
+    uint32_t l_Compare[MOTOR_BANK_MAX_MOTORS];
+    uint8_t l_PortCount = ZERO;
+    uint8_t l_Switching = ZERO;     // one bit per motor whose direction pins change
+
+    if ((NULL == p_Motors) || (NULL == p_Speeds) || (ZERO == p_Count) || (p_Count > MOTOR_BANK_MAX_MOTORS))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        /* gather set / reset bits per port and the compare values first, nothing is written yet */
+        for (uint8_t l_Index = ZERO; (l_Index < p_Count) && (ECU_OK == l_EcuStatus); l_Index++)
+        {
+            motor_t *l_Motor = p_Motors[l_Index];
+            if (NULL == l_Motor)
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                uint8_t l_Backward = (p_Speeds[l_Index] < 0.0f);
+                l_Compare[l_Index] = motor_speed_to_compare(l_Motor, l_Backward ? -p_Speeds[l_Index]
+                                                                                : p_Speeds[l_Index]);
+
+                for (uint8_t l_Pin = ZERO; l_Pin < 2; l_Pin++)
+                {
+                    // forward: pin 0 set, pin 1 reset / backward: the opposite
+                    uint32_t l_Bits = (l_Pin == l_Backward) ? (uint32_t)l_Motor->GpioPinMotor[l_Pin]
+                                                            : ((uint32_t)l_Motor->GpioPinMotor[l_Pin] << 16);
+                    uint8_t l_IsSet = (ZERO != (l_Motor->GpioxMotor[l_Pin]->ODR & l_Motor->GpioPinMotor[l_Pin]));
+                    if (l_IsSet != (l_Pin == l_Backward))
+                    {
+                        l_Switching |= (uint8_t)(1U << l_Index);
+                    }
+                    uint8_t l_Port = ZERO;
+                    while ((l_Port < l_PortCount) && (l_Ports[l_Port] != l_Motor->GpioxMotor[l_Pin]))
+                    {
+                        l_Port++;
+                    }
+                    if (l_Port == l_PortCount)
+                    {
+                        l_Ports[l_Port] = l_Motor->GpioxMotor[l_Pin];
+                        l_PortBsrr[l_Port] = ZERO;
+                        l_PortCount++;
+                    }
+                    l_PortBsrr[l_Port] |= l_Bits;
+                }
+            }
+        }
+
+        if (ECU_OK == l_EcuStatus)
+        {
+            // the latch is checked in the same masked section as the writes, the AEB can not fire in between
+            uint32_t l_Primask = __get_PRIMASK();
+            __disable_irq();
+            if (MotorBrakeLatched)
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                /* the new compare is preloaded until the update but the pins act at once: a motor changing direction
+                   (or leaving the brake) is cut off first, its compare is zeroed directly in the active register,
+                   so it coasts for the rest of the period instead of running reversed at its old duty */
+                for (uint8_t l_Index = ZERO; l_Index < p_Count; l_Index++)
+                {
+                    if (l_Switching & (1U << l_Index))
+                    {
+                        motor_t *l_Motor = p_Motors[l_Index];
+                        __HAL_TIM_DISABLE_OCxPRELOAD(l_Motor->SelectedTimer, l_Motor->SelectedChannel);
+                        __HAL_TIM_SetCompare(l_Motor->SelectedTimer, l_Motor->SelectedChannel, ZERO);
+                        __HAL_TIM_ENABLE_OCxPRELOAD(l_Motor->SelectedTimer, l_Motor->SelectedChannel);
+                    }
+                }
+                for (uint8_t l_Port = ZERO; l_Port < l_PortCount; l_Port++)
+                {
+                    l_Ports[l_Port]->BSRR = l_PortBsrr[l_Port];
+                }
+                for (uint8_t l_Index = ZERO; l_Index < p_Count; l_Index++)
+                {
+                    __HAL_TIM_SetCompare(p_Motors[l_Index]->SelectedTimer, p_Motors[l_Index]->SelectedChannel,
+                                         l_Compare[l_Index]);
+                }
+            }
+            __set_PRIMASK(l_Primask);
+        }
     }
     return l_EcuStatus;
 }
@@ -181,6 +482,47 @@ ecu_status_t motor_change_speed(motor_t *p_Motor , float_t p_Speed)
 *                                               STATIC FUNCTION DECLARATION                                            *
 ***********************************************************************************************************************/
 
+/**
+  * @brief converts a speed to the CCRx value of the pwm through the calibration curve of the motor, else its
+  *        compensation table, else the default table, then to the running pwm period
+  * @param p_Motor object of motor
+  * @param p_Speed speed of motor (positive)
+  * @return uint32_t value of the compare register
+ */
+ECU_RAMFUNC static inline uint32_t motor_speed_to_compare(const motor_t *p_Motor, float_t p_Speed)
+{
+    uint32_t l_PwmCCR = ZERO;
+    if (NULL != p_Motor->Curve)
+    {
+        l_PwmCCR = motor_table_interpolate(p_Motor->Curve->Compare, p_Speed * MOTOR_CURVE_SCALE, MOTOR_CURVE_LAST);
+    }
+    else
+    {
+        const motor_lut_t *l_Lut = (NULL != p_Motor->Lut) ? p_Motor->Lut : &MotorDefaultLut;
+        l_PwmCCR = motor_table_interpolate(l_Lut->Compare, p_Speed * MotorSpeedToLut, MOTOR_LUT_LAST);
+    }
+    return MOTOR_SCALE_COMPARE(l_PwmCCR);
+}
+
+/**
+  * @brief interpolates a speed to compare table, without branches: the clamps compile to selects and a zero
+  *        speed masks the result so the motor is off instead of sitting at the end of the dead zone
+  * @param p_Table compare values at evenly spaced speeds
+  * @param p_Position position in the table (Q16 index)
+  * @param p_Last largest position, keeps entry + 1 inside the table
+  * @return uint32_t value of the compare register
+ */
+ECU_RAMFUNC static inline uint32_t motor_table_interpolate(const uint16_t *p_Table, float_t p_Position, float_t p_Last)
+{
+    float_t l_Position = (p_Position > 0.0f) ? p_Position : 0.0f;
+    uint32_t l_Fixed = (uint32_t)((l_Position < p_Last) ? l_Position : p_Last);
+    uint32_t l_Entry = l_Fixed >> 16;
+    int32_t l_Base = (int32_t)p_Table[l_Entry];
+    int32_t l_Slope = (int32_t)p_Table[l_Entry + 1U] - l_Base;
+    uint32_t l_PwmCCR = (uint32_t)(l_Base + ((l_Slope * (int32_t)(l_Fixed & 0xFFFFU)) >> 16));
+    return l_PwmCCR & (ZERO - (uint32_t)(l_Fixed != ZERO));
+}
+
 
 
 
@@ -0,0 +1,282 @@
+/**
+ * @file    occupancy.c
+ * @author  Ahmed Hani
+ * @brief   polar occupancy histogram of recent range hits (36 sectors x 16 range bins) with age decay
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/occupancy.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define OCCUPANCY_CELL_BITS         (4)
+#define OCCUPANCY_CELL_MASK         (0xFULL)
+#define OCCUPANCY_CELL_ONES         (0x1111111111111111ULL)     // lowest bit of every cell
+#define OCCUPANCY_CELL_TOPS         (0x8888888888888888ULL)     // OCCUPANCY_OCCUPIED bit of every cell
+#define OCCUPANCY_MAX_DECAY         (4)                         // four halvings empty any cell
+#define OCCUPANCY_SECTOR_BAM        (119304647UL)               // 2^32 / OCCUPANCY_SECTORS
+
+#if (OCCUPANCY_BINS * OCCUPANCY_CELL_BITS) != 64
+#error "a sector must fill exactly one 64 bit row"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* sector holding a binary angle, a multiply high instead of a divide */
+#define OCCUPANCY_SECTOR_OF(bam)    ((uint8_t)(((uint64_t)(uint32_t)(bam) * OCCUPANCY_SECTORS) >> 32))
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static inline uint64_t occupancy_decayed_row(const occupancy_t *p_Map, uint8_t p_Sector);
+static inline uint64_t occupancy_bins_below(uint32_t p_Bin);
+static inline uint32_t occupancy_range_to_bin(const occupancy_t *p_Map, q16_t p_Range);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+/* keeps the bits that survive k halvings of every cell at once */
+static const uint64_t OccupancyDecayMasks[OCCUPANCY_MAX_DECAY + 1] =
+{
+    0xFFFFFFFFFFFFFFFFULL,
+    0x7777777777777777ULL,
+    0x3333333333333333ULL,
+    0x1111111111111111ULL,
+    0x0000000000000000ULL,
+};
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function clears the map
+ *
+ * @param p_Map object of occupancy map
+ * @param p_BinWidth radial size of a bin in meters, the map reaches OCCUPANCY_BINS times this
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t occupancy_init(occupancy_t *p_Map, float_t p_BinWidth)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Map) || (p_BinWidth <= 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Map, ZERO, sizeof(occupancy_t));
+        p_Map->BinsPerMeter = Q16_FROM_FLOAT(1.0f / p_BinWidth);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function ages the whole map by one epoch (every cell halves), O(1)
+ *
+ * @param p_Map object of occupancy map
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t occupancy_tick(occupancy_t *p_Map)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Map)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // the decay itself is applied lazily when a sector is touched, one sector is refreshed per tick so
+        // the 8 bit epoch difference of a sector never wraps
+        p_Map->Epoch++;
+        uint8_t l_Sector = p_Map->RefreshSector;
+        p_Map->Rows[l_Sector] = occupancy_decayed_row(p_Map, l_Sector);
+        p_Map->SectorEpoch[l_Sector] = p_Map->Epoch;
+        p_Map->RefreshSector = (uint8_t)((l_Sector + 1U) % OCCUPANCY_SECTORS);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function adds one range reading, the cells in front of the hit are cleared, O(1)
+ *
+ * @param p_Map object of occupancy map
+ * @param p_Bearing direction of the reading (binary angle), use heading + sensor mount for a map that survives turns
+ * @param p_Range filtered range in meters (Q16), beyond the map it only clears the sector
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t occupancy_update(occupancy_t *p_Map, uint32_t p_Bearing, q16_t p_Range)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Map)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint8_t l_Sector = OCCUPANCY_SECTOR_OF(p_Bearing);
+        uint32_t l_Bin = occupancy_range_to_bin(p_Map, p_Range);
+        uint64_t l_Row = occupancy_decayed_row(p_Map, l_Sector);
+
+        /* miss: saturating decrement of every non empty cell in front of the hit */
+        uint64_t l_NonZero = (l_Row | (l_Row >> 1) | (l_Row >> 2) | (l_Row >> 3)) & OCCUPANCY_CELL_ONES;
+        l_Row -= l_NonZero & occupancy_bins_below(l_Bin);
+
+        /* hit: saturating add on the cell of the range */
+        if (l_Bin < OCCUPANCY_BINS)
+        {
+            uint32_t l_Shift = l_Bin * OCCUPANCY_CELL_BITS;
+            uint32_t l_Cell = (uint32_t)((l_Row >> l_Shift) & OCCUPANCY_CELL_MASK) + OCCUPANCY_HIT_WEIGHT;
+            l_Cell = (l_Cell > OCCUPANCY_CELL_MAX) ? OCCUPANCY_CELL_MAX : l_Cell;
+            l_Row = (l_Row & ~(OCCUPANCY_CELL_MASK << l_Shift)) | ((uint64_t)l_Cell << l_Shift);
+        }
+
+        p_Map->Rows[l_Sector] = l_Row;
+        p_Map->SectorEpoch[l_Sector] = p_Map->Epoch;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function finds the free direction closest to the preferred one
+ *
+ * @param p_Map object of occupancy map
+ * @param p_Preferred wanted direction (binary angle)
+ * @param p_Clearance needed free distance in meters (Q16)
+ * @param p_HalfWidth sectors on each side that must also be free (vehicle width)
+ * @param p_Direction center of the free sector found (binary angle)
+ * @return ecu_status_t ECU_ERROR if every direction is blocked
+ */
+ecu_status_t occupancy_find_free(const occupancy_t *p_Map, uint32_t p_Preferred, q16_t p_Clearance,
+                                 uint8_t p_HalfWidth, uint32_t *p_Direction)
+{
+    ecu_status_t l_EcuStatus = ECU_ERROR;
+    if ((NULL != p_Map) && (NULL != p_Direction))
+    {
+        uint64_t l_OccupiedMask = occupancy_bins_below(occupancy_range_to_bin(p_Map, p_Clearance) + 1U) &
+                                  OCCUPANCY_CELL_TOPS;
+        uint64_t l_Blocked = ZERO;
+        uint8_t l_Preferred = OCCUPANCY_SECTOR_OF(p_Preferred);
+
+        if (p_HalfWidth > (OCCUPANCY_SECTORS / 2))
+        {
+            p_HalfWidth = OCCUPANCY_SECTORS / 2;
+        }
+
+        // one bit per sector, a sector is blocked if any cell within the clearance is occupied
+        for (uint8_t l_Sector = ZERO; l_Sector < OCCUPANCY_SECTORS; l_Sector++)
+        {
+            if (occupancy_decayed_row(p_Map, l_Sector) & l_OccupiedMask)
+            {
+                l_Blocked |= 1ULL << l_Sector;
+            }
+        }
+
+        // search outwards from the preferred sector, alternating sides
+        for (uint8_t l_Offset = ZERO; (l_Offset <= (OCCUPANCY_SECTORS / 2)) && (ECU_OK != l_EcuStatus); l_Offset++)
+        {
+            for (uint8_t l_Side = ZERO; (l_Side < 2) && (ECU_OK != l_EcuStatus); l_Side++)
+            {
+                uint8_t l_Candidate = (uint8_t)((ZERO == l_Side) ?
+                                      ((l_Preferred + l_Offset) % OCCUPANCY_SECTORS) :
+                                      ((l_Preferred + OCCUPANCY_SECTORS - l_Offset) % OCCUPANCY_SECTORS));
+                uint8_t l_Free = 1;
+                for (int8_t l_Width = -(int8_t)p_HalfWidth; (l_Width <= (int8_t)p_HalfWidth) && l_Free; l_Width++)
+                {
+                    uint8_t l_Sector = (uint8_t)((l_Candidate + OCCUPANCY_SECTORS + l_Width) % OCCUPANCY_SECTORS);
+                    l_Free = (ZERO == (l_Blocked & (1ULL << l_Sector)));
+                }
+                if (l_Free)
+                {
+                    *p_Direction = (l_Candidate * OCCUPANCY_SECTOR_BAM) + (OCCUPANCY_SECTOR_BAM / 2U);
+                    l_EcuStatus = ECU_OK;
+                }
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief row of a sector with the pending decay applied (one shift and one mask)
+ *
+ * @param p_Map object of occupancy map
+ * @param p_Sector sector index
+ * @return uint64_t decayed row
+ */
+static inline uint64_t occupancy_decayed_row(const occupancy_t *p_Map, uint8_t p_Sector)
+{
+    uint8_t l_Age = (uint8_t)(p_Map->Epoch - p_Map->SectorEpoch[p_Sector]);
+    l_Age = (l_Age > OCCUPANCY_MAX_DECAY) ? OCCUPANCY_MAX_DECAY : l_Age;
+    return (p_Map->Rows[p_Sector] >> l_Age) & OccupancyDecayMasks[l_Age];
+}
+
+/**
+ * @brief mask of every cell closer than a bin
+ *
+ * @param p_Bin bin index, OCCUPANCY_BINS or more selects the whole row
+ * @return uint64_t mask
+ */
+static inline uint64_t occupancy_bins_below(uint32_t p_Bin)
+{
+    return (p_Bin >= OCCUPANCY_BINS) ? ~0ULL : ((1ULL << (p_Bin * OCCUPANCY_CELL_BITS)) - 1ULL);
+}
+
+/**
+ * @brief bin of a range, negative ranges fall in the first bin
+ *
+ * @param p_Map object of occupancy map
+ * @param p_Range range in meters (Q16)
+ * @return uint32_t bin index, OCCUPANCY_BINS or more is out of the map
+ */
+static inline uint32_t occupancy_range_to_bin(const occupancy_t *p_Map, q16_t p_Range)
+{
+    return (p_Range <= 0) ? 0U : (uint32_t)(((int64_t)p_Range * p_Map->BinsPerMeter) >> (2 * Q16_SHIFT));
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,214 @@
+/**
+ * @file    odometry.c
+ * @author  Ahmed Hani
+ * @brief   dead reckoning pose (x, y, heading) from wheel encoder deltas and gyro yaw rate
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/odometry.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define ODOMETRY_TWO_PI         (6.283185307f)
+#define ODOMETRY_BAM_PER_TURN   (4294967296.0f)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void odometry_publish(odometry_t *p_Odometry);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the odometry at the origin
+ *
+ * @param p_Odometry object of odometry
+ * @param p_Config tuning of the odometry
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_init(odometry_t *p_Odometry, const odometry_config_t *p_Config)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Odometry) || (NULL == p_Config) || (p_Config->MetersPerTick <= 0.0f) ||
+        (p_Config->TrackWidth <= 0.0f) || (p_Config->UpdatePeriod <= 0.0f) ||
+        (p_Config->GyroWeight < 0.0f) || (p_Config->GyroWeight > 1.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Odometry, ZERO, sizeof(odometry_t));
+        /* all scale factors are folded here so the update is only multiplies, adds and shifts */
+        p_Odometry->MetersPerTick = (int64_t)(p_Config->MetersPerTick * ODOMETRY_BAM_PER_TURN);
+        p_Odometry->EncoderTurn = (int32_t)((p_Config->MetersPerTick / p_Config->TrackWidth) *
+                                            (ODOMETRY_BAM_PER_TURN / ODOMETRY_TWO_PI));
+        p_Odometry->GyroTurn = (int32_t)(p_Config->UpdatePeriod * (ODOMETRY_BAM_PER_TURN / ODOMETRY_TWO_PI));
+        p_Odometry->GyroWeight = Q16_FROM_FLOAT(p_Config->GyroWeight);
+        odometry_publish(p_Odometry);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function moves the pose to a known place, must not race with odometry_update()
+ *
+ * @param p_Odometry object of odometry
+ * @param p_Pose new pose
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_set_pose(odometry_t *p_Odometry, const odometry_pose_t *p_Pose)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Odometry) || (NULL == p_Pose))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Odometry->X = (int64_t)p_Pose->X << Q16_SHIFT;
+        p_Odometry->Y = (int64_t)p_Pose->Y << Q16_SHIFT;
+        p_Odometry->Heading = FIXED_MATH_RAD_TO_BAM(p_Pose->Heading);
+        odometry_publish(p_Odometry);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function integrates one period of encoder ticks and gyro rate, single writer (encoder interrupt)
+ *
+ * @param p_Odometry object of odometry
+ * @param p_LeftTicks encoder ticks of the left side since the last call
+ * @param p_RightTicks encoder ticks of the right side since the last call
+ * @param p_YawRate gyro yaw rate in rad/s (Q16), positive turns left
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_update(odometry_t *p_Odometry, int32_t p_LeftTicks, int32_t p_RightTicks, q16_t p_YawRate)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Odometry)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        /* heading increment, gyro and encoder estimates blended by GyroWeight (binary angle) */
+        int32_t l_EncoderTurn = (p_RightTicks - p_LeftTicks) * p_Odometry->EncoderTurn;
+        int32_t l_GyroTurn = (int32_t)(((int64_t)p_YawRate * p_Odometry->GyroTurn) >> Q16_SHIFT);
+        int32_t l_Turn = l_EncoderTurn +
+                         (int32_t)(((int64_t)(l_GyroTurn - l_EncoderTurn) * p_Odometry->GyroWeight) >> Q16_SHIFT);
+
+        /* travel along the mean heading of the period (second order accurate for arcs) */
+        int64_t l_Distance = ((int64_t)(p_LeftTicks + p_RightTicks) * p_Odometry->MetersPerTick) >> 1;
+        uint32_t l_MidHeading = p_Odometry->Heading + (uint32_t)(l_Turn / 2);
+
+        p_Odometry->X += (l_Distance * fixed_math_cos(l_MidHeading)) >> Q16_SHIFT;
+        p_Odometry->Y += (l_Distance * fixed_math_sin(l_MidHeading)) >> Q16_SHIFT;
+        p_Odometry->Heading += (uint32_t)l_Turn;
+
+        odometry_publish(p_Odometry);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function copies a consistent pose, can be called from any context below the writer priority
+ *
+ * @param p_Odometry object of odometry
+ * @param p_Pose destination of the pose
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t odometry_get_pose(const odometry_t *p_Odometry, odometry_pose_t *p_Pose)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Sequence = ZERO;
+    if ((NULL == p_Odometry) || (NULL == p_Pose))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // retry while the writer is inside the pose or has finished a new one during the copy
+        do
+        {
+            l_Sequence = p_Odometry->Sequence;
+            __DMB();
+            *p_Pose = p_Odometry->Pose;
+            __DMB();
+        } while ((l_Sequence & 1U) || (l_Sequence != p_Odometry->Sequence));
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief writes the snapshot under the sequence lock (odd sequence = write in progress)
+ *
+ * @param p_Odometry object of odometry
+ */
+static void odometry_publish(odometry_t *p_Odometry)
+{
+    p_Odometry->Sequence++;
+    __DMB();
+    p_Odometry->Pose.X = (q16_t)(p_Odometry->X >> Q16_SHIFT);
+    p_Odometry->Pose.Y = (q16_t)(p_Odometry->Y >> Q16_SHIFT);
+    p_Odometry->Pose.Heading = FIXED_MATH_BAM_TO_RAD(p_Odometry->Heading);
+    __DMB();
+    p_Odometry->Sequence++;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
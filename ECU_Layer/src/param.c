@@ -0,0 +1,482 @@
+/**
+ * @file    param.c
+ * @author  Ahmed Hani
+ * @brief   calibration / tuning values kept in flash as an append only log over two alternating 16 KB sectors
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/param.h"
+#include <string.h>
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define PARAM_MAGIC                 (0x314D5250UL)  // "PRM1", change it when the record layout changes
+#define PARAM_ERASED                (0xFFFFFFFFUL)
+#define PARAM_HEADER_SIZE           (8U)            // magic, generation
+#define PARAM_RECORD_SIZE           (8U)            // tag, value
+#define PARAM_NO_SECTOR             (0xFFU)
+
+#if PARAM_KEYS > 32
+#error "the dirty / present masks hold 32 keys"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define PARAM_WORD(address)         (*(volatile const uint32_t *)(address))
+/* tag of a record, the check catches a tag or value whose programming was cut by a reset */
+#define PARAM_TAG(key, value)       ((uint32_t)(key) | ((~((uint32_t)(key) ^ (value) ^ ((value) >> 16)) & 0xFFFFUL) << 16))
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static uint32_t param_sector_address(uint8_t p_Sector);
+static uint8_t param_sector_blank(uint8_t p_Sector);
+static ecu_status_t param_program(uint32_t p_Address, uint32_t p_First, uint32_t p_Second);
+static ecu_status_t param_erase(uint8_t p_Sector);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static uint32_t ParamValues[PARAM_KEYS];
+static volatile uint32_t ParamPresent = ZERO;       // bit per key stored at least once
+static volatile uint32_t ParamDirty = ZERO;         // bit per key changed in RAM only
+static uint8_t ParamActive = PARAM_NO_SECTOR;       // sector holding the log, 0 = A, 1 = B
+static uint32_t ParamGeneration = ZERO;             // generation of the active sector, the newest sector wins
+static uint32_t ParamWriteOffset = ZERO;            // next free record of the active sector
+static uint8_t ParamSpareBlank = ZERO;              // the other sector is erased and ready for compaction
+static uint8_t ParamCompacting = ZERO;
+static uint32_t ParamCopyKey = ZERO;                // next key copied to the spare sector
+static uint32_t ParamCopyOffset = ZERO;             // next free record of the spare sector
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function finds the newest sector and loads every stored value into the RAM table, then erases the
+ *        spare sector if it is not blank (old code, stale log). call it before watchdog_start(), the erase stalls
+ *        the flash for 250 - 500 ms and is refused once the IWDG runs
+ *
+ * @return ecu_status_t ECU_ERROR if the spare sector could not be erased
+ */
+ecu_status_t param_init(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint8_t l_Valid[2];
+    uint32_t l_Generation[2];
+    ParamPresent = ZERO;
+    ParamDirty = ZERO;
+    ParamCompacting = ZERO;
+    for (uint8_t l_Sector = ZERO; l_Sector < 2U; l_Sector++)
+    {
+        uint32_t l_Address = param_sector_address(l_Sector);
+        l_Valid[l_Sector] = (PARAM_MAGIC == PARAM_WORD(l_Address));
+        l_Generation[l_Sector] = PARAM_WORD(l_Address + 4U);
+    }
+
+    if (l_Valid[0] && l_Valid[1])
+    {
+        // a reset between the end of a compaction and the erase of the old sector, the older one is stale
+        ParamActive = ((int32_t)(l_Generation[1] - l_Generation[0]) > 0) ? 1U : 0U;
+    }
+    else if (l_Valid[0] || l_Valid[1])
+    {
+        ParamActive = l_Valid[1] ? 1U : 0U;
+    }
+    else
+    {
+        ParamActive = PARAM_NO_SECTOR;
+    }
+
+    if (PARAM_NO_SECTOR == ParamActive)
+    {
+        // empty store: sector B is filled by the first compaction once it is erased
+        ParamGeneration = ZERO;
+        ParamSpareBlank = param_sector_blank(1U);
+        ParamActive = 0U;
+        ParamWriteOffset = PARAM_SECTOR_SIZE;
+    }
+    else
+    {
+        uint32_t l_Base = param_sector_address(ParamActive);
+        uint32_t l_Offset = PARAM_HEADER_SIZE;
+        ParamGeneration = l_Generation[ParamActive];
+        while (l_Offset < PARAM_SECTOR_SIZE)
+        {
+            uint32_t l_Tag = PARAM_WORD(l_Base + l_Offset);
+            uint32_t l_Value = PARAM_WORD(l_Base + l_Offset + 4U);
+            if ((PARAM_ERASED == l_Tag) && (PARAM_ERASED == l_Value))
+            {
+                break;
+            }
+            else if ((PARAM_ERASED != l_Tag) && (l_Tag == PARAM_TAG(l_Tag & 0xFFFFUL, l_Value)) &&
+                     ((l_Tag & 0xFFFFUL) < PARAM_KEYS))
+            {
+                ParamValues[l_Tag & 0xFFFFUL] = l_Value;
+                ParamPresent |= (1UL << (l_Tag & 0xFFFFUL));
+            }
+            else
+            {
+                /* Nothing: torn record or key of a newer firmware, the slot stays used */
+            }
+            l_Offset += PARAM_RECORD_SIZE;
+        }
+        ParamWriteOffset = l_Offset;
+        ParamSpareBlank = param_sector_blank(ParamActive ^ 1U);
+    }
+
+    // the only time the erase stall is allowed: the next compaction then always finds its sector ready
+    if ((ZERO == ParamSpareBlank) && (ZERO == watchdog_is_started()))
+    {
+        l_EcuStatus = param_erase(ParamActive ^ 1U);
+        ParamSpareBlank = (ECU_OK == l_EcuStatus);
+    }
+    else
+    {
+        /* Nothing */
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function reads a value from the RAM table
+ *
+ * @param p_Key key of the value
+ * @param p_Value destination, untouched if the key was never stored
+ * @return ecu_status_t ECU_ERROR if the key was never stored (keep the default)
+ */
+ecu_status_t param_get(param_key_t p_Key, uint32_t *p_Value)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Value) || (p_Key >= PARAM_KEYS) || (ZERO == (ParamPresent & (1UL << p_Key))))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        *p_Value = ParamValues[p_Key];
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function changes a value, callable from any context: only the RAM table is written, the flash
+ *        follows in param_service()
+ *
+ * @param p_Key key of the value
+ * @param p_Value new value
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t param_set(param_key_t p_Key, uint32_t p_Value)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Primask = __get_PRIMASK();
+    if (p_Key >= PARAM_KEYS)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        __disable_irq();
+        if ((ZERO == (ParamPresent & (1UL << p_Key))) || (ParamValues[p_Key] != p_Value))
+        {
+            ParamValues[p_Key] = p_Value;
+            ParamPresent |= (1UL << p_Key);
+            ParamDirty |= (1UL << p_Key);
+        }
+        else
+        {
+            /* Nothing: same value, no flash wear */
+        }
+        __set_PRIMASK(l_Primask);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function reads a float value from the RAM table
+ *
+ * @param p_Key key of the value
+ * @param p_Value destination, untouched if the key was never stored
+ * @return ecu_status_t ECU_ERROR if the key was never stored (keep the default)
+ */
+ecu_status_t param_get_float(param_key_t p_Key, float_t *p_Value)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Raw = ZERO;
+    if (NULL == p_Value)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        l_EcuStatus = param_get(p_Key, &l_Raw);
+        if (ECU_OK == l_EcuStatus)
+        {
+            memcpy(p_Value, &l_Raw, sizeof(l_Raw));
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function changes a float value, see param_set()
+ *
+ * @param p_Key key of the value
+ * @param p_Value new value
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t param_set_float(param_key_t p_Key, float_t p_Value)
+{
+    uint32_t l_Raw = ZERO;
+    memcpy(&l_Raw, &p_Value, sizeof(l_Raw));
+    return param_set(p_Key, l_Raw);
+}
+
+/**
+ * @brief this function moves the store one step forward, call it from the background loop: programs one changed
+ *        value, or copies a few values while compacting, or erases the unused sector when allowed
+ *
+ * @param p_AllowErase one when a ~0.5 s stall of the flash is acceptable (vehicle stopped)
+ * @return ecu_status_t ECU_ERROR if the flash reported an error
+ */
+ecu_status_t param_service(uint8_t p_AllowErase)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Primask = __get_PRIMASK();
+    uint8_t l_Spare = ParamActive ^ 1U;
+
+    if (ParamCompacting)
+    {
+        // copy the RAM table, values changed after their copy are dirty again and appended afterwards
+        uint32_t l_Base = param_sector_address(l_Spare);
+        for (uint32_t l_Burst = ZERO; (l_Burst < PARAM_COPY_BURST) && (ParamCopyKey < PARAM_KEYS) &&
+                                      (ECU_OK == l_EcuStatus); ParamCopyKey++)
+        {
+            if (ParamPresent & (1UL << ParamCopyKey))
+            {
+                uint32_t l_Value = ParamValues[ParamCopyKey];
+                l_EcuStatus = param_program(l_Base + ParamCopyOffset, PARAM_TAG(ParamCopyKey, l_Value), l_Value);
+                ParamCopyOffset += PARAM_RECORD_SIZE;
+                l_Burst++;
+            }
+            else
+            {
+                /* Nothing */
+            }
+        }
+
+        if ((ECU_OK == l_EcuStatus) && (ParamCopyKey >= PARAM_KEYS))
+        {
+            // the magic goes last: a reset before it leaves the old sector in charge
+            l_EcuStatus = param_program(l_Base, PARAM_MAGIC, ParamGeneration + 1U);
+            if (ECU_OK == l_EcuStatus)
+            {
+                ParamGeneration++;
+                ParamActive = l_Spare;
+                ParamWriteOffset = ParamCopyOffset;
+                ParamSpareBlank = ZERO;
+                ParamCompacting = ZERO;
+            }
+        }
+        if (ECU_OK != l_EcuStatus)
+        {
+            // the spare is in an unknown state, erase it and start the copy again later
+            ParamSpareBlank = ZERO;
+            ParamCompacting = ZERO;
+            __disable_irq();
+            ParamDirty |= ParamPresent;
+            __set_PRIMASK(l_Primask);
+        }
+    }
+    else if ((ZERO != ParamDirty) && ((ParamWriteOffset + PARAM_RECORD_SIZE) <= PARAM_SECTOR_SIZE))
+    {
+        __disable_irq();
+        uint32_t l_Key = (uint32_t)__builtin_ctz(ParamDirty);
+        uint32_t l_Value = ParamValues[l_Key];
+        ParamDirty &= ~(1UL << l_Key);
+        __set_PRIMASK(l_Primask);
+
+        l_EcuStatus = param_program(param_sector_address(ParamActive) + ParamWriteOffset, PARAM_TAG(l_Key, l_Value),
+                                    l_Value);
+        // a failed slot is skipped, it fails the check at the next boot
+        ParamWriteOffset += PARAM_RECORD_SIZE;
+        if (ECU_OK != l_EcuStatus)
+        {
+            __disable_irq();
+            ParamDirty |= (1UL << l_Key);
+            __set_PRIMASK(l_Primask);
+        }
+    }
+    else if ((ZERO != ParamDirty) && ParamSpareBlank)
+    {
+        // log full: the whole table moves to the spare sector, which clears every pending change
+        __disable_irq();
+        ParamDirty = ZERO;
+        __set_PRIMASK(l_Primask);
+        ParamCompacting = 1U;
+        ParamCopyKey = ZERO;
+        ParamCopyOffset = PARAM_HEADER_SIZE;
+    }
+    else if ((ZERO == ParamSpareBlank) && p_AllowErase)
+    {
+        l_EcuStatus = param_erase(l_Spare);
+        ParamSpareBlank = (ECU_OK == l_EcuStatus);
+    }
+    else
+    {
+        /* Nothing */
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function tells if param_service() has work it can do: a compaction, or changed values with room left
+ *        in the log or a blank spare sector to compact into
+ *
+ * @return uint8_t one while param_service() can make progress
+ */
+uint8_t param_is_pending(void)
+{
+    return (ParamCompacting || ((ZERO != ParamDirty) &&
+            (((ParamWriteOffset + PARAM_RECORD_SIZE) <= PARAM_SECTOR_SIZE) || ParamSpareBlank)));
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief first address of a store sector
+ *
+ * @param p_Sector 0 = A, 1 = B
+ * @return uint32_t address of the sector
+ */
+static uint32_t param_sector_address(uint8_t p_Sector)
+{
+    return (ZERO == p_Sector) ? PARAM_SECTOR_A_ADDRESS : PARAM_SECTOR_B_ADDRESS;
+}
+
+/**
+ * @brief checks that a sector is fully erased, 4096 word reads (~0.2 ms)
+ *
+ * @param p_Sector 0 = A, 1 = B
+ * @return uint8_t one if every word is erased
+ */
+static uint8_t param_sector_blank(uint8_t p_Sector)
+{
+    uint32_t l_Base = param_sector_address(p_Sector);
+    uint32_t l_Offset = ZERO;
+    while ((l_Offset < PARAM_SECTOR_SIZE) && (PARAM_ERASED == PARAM_WORD(l_Base + l_Offset)))
+    {
+        l_Offset += 4U;
+    }
+    return (l_Offset >= PARAM_SECTOR_SIZE);
+}
+
+/**
+ * @brief programs a record, the second word first so the first one (tag or magic) commits it.
+ *        a word given as PARAM_ERASED is left as it is
+ *
+ * @param p_Address address of the first word
+ * @param p_First word committing the record
+ * @param p_Second payload word
+ * @return ecu_status_t status of the operation
+ */
+static ecu_status_t param_program(uint32_t p_Address, uint32_t p_First, uint32_t p_Second)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    HAL_FLASH_Unlock();
+    if ((PARAM_ERASED != p_Second) &&
+        (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, p_Address + 4U, p_Second) != HAL_OK))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else if ((PARAM_ERASED != p_First) &&
+             (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, p_Address, p_First) != HAL_OK))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        /* Nothing */
+    }
+    HAL_FLASH_Lock();
+    return l_EcuStatus;
+}
+
+/**
+ * @brief erases a store sector, the flash stalls every fetch for the whole erase (250 - 500 ms). refused once the
+ *        IWDG runs: the supervisor could not kick it and the MCU would reset in the middle of the erase
+ *
+ * @param p_Sector 0 = A, 1 = B
+ * @return ecu_status_t status of the operation
+ */
+static ecu_status_t param_erase(uint8_t p_Sector)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    FLASH_EraseInitTypeDef l_Erase = {0};
+    uint32_t l_SectorError = ZERO;
+    l_Erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    l_Erase.Sector = (ZERO == p_Sector) ? FLASH_SECTOR_1 : FLASH_SECTOR_2;
+    l_Erase.NbSectors = 1U;
+    l_Erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    if (watchdog_is_started())
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        HAL_FLASH_Unlock();
+        if ((HAL_FLASHEx_Erase(&l_Erase, &l_SectorError) != HAL_OK) || (0xFFFFFFFFUL != l_SectorError) ||
+            (ZERO == param_sector_blank(p_Sector)))
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        HAL_FLASH_Lock();
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,354 @@
+/**
+ * @file    parking.c
+ * @author  Ahmed Hani
+ * @brief   parking assist, measures a parallel gap with a side range sensor and odometry then reverses into it
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/parking.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define PARKING_BAM_TO_RAD          (1.462918079e-9f)   // 2 pi / 2^32
+#define PARKING_UNKNOWN             (-1.0f)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static ecu_status_t parking_plan(parking_t *p_Parking);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the parking assist in idle
+ *
+ * @param p_Parking object of parking assist
+ * @param p_Config tuning of the parking assist
+ * @param p_Arbiter arbiter receiving the twist
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_init(parking_t *p_Parking, const parking_config_t *p_Config, arbiter_t *p_Arbiter)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Parking) || (NULL == p_Config) || (NULL == p_Arbiter) || (p_Config->VehicleWidth <= 0.0f) ||
+        (p_Config->GapDepth <= 0.0f) || (p_Config->GapLength <= 0.0f) || (p_Config->TurnRadius <= 0.0f) ||
+        (p_Config->SearchSpeed <= 0.0f) || (p_Config->ManeuverSpeed <= 0.0f) || (p_Config->HeadingGain < 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Parking, ZERO, sizeof(parking_t));
+        p_Parking->Config = *p_Config;
+        p_Parking->Arbiter = p_Arbiter;
+        p_Parking->State = PARKING_IDLE;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function starts searching a gap, the car must be driving parallel to the parked cars
+ *
+ * @param p_Parking object of parking assist
+ * @param p_Pose current pose from the odometry
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_start(parking_t *p_Parking, const odometry_pose_t *p_Pose)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Parking) || (NULL == p_Pose))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Parking->OriginX = Q16_TO_FLOAT(p_Pose->X);
+        p_Parking->OriginY = Q16_TO_FLOAT(p_Pose->Y);
+        p_Parking->OriginHeading = FIXED_MATH_RAD_TO_BAM(p_Pose->Heading);
+        p_Parking->AlongCos = Q16_TO_FLOAT(fixed_math_cos(p_Parking->OriginHeading));
+        p_Parking->AlongSin = Q16_TO_FLOAT(fixed_math_sin(p_Parking->OriginHeading));
+        p_Parking->Depth = PARKING_UNKNOWN;
+        p_Parking->GapStart = PARKING_UNKNOWN;
+        p_Parking->State = PARKING_SEARCHING;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function withdraws the twist of the assist (the arbiter brakes) and returns to idle
+ *
+ * @param p_Parking object of parking assist
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_cancel(parking_t *p_Parking)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Parking)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Parking->State = PARKING_IDLE;
+        l_EcuStatus = arbiter_release(p_Parking->Arbiter, MODE_OWNER_PARKING);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function runs one step of the assist and submits the twist to the arbiter
+ *
+ * @param p_Parking object of parking assist
+ * @param p_SideRange filtered range of the side sensor
+ * @param p_Pose current pose from the odometry
+ * @param p_Aeb emergency brake, nothing is commanded while it is braking (can be NULL)
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t parking_step(parking_t *p_Parking, const range_filter_t *p_SideRange, const odometry_pose_t *p_Pose,
+                          const aeb_t *p_Aeb)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Parking) || (NULL == p_SideRange) || (NULL == p_Pose))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        const parking_config_t *l_Config = &p_Parking->Config;
+        uint8_t l_Braking = aeb_is_braking(p_Aeb);
+        float_t l_X = Q16_TO_FLOAT(p_Pose->X);
+        float_t l_Y = Q16_TO_FLOAT(p_Pose->Y);
+        // heading relative to the road, the binary angle difference wraps correctly
+        int32_t l_HeadingBam = (int32_t)(FIXED_MATH_RAD_TO_BAM(p_Pose->Heading) - p_Parking->OriginHeading);
+        float_t l_Heading = (float_t)l_HeadingBam * PARKING_BAM_TO_RAD;
+        float_t l_Along = ((l_X - p_Parking->OriginX) * p_Parking->AlongCos) +
+                          ((l_Y - p_Parking->OriginY) * p_Parking->AlongSin);
+        float_t l_Speed = 0.0f;
+        float_t l_YawRate = 0.0f;
+        uint8_t l_Drive = ZERO;
+
+        switch (p_Parking->State)
+        {
+            case PARKING_SEARCHING:
+            {
+                float_t l_Range = Q16_TO_FLOAT(p_SideRange->Range);
+                if (l_Range > l_Config->GapDepth)
+                {
+                    if (p_Parking->GapStart < 0.0f)
+                    {
+                        p_Parking->GapStart = l_Along;
+                    }
+                    else if ((l_Along - p_Parking->GapStart) >= l_Config->GapLength)
+                    {
+                        if (ECU_OK == parking_plan(p_Parking))
+                        {
+                            p_Parking->State = PARKING_APPROACH;
+                        }
+                        else
+                        {
+                            p_Parking->State = PARKING_ABORTED;
+                        }
+                    }
+                    else
+                    {
+                        /* Nothing */
+                    }
+                }
+                else
+                {
+                    // a parked car, its side gives the line the car has to reach
+                    p_Parking->GapStart = PARKING_UNKNOWN;
+                    p_Parking->Depth = (p_Parking->Depth < 0.0f) ? l_Range :
+                                       (p_Parking->Depth + (PARKING_DEPTH_FILTER * (l_Range - p_Parking->Depth)));
+                }
+                l_Speed = l_Config->SearchSpeed;
+                l_YawRate = -l_Config->HeadingGain * l_Heading;
+                l_Drive = (PARKING_ABORTED != p_Parking->State);
+                break;
+            }
+            case PARKING_APPROACH:
+            {
+                if (l_Along >= p_Parking->ReverseStart)
+                {
+                    p_Parking->State = PARKING_REVERSE;
+                    p_Parking->Travelled = 0.0f;
+                    p_Parking->LastX = l_X;
+                    p_Parking->LastY = l_Y;
+                }
+                else
+                {
+                    l_Speed = l_Config->SearchSpeed;
+                    l_YawRate = -l_Config->HeadingGain * l_Heading;
+                    l_Drive = 1;
+                }
+                break;
+            }
+            case PARKING_REVERSE:
+            {
+                float_t l_Dx = l_X - p_Parking->LastX;
+                float_t l_Dy = l_Y - p_Parking->LastY;
+                p_Parking->Travelled += sqrtf(fmaf(l_Dx, l_Dx, l_Dy * l_Dy));
+                p_Parking->LastX = l_X;
+                p_Parking->LastY = l_Y;
+
+                if (p_Parking->Travelled >= p_Parking->PathLength)
+                {
+                    p_Parking->State = PARKING_DONE;
+                }
+                else
+                {
+                    // evenly spaced points: the index is a multiply, no search
+                    float_t l_Position = p_Parking->Travelled * p_Parking->PointsPerMeter;
+                    uint32_t l_Index = (uint32_t)l_Position;
+                    l_Index = (l_Index > (PARKING_PATH_POINTS - 2)) ? (PARKING_PATH_POINTS - 2) : l_Index;
+                    float_t l_Fraction = l_Position - (float_t)l_Index;
+                    float_t l_Reference = fmaf(l_Fraction,
+                                               p_Parking->PathHeading[l_Index + 1] - p_Parking->PathHeading[l_Index],
+                                               p_Parking->PathHeading[l_Index]);
+
+                    l_Speed = -l_Config->ManeuverSpeed;
+                    l_YawRate = fmaf(p_Parking->PathCurvature[l_Index], l_Config->ManeuverSpeed,
+                                     l_Config->HeadingGain * (l_Reference - l_Heading));
+                    l_Drive = 1;
+                }
+                break;
+            }
+            default:
+            {
+                /* Nothing */
+                break;
+            }
+        }
+
+        // the emergency brake owns the motors while it brakes, the maneuver resumes from where odometry says
+        if (ZERO == l_Braking)
+        {
+            if (l_Drive)
+            {
+                arbiter_command_t l_Command = { l_Speed, l_YawRate };
+                l_EcuStatus = arbiter_submit(p_Parking->Arbiter, MODE_OWNER_PARKING, &l_Command,
+                                             ARBITER_PRIORITY_ASSIST, PARKING_COMMAND_TTL_MS);
+            }
+            else if (PARKING_IDLE != p_Parking->State)
+            {
+                l_EcuStatus = arbiter_release(p_Parking->Arbiter, MODE_OWNER_PARKING);
+            }
+            else
+            {
+                /* Nothing */
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief tabulates the reverse path: two arcs of opposite turn moving the car sideways into the gap,
+ *        runs once per maneuver so the trigonometry here is not a concern
+ *
+ * @param p_Parking object of parking assist
+ * @return ecu_status_t ECU_ERROR if no parked car was seen or the gap is too deep for the turn radius
+ */
+static ecu_status_t parking_plan(parking_t *p_Parking)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    const parking_config_t *l_Config = &p_Parking->Config;
+    float_t l_Radius = l_Config->TurnRadius;
+    // from the car center to the center line of the parked cars
+    float_t l_Lateral = p_Parking->Depth + l_Config->VehicleWidth;
+    float_t l_CosAngle = 1.0f - (l_Lateral / (2.0f * l_Radius));
+
+    if ((p_Parking->Depth < 0.0f) || (l_CosAngle <= 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        float_t l_Angle = acosf(l_CosAngle);
+        float_t l_Arc = l_Radius * l_Angle;
+        float_t l_Sign = (PARKING_SIDE_RIGHT == l_Config->Side) ? 1.0f : -1.0f;
+        float_t l_Step = 0.0f;
+
+        p_Parking->PathLength = 2.0f * l_Arc;
+        p_Parking->PointsPerMeter = (float_t)(PARKING_PATH_POINTS - 1) / p_Parking->PathLength;
+        l_Step = p_Parking->PathLength / (float_t)(PARKING_PATH_POINTS - 1);
+        // the path ends centered in the gap, it starts its longitudinal extent further ahead
+        p_Parking->ReverseStart = p_Parking->GapStart + (0.5f * l_Config->GapLength) +
+                                  (2.0f * l_Radius * sinf(l_Angle));
+
+        // reversing, the rear swings towards the gap while the heading turns away from it, then back
+        for (uint8_t l_Index = ZERO; l_Index < PARKING_PATH_POINTS; l_Index++)
+        {
+            float_t l_Distance = (float_t)l_Index * l_Step;
+            if (l_Distance <= l_Arc)
+            {
+                p_Parking->PathHeading[l_Index] = l_Sign * (l_Distance / l_Radius);
+                p_Parking->PathCurvature[l_Index] = l_Sign / l_Radius;
+            }
+            else
+            {
+                p_Parking->PathHeading[l_Index] = l_Sign * ((p_Parking->PathLength - l_Distance) / l_Radius);
+                p_Parking->PathCurvature[l_Index] = -l_Sign / l_Radius;
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,388 @@
+/**
+ * @file    power.c
+ * @author  Ahmed Hani
+ * @brief   power / performance profiles switched at run time (bus dividers on the running PLL) and STOP mode
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/power.h"
+#include "../inc/ecu.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define POWER_DIVIDER_MASK          (RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2)
+#define POWER_MHZ                   (1000000UL)
+#define POWER_RTC_KEY_1             (0xCAU)
+#define POWER_RTC_KEY_2             (0x53U)
+#define POWER_RTC_LOCK              (0xFFU)
+#define POWER_RTC_WAKEUP_DIV        (16UL)          // WUCKSEL = 000, RTCCLK / 16
+#define POWER_RTC_WAKEUP_TICKS      ((POWER_STOP_REFRESH_MS * (WATCHDOG_LSI_HZ / POWER_RTC_WAKEUP_DIV)) / 1000UL)
+#define POWER_EXTI_RTC_WAKEUP       (1UL << 22)     // EXTI line 22
+
+#if (POWER_RTC_WAKEUP_TICKS > 0x10000UL)
+#error "POWER_STOP_REFRESH_MS does not fit the 16 bit RTC wake up counter"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define POWER_HCLK(sysclk, cfgr)    ((sysclk) >> AHBPrescTable[((cfgr) & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos])
+#define POWER_PCLK1(hclk, cfgr)     ((hclk) >> APBPrescTable[((cfgr) & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos])
+#define POWER_PCLK2(hclk, cfgr)     ((hclk) >> APBPrescTable[((cfgr) & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos])
+/* the timers of a divided APB bus run at twice its clock */
+#define POWER_TIMER_CLOCK(hclk, cfgr) (POWER_PCLK1(hclk, cfgr) << (((cfgr) & RCC_CFGR_PPRE1_2) ? 1U : 0U))
+/* clears the RTC wake up flag, the other flags are written with their reset value (HAL __HAL_RTC_..._CLEAR_FLAG) */
+#define POWER_RTC_CLEAR_WAKEUP()    \
+    (RTC->ISR = (~(RTC_ISR_WUTF | RTC_ISR_INIT) & 0x0001FFFFUL) | (RTC->ISR & RTC_ISR_INIT))
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void power_write_clocks(uint32_t p_Hclk, uint32_t p_Dividers);
+static void power_rescale_timer(TIM_TypeDef *p_Timer, uint32_t p_NewMhz, uint32_t p_OldMhz);
+static ecu_status_t power_start_wakeup(void);
+static void power_stop_wakeup(void);
+static uint8_t power_irq_pending(void);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+/* AHB and APB dividers of every profile, everything else is derived from them */
+static const uint32_t PowerDividers[POWER_PROFILES] =
+{
+    [POWER_PROFILE_DRIVE]   = RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE1_DIV2 | RCC_CFGR_PPRE2_DIV1,
+    [POWER_PROFILE_PARKED]  = RCC_CFGR_HPRE_DIV2 | RCC_CFGR_PPRE1_DIV1 | RCC_CFGR_PPRE2_DIV1,
+};
+
+/* APB1 timers whose period and compares follow their clock */
+static TIM_TypeDef *const PowerTimers[] = { TIM4 };
+
+static power_profile_t PowerProfile = POWER_PROFILE_DRIVE;      // SystemClock_Config sets the drive dividers
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function switches to a run profile, safe while the motors and the sensors run
+ *
+ * @param p_Profile profile to run
+ * @return ecu_status_t ECU_ERROR for an unknown profile or one that would change PCLK1
+ */
+ecu_status_t power_set_profile(power_profile_t p_Profile)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Sysclk = HAL_RCC_GetSysClockFreq();
+    uint32_t l_OldCfgr = RCC->CFGR;
+
+    if (p_Profile >= POWER_PROFILES)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_NewCfgr = (l_OldCfgr & ~POWER_DIVIDER_MASK) | PowerDividers[p_Profile];
+        uint32_t l_Hclk = POWER_HCLK(l_Sysclk, l_NewCfgr);
+        uint32_t l_OldTimerMhz = POWER_TIMER_CLOCK(POWER_HCLK(l_Sysclk, l_OldCfgr), l_OldCfgr) / POWER_MHZ;
+        uint32_t l_NewTimerMhz = POWER_TIMER_CLOCK(l_Hclk, l_NewCfgr) / POWER_MHZ;
+        uint32_t l_AdcPrescaler = (POWER_PCLK2(l_Hclk, l_NewCfgr) / POWER_ADC_CLOCK / 2U) - 1U;
+        uint32_t l_Period = (TIMER_AUTO_RELOAD_VAL * l_NewTimerMhz) / (POWER_NOMINAL_TIMER_CLOCK / POWER_MHZ);
+
+        // a profile must not change PCLK1 (and the HSE must run), USART2 and I2C1 are not reprogrammed
+        if (POWER_PCLK1(l_Hclk, l_NewCfgr) != POWER_APB1_CLOCK)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            uint32_t l_Primask = __get_PRIMASK();
+
+            // no interrupt may see the new clock with the old periods, the AEB writes compares from its handler
+            __disable_irq();
+            power_write_clocks(l_Hclk, PowerDividers[p_Profile]);
+            for (uint8_t l_Index = ZERO; l_Index < (sizeof(PowerTimers) / sizeof(PowerTimers[0])); l_Index++)
+            {
+                power_rescale_timer(PowerTimers[l_Index], l_NewTimerMhz, l_OldTimerMhz);
+            }
+            (void)motor_set_pwm_period(l_Period);
+            ADC->CCR = (ADC->CCR & ~ADC_CCR_ADCPRE_Msk) | (l_AdcPrescaler << ADC_CCR_ADCPRE_Pos);
+            PowerProfile = p_Profile;
+            __set_PRIMASK(l_Primask);
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function tells the running profile
+ *
+ * @return power_profile_t profile set by the last power_set_profile()
+ */
+power_profile_t power_get_profile(void)
+{
+    return PowerProfile;
+}
+
+/**
+ * @brief this function stops every clock until an EXTI interrupt (IMU data ready, echo, button ...), the handler
+ *        runs after the clocks of the running profile are back. USART2 cannot wake the core. while the IWDG runs
+ *        its timeout is stretched and the RTC wakes the core every POWER_STOP_REFRESH_MS to kick it, the core
+ *        goes straight back to STOP when nothing else is pending
+ *
+ * @return ecu_status_t ECU_ERROR if a motor is still driven (its output would freeze), a supervised task is late,
+ *         the RTC runs on another clock than the LSI or the HSE did not restart
+ */
+ecu_status_t power_enter_stop(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint8_t l_Watchdog = watchdog_is_started();
+
+    // CCR4 is the line sensor ADC trigger, not a motor
+    if ((TIM4->CR1 & TIM_CR1_CEN) && (TIM4->CCR1 | TIM4->CCR2 | TIM4->CCR3))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else if (l_Watchdog && ((ECU_OK != watchdog_set_stop(1U)) || (ECU_OK != power_start_wakeup())))
+    {
+        // a late task or a foreign RTC clock: the normal timeout is back, the supervisor decides
+        (void)watchdog_set_stop(ZERO);
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_Primask = __get_PRIMASK();
+        uint32_t l_Sysclk = ZERO;
+        uint8_t l_RefreshOnly = ZERO;
+
+        // masked: WFI still wakes on a pending interrupt but its handler waits for the clocks below
+        __disable_irq();
+        HAL_SuspendTick();
+        do
+        {
+#if (POWER_STOP_DEEP)
+            HAL_PWREx_EnableFlashPowerDown();
+            HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+#else
+            HAL_PWREx_DisableFlashPowerDown();
+            HAL_PWR_EnterSTOPMode(PWR_MAINREGULATOR_ON, PWR_STOPENTRY_WFI);
+#endif
+            // an RTC wake up alone only kicks the IWDG, on HSI, and goes back to sleep
+            l_RefreshOnly = ZERO;
+            if (l_Watchdog && (RTC->ISR & RTC_ISR_WUTF))
+            {
+                power_wakeup_irq();
+                NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+                l_RefreshOnly = (ZERO == power_irq_pending()) && (ECU_OK == watchdog_set_stop(1U));
+            }
+            else
+            {
+                /* Nothing */
+            }
+        } while (l_RefreshOnly);
+
+        if (l_Watchdog)
+        {
+            power_stop_wakeup();
+            (void)watchdog_set_stop(ZERO);
+        }
+        else
+        {
+            /* Nothing */
+        }
+
+        // the core wakes up on HSI, same PLL as at boot then the dividers of the running profile
+        l_EcuStatus = boot_fast_clock();
+        l_Sysclk = HAL_RCC_GetSysClockFreq();
+        power_write_clocks(POWER_HCLK(l_Sysclk, PowerDividers[PowerProfile]), PowerDividers[PowerProfile]);
+        HAL_ResumeTick();
+        __set_PRIMASK(l_Primask);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function clears the RTC wake up, call it from RTC_WKUP_IRQHandler. power_enter_stop clears its own
+ *        wake ups before the interrupts are unmasked, the handler only runs for a stray one
+ */
+void power_wakeup_irq(void)
+{
+    POWER_RTC_CLEAR_WAKEUP();
+    EXTI->PR = POWER_EXTI_RTC_WAKEUP;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief sets the bus dividers with the flash wait states raised before and lowered after, then the SysTick reload
+ *
+ * @param p_Hclk HCLK in Hz once the dividers are set
+ * @param p_Dividers HPRE, PPRE1 and PPRE2 bits
+ */
+static void power_write_clocks(uint32_t p_Hclk, uint32_t p_Dividers)
+{
+    uint32_t l_Latency = (p_Hclk - 1U) / POWER_WAIT_STATE_CLOCK;
+
+    if (l_Latency > (FLASH->ACR & FLASH_ACR_LATENCY))
+    {
+        FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | l_Latency;
+        while ((FLASH->ACR & FLASH_ACR_LATENCY) != l_Latency)
+        {
+            /* Nothing */
+        }
+    }
+
+    // HPRE and PPRE1 change in one write, PCLK1 never leaves its 42 MHz
+    RCC->CFGR = (RCC->CFGR & ~POWER_DIVIDER_MASK) | p_Dividers;
+
+    if (l_Latency < (FLASH->ACR & FLASH_ACR_LATENCY))
+    {
+        FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | l_Latency;
+    }
+
+    SystemCoreClockUpdate();
+    (void)HAL_InitTick(uwTickPrio);
+}
+
+/**
+ * @brief scales the period and the compares of a running timer to its new clock and reloads them at once, the
+ *        cycle in progress is cut short (an update also resets the timers slaved to it)
+ *
+ * @param p_Timer timer on APB1
+ * @param p_NewMhz timer clock after the switch in MHz
+ * @param p_OldMhz timer clock before the switch in MHz
+ */
+static void power_rescale_timer(TIM_TypeDef *p_Timer, uint32_t p_NewMhz, uint32_t p_OldMhz)
+{
+    if ((p_Timer->CR1 & TIM_CR1_CEN) && (p_NewMhz != p_OldMhz))
+    {
+        p_Timer->ARR = (((p_Timer->ARR + 1U) * p_NewMhz) / p_OldMhz) - 1U;
+        p_Timer->CCR1 = (p_Timer->CCR1 * p_NewMhz) / p_OldMhz;
+        p_Timer->CCR2 = (p_Timer->CCR2 * p_NewMhz) / p_OldMhz;
+        p_Timer->CCR3 = (p_Timer->CCR3 * p_NewMhz) / p_OldMhz;
+        p_Timer->CCR4 = (p_Timer->CCR4 * p_NewMhz) / p_OldMhz;
+        p_Timer->EGR = TIM_EGR_UG;
+    }
+}
+
+/**
+ * @brief starts the RTC wake up timer on the LSI (already running for the IWDG), every POWER_STOP_REFRESH_MS
+ *        through EXTI line 22, which wakes the core from STOP
+ *
+ * @return ecu_status_t ECU_ERROR if the RTC was set on another clock by an earlier firmware (only a backup domain
+ *         reset can change it)
+ */
+static ecu_status_t power_start_wakeup(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    PWR->CR |= PWR_CR_DBP;
+    if (ZERO == (RCC->BDCR & RCC_BDCR_RTCSEL))
+    {
+        RCC->BDCR |= RCC_BDCR_RTCSEL_1;
+    }
+    else
+    {
+        /* Nothing */
+    }
+
+    if ((RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_BDCR_RTCSEL_1)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        RCC->BDCR |= RCC_BDCR_RTCEN;
+        RTC->WPR = POWER_RTC_KEY_1;
+        RTC->WPR = POWER_RTC_KEY_2;
+        RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+        while (ZERO == (RTC->ISR & RTC_ISR_WUTWF))
+        {
+            /* Nothing */
+        }
+        RTC->WUTR = POWER_RTC_WAKEUP_TICKS - 1U;
+        RTC->CR = (RTC->CR & ~RTC_CR_WUCKSEL) | RTC_CR_WUTIE | RTC_CR_WUTE;
+        RTC->WPR = POWER_RTC_LOCK;
+
+        power_wakeup_irq();
+        EXTI->RTSR |= POWER_EXTI_RTC_WAKEUP;
+        EXTI->IMR |= POWER_EXTI_RTC_WAKEUP;
+        NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+        NVIC_EnableIRQ(RTC_WKUP_IRQn);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief stops the RTC wake up timer and its interrupt
+ */
+static void power_stop_wakeup(void)
+{
+    RTC->WPR = POWER_RTC_KEY_1;
+    RTC->WPR = POWER_RTC_KEY_2;
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    RTC->WPR = POWER_RTC_LOCK;
+    EXTI->IMR &= ~POWER_EXTI_RTC_WAKEUP;
+    NVIC_DisableIRQ(RTC_WKUP_IRQn);
+    power_wakeup_irq();
+    NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+}
+
+/**
+ * @brief tells if an enabled interrupt is pending, i.e. something else than the RTC woke the core
+ *
+ * @return uint8_t one if an interrupt waits for its handler
+ */
+static uint8_t power_irq_pending(void)
+{
+    uint8_t l_Pending = ZERO;
+    for (uint8_t l_Word = ZERO; l_Word < (uint8_t)(((uint32_t)FPU_IRQn + 32U) / 32U); l_Word++)
+    {
+        l_Pending |= (ZERO != (NVIC->ISPR[l_Word] & NVIC->ISER[l_Word]));
+    }
+    return l_Pending;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
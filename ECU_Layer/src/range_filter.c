@@ -0,0 +1,208 @@
+/**
+ * @file    range_filter.c
+ * @author  Ahmed Hani
+ * @brief   fixed point filtering for range streams (ultrasonic / ToF), sliding median followed by alpha-beta tracker
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/range_filter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define MM_TO_Q16_METER_SCALE   (4294967LL)     // 2^32 / 1000, see range_mm_to_q16()
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* compare exchange of the sorting network, compiles to cmp + two conditional moves */
+#define SORT_PAIR(a, b)                             \
+    do                                              \
+    {                                               \
+        uint16_t l_Min = ((a) < (b)) ? (a) : (b);   \
+        uint16_t l_Max = ((a) < (b)) ? (b) : (a);   \
+        (a) = l_Min;                                \
+        (b) = l_Max;                                \
+    } while (0)
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+ECU_RAMFUNC static inline uint16_t range_median(const uint16_t *p_Window);
+ECU_RAMFUNC static inline q16_t range_mm_to_q16(uint16_t p_RangeMm);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the range filter, the only place that uses float math
+ *
+ * @param p_Filter object of range filter
+ * @param p_Alpha position gain of the tracker (0 < alpha <= 1)
+ * @param p_Beta velocity gain of the tracker (0 < beta <= 2)
+ * @param p_SamplePeriod time between two samples in seconds
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t range_filter_init(range_filter_t *p_Filter, float_t p_Alpha, float_t p_Beta, float_t p_SamplePeriod)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Filter) || (p_Alpha <= 0.0f) || (p_Alpha > 1.0f) ||
+        (p_Beta <= 0.0f) || (p_Beta > 2.0f) || (p_SamplePeriod <= 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Filter, ZERO, sizeof(range_filter_t));
+        p_Filter->Alpha = Q16_FROM_FLOAT(p_Alpha);
+        // the division by the period is done once here instead of every sample
+        p_Filter->BetaOverDt = Q16_FROM_FLOAT(p_Beta / p_SamplePeriod);
+        p_Filter->SamplePeriod = Q16_FROM_FLOAT(p_SamplePeriod);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function pushes one raw reading through the median and the tracker, constant time
+ *
+ * @param p_Filter object of range filter
+ * @param p_RawRangeMm raw reading in mm, zero means no echo
+ * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t range_filter_update(range_filter_t *p_Filter, uint16_t p_RawRangeMm)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Filter)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // no echo or out of range reading is treated as free space
+        if ((ZERO == p_RawRangeMm) || (p_RawRangeMm > RANGE_FILTER_MAX_RANGE_MM))
+        {
+            p_RawRangeMm = RANGE_FILTER_MAX_RANGE_MM;
+        }
+
+        if (ZERO == p_Filter->Initialized)
+        {
+            // seed the whole window and the tracker with the first reading so no start-up branch is needed later
+            for (uint8_t l_Index = ZERO; l_Index < RANGE_FILTER_MEDIAN_WINDOW; l_Index++)
+            {
+                p_Filter->Window[l_Index] = p_RawRangeMm;
+            }
+            p_Filter->Range = range_mm_to_q16(p_RawRangeMm);
+            p_Filter->ClosingSpeed = ZERO;
+            p_Filter->Initialized = 1;
+        }
+        else
+        {
+            p_Filter->Window[p_Filter->WindowIndex] = p_RawRangeMm;
+            p_Filter->WindowIndex++;
+            if (RANGE_FILTER_MEDIAN_WINDOW == p_Filter->WindowIndex)
+            {
+                p_Filter->WindowIndex = ZERO;
+            }
+
+            q16_t l_Measured = range_mm_to_q16(range_median(p_Filter->Window));
+
+            // predict, closing speed is the negative of the range rate
+            q16_t l_Predicted = p_Filter->Range - Q16_MUL(p_Filter->ClosingSpeed, p_Filter->SamplePeriod);
+            q16_t l_Residual = l_Measured - l_Predicted;
+
+            // correct
+            p_Filter->Range = l_Predicted + Q16_MUL(p_Filter->Alpha, l_Residual);
+            p_Filter->ClosingSpeed -= Q16_MUL(p_Filter->BetaOverDt, l_Residual);
+        }
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief median of the window using a fixed sorting network on a local copy (no data dependent loops)
+ *
+ * @param p_Window window of raw samples
+ * @return uint16_t median sample
+ */
+ECU_RAMFUNC static inline uint16_t range_median(const uint16_t *p_Window)
+{
+#if (RANGE_FILTER_MEDIAN_WINDOW == 5)
+    uint16_t l_S0 = p_Window[0], l_S1 = p_Window[1], l_S2 = p_Window[2], l_S3 = p_Window[3], l_S4 = p_Window[4];
+    SORT_PAIR(l_S0, l_S1);
+    SORT_PAIR(l_S3, l_S4);
+    SORT_PAIR(l_S0, l_S3);
+    SORT_PAIR(l_S1, l_S4);
+    SORT_PAIR(l_S1, l_S2);
+    SORT_PAIR(l_S2, l_S3);
+    SORT_PAIR(l_S1, l_S2);
+    return l_S2;
+#else
+    uint16_t l_S0 = p_Window[0], l_S1 = p_Window[1], l_S2 = p_Window[2];
+    SORT_PAIR(l_S0, l_S1);
+    SORT_PAIR(l_S1, l_S2);
+    SORT_PAIR(l_S0, l_S1);
+    return l_S1;
+#endif
+}
+
+/**
+ * @brief converts mm to meters in Q16 with a multiply instead of a divide by 1000
+ *
+ * @param p_RangeMm range in mm
+ * @return q16_t range in meters
+ */
+ECU_RAMFUNC static inline q16_t range_mm_to_q16(uint16_t p_RangeMm)
+{
+    return (q16_t)(((int64_t)p_RangeMm * MM_TO_Q16_METER_SCALE) >> Q16_SHIFT);
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,189 @@
+/**
+ * @file    range_sensor.c
+ * @author  Ahmed Hani
+ * @brief   forward ultrasonic range sensor (HC-SR04 type), echo measured by TIM2 input capture
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/range_sensor.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define RANGE_SENSOR_HALF_SOUND_MM_S    (171500UL)  // 343 m/s at 20 C, out and back
+#define RANGE_SENSOR_SCALE_SHIFT        (10)        // mm per tick in Q20 = (speed << 10) / (clock >> 10)
+#define RANGE_SENSOR_IC_TI1             (1)         // CCxS = 01, ICx on TI1 (CH1)
+#define RANGE_SENSOR_IC_TI1_INDIRECT    (2)         // CCxS = 10, IC2 on TI1
+#define RANGE_SENSOR_IC_FILTER          (3)         // ICxF = 0011, 8 samples at the timer clock (~0.1 us)
+#define RANGE_SENSOR_OC_PWM1            (6)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static range_sensor_callback_t RangeSensorCallback = NULL;
+static volatile uint32_t RangeSensorCount = ZERO;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures PA15, PB10 and TIM2 then starts triggering
+ *
+ * @param p_Callback called with every echo from the capture interrupt
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t range_sensor_init(range_sensor_callback_t p_Callback)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    GPIO_InitTypeDef l_GpioInit = {0};
+    uint32_t l_TicksPerUs = SystemCoreClock / 1000000UL;
+
+    if (NULL == p_Callback)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        RangeSensorCallback = p_Callback;
+        RangeSensorCount = ZERO;
+        (void)cycle_counter_init();
+
+        /* PA15 echo (TIM2 CH1, free with SWD), PB10 trigger (TIM2 CH3) */
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        __HAL_RCC_GPIOB_CLK_ENABLE();
+        l_GpioInit.Mode = GPIO_MODE_AF_PP;
+        l_GpioInit.Pull = GPIO_NOPULL;
+        l_GpioInit.Speed = GPIO_SPEED_FREQ_LOW;
+        l_GpioInit.Alternate = GPIO_AF1_TIM2;
+        l_GpioInit.Pin = GPIO_PIN_15;
+        HAL_GPIO_Init(GPIOA, &l_GpioInit);
+        l_GpioInit.Pin = GPIO_PIN_10;
+        HAL_GPIO_Init(GPIOB, &l_GpioInit);
+
+        /* TIM2 unprescaled, 32 bit: the trigger at the start of every period, the echo captured on both edges */
+        __HAL_RCC_TIM2_CLK_ENABLE();
+        TIM2->CR1 = ZERO;
+        TIM2->PSC = ZERO;
+        TIM2->ARR = (l_TicksPerUs * (RANGE_SENSOR_PERIOD_MS * 1000UL)) - 1U;
+        TIM2->CCR3 = l_TicksPerUs * RANGE_SENSOR_TRIGGER_US;
+        TIM2->CCMR1 = ((uint32_t)RANGE_SENSOR_IC_TI1 << TIM_CCMR1_CC1S_Pos) |
+                      ((uint32_t)RANGE_SENSOR_IC_FILTER << TIM_CCMR1_IC1F_Pos) |
+                      ((uint32_t)RANGE_SENSOR_IC_TI1_INDIRECT << TIM_CCMR1_CC2S_Pos) |
+                      ((uint32_t)RANGE_SENSOR_IC_FILTER << TIM_CCMR1_IC2F_Pos);
+        TIM2->CCMR2 = ((uint32_t)RANGE_SENSOR_OC_PWM1 << TIM_CCMR2_OC3M_Pos) | TIM_CCMR2_OC3PE;
+        TIM2->CCER = TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC2P | TIM_CCER_CC3E;
+        TIM2->DIER = TIM_DIER_CC2IE;
+        TIM2->EGR = TIM_EGR_UG;
+        TIM2->SR = ZERO;
+        HAL_NVIC_SetPriority(TIM2_IRQn, RANGE_SENSOR_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(TIM2_IRQn);
+        TIM2->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function handles the echo capture, call it from TIM2_IRQHandler
+ */
+ECU_RAMFUNC void range_sensor_irq(void)
+{
+    // timer ticks are cpu cycles (HCLK = timer clock), the edge time is taken back from the counter
+    uint32_t l_Now = CYCLE_COUNTER_NOW();
+    uint32_t l_Counter = TIM2->CNT;
+    uint32_t l_Rise = TIM2->CCR1;
+    uint32_t l_Fall = TIM2->CCR2;       // clears CC2IF
+    uint32_t l_Period = TIM2->ARR + 1U;
+    uint32_t l_Clock = SystemCoreClock;
+
+    TIM2->SR = ~(uint32_t)(TIM_SR_CC1OF | TIM_SR_CC2OF | TIM_SR_CC1IF);
+    if ((l_Fall < l_Rise) || (NULL == RangeSensorCallback))
+    {
+        /* Nothing: the rising edge of this echo was not captured in this period */
+    }
+    else
+    {
+        uint32_t l_Width = l_Fall - l_Rise;
+        uint32_t l_Since = (l_Counter >= l_Fall) ? (l_Counter - l_Fall) : ((l_Counter + l_Period) - l_Fall);
+        uint32_t l_RangeMm = ZERO;
+
+        if (l_Width <= ((l_Clock / 1000000UL) * RANGE_SENSOR_MAX_ECHO_US))
+        {
+            // single UMULL, no division by a 64 bit value in the interrupt
+            uint32_t l_MmPerTick = (RANGE_SENSOR_HALF_SOUND_MM_S << RANGE_SENSOR_SCALE_SHIFT) /
+                                   (l_Clock >> RANGE_SENSOR_SCALE_SHIFT);
+            l_RangeMm = (uint32_t)(((uint64_t)l_Width * l_MmPerTick) >> (2U * RANGE_SENSOR_SCALE_SHIFT));
+        }
+        else
+        {
+            /* Nothing: no target, reported as no echo */
+        }
+        RangeSensorCount++;
+        RangeSensorCallback((uint16_t)l_RangeMm, l_Now - l_Since);
+    }
+}
+
+/**
+ * @brief this function returns the number of echoes measured since init
+ *
+ * @return uint32_t echoes
+ */
+uint32_t range_sensor_get_count(void)
+{
+    return RangeSensorCount;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,382 @@
+/**
+ * @file    telemetry.c
+ * @author  Ahmed Hani
+ * @brief   binary telemetry, delta / varint coded records collected in two buffers sent alternately by UART DMA
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/telemetry.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define TELEMETRY_VARINT_MAX        (5)     // bytes of a 32 bit varint
+#define TELEMETRY_RECORD_MAX        (1 + TELEMETRY_VARINT_MAX + (TELEMETRY_MAX_FIELDS * TELEMETRY_VARINT_MAX))
+#define TELEMETRY_PAYLOAD_OFFSET    (LINK_HEADER_SIZE)
+#define TELEMETRY_DATA_END          (TELEMETRY_BUFFER_SIZE - LINK_CRC_SIZE)
+#define TELEMETRY_CLOCK_UNIT        (1000U) // core clock sent in kHz
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* signed to unsigned so small negative deltas stay short: 0, -1, 1, -2 ... -> 0, 1, 2, 3 ... */
+#define TELEMETRY_ZIGZAG(value)     (((uint32_t)(value) << 1) ^ (uint32_t)((int32_t)(value) >> 31))
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static uint32_t telemetry_put_varint(uint8_t *p_Buffer, uint32_t p_Value);
+static void telemetry_open(uint32_t p_Now);
+static void telemetry_close(uint32_t p_Now);
+static ecu_status_t telemetry_send(void);
+static void telemetry_tx_done(void);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+/* fields of every channel, Tools/telemetry_decode.py holds the same table */
+static const uint8_t TelemetryFieldCounts[TELEMETRY_CHANNELS] =
+{
+    [TELEMETRY_WHEEL_SPEEDS]    = 4,
+    [TELEMETRY_MOTOR_DUTIES]    = 4,
+    [TELEMETRY_RANGES]          = 4,
+    [TELEMETRY_POSE]            = 3,
+    [TELEMETRY_TASK_TIMING]     = 2,
+    [TELEMETRY_LOG]             = 4,
+};
+
+static uint8_t TelemetryBuffers[2][TELEMETRY_BUFFER_SIZE] __attribute__((aligned(4))) ECU_NOINIT;
+static uint8_t TelemetryActive = ZERO;          // buffer being filled, the other one may be on the wire
+static uint32_t TelemetryFill = ZERO;           // next free byte of the active buffer
+static uint32_t TelemetryFirstRecord = ZERO;    // offset of the first record, the buffer is empty while equal
+static uint32_t TelemetryLastTime = ZERO;
+static uint32_t TelemetryClock = ZERO;          // core clock in Hz of the timestamps of the active buffer
+static int32_t TelemetryLastValues[TELEMETRY_CHANNELS][TELEMETRY_MAX_FIELDS];
+static uint8_t TelemetrySequence = ZERO;
+static volatile uint8_t TelemetrySending = ZERO;
+static uint8_t TelemetryClosed = ZERO;          // buffer owned by the sender while TelemetrySending is set
+static uint32_t TelemetryClosedFill = ZERO;     // end of the records of the closed buffer
+static volatile uint8_t TelemetryRetry = ZERO;  // the closed buffer found the UART busy, telemetry_flush resends it
+static telemetry_stats_t TelemetryStats;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function resets both buffers, the UART must already be initialized (link_init)
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t telemetry_init(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    TelemetryStats.Records = ZERO;
+    TelemetryStats.Dropped = ZERO;
+    TelemetryStats.Frames = ZERO;
+    TelemetrySequence = ZERO;
+    TelemetrySending = ZERO;
+    TelemetryRetry = ZERO;
+    TelemetryActive = ZERO;
+    telemetry_open(CYCLE_COUNTER_NOW());
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function appends one record, callable from any context, never waits: a record that finds both
+ *        buffers busy is dropped and counted
+ *
+ * @param p_Channel channel of the record
+ * @param p_Values fields of the record, as many as the channel has
+ * @return ecu_status_t ECU_ERROR if the record was dropped or the channel is unknown
+ */
+ecu_status_t telemetry_record(telemetry_channel_t p_Channel, const int32_t *p_Values)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint8_t l_Record[TELEMETRY_RECORD_MAX];
+    uint8_t l_Send = ZERO;
+    uint32_t l_Primask = __get_PRIMASK();
+    if ((NULL == p_Values) || (p_Channel >= TELEMETRY_CHANNELS))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_Fields = TelemetryFieldCounts[p_Channel];
+
+        // bounded section: one record is encoded (at most TELEMETRY_RECORD_MAX bytes) and a full buffer claimed,
+        // its CRC and the DMA start run after the section
+        __disable_irq();
+        uint32_t l_Now = CYCLE_COUNTER_NOW();
+        uint8_t l_ClockChanged = (TelemetryClock != SystemCoreClock);
+        if (l_ClockChanged && (TelemetryFill == TelemetryFirstRecord))
+        {
+            // nothing recorded at the old clock, the header is written again
+            telemetry_open(l_Now);
+        }
+        else if ((l_ClockChanged || ((TelemetryFill + TELEMETRY_RECORD_MAX) > TELEMETRY_DATA_END)) &&
+                 (ZERO == TelemetrySending))
+        {
+            // a power profile change starts a new buffer so every buffer has a single clock
+            telemetry_close(l_Now);
+            l_Send = 1;
+        }
+        else
+        {
+            /* Nothing */
+        }
+
+        // encode against the delta state of the buffer that will hold the record
+        uint32_t l_Length = ZERO;
+        l_Record[l_Length++] = (uint8_t)p_Channel;
+        l_Length += telemetry_put_varint(&l_Record[l_Length], l_Now - TelemetryLastTime);
+        for (uint32_t l_Field = ZERO; l_Field < l_Fields; l_Field++)
+        {
+            int32_t l_Delta = (int32_t)((uint32_t)p_Values[l_Field] - (uint32_t)TelemetryLastValues[p_Channel][l_Field]);
+            l_Length += telemetry_put_varint(&l_Record[l_Length], TELEMETRY_ZIGZAG(l_Delta));
+        }
+
+        if ((TelemetryFill + l_Length) > TELEMETRY_DATA_END)
+        {
+            // the other buffer is still on the wire, keep the delta state untouched
+            TelemetryStats.Dropped++;
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            for (uint32_t l_Byte = ZERO; l_Byte < l_Length; l_Byte++)
+            {
+                TelemetryBuffers[TelemetryActive][TelemetryFill + l_Byte] = l_Record[l_Byte];
+            }
+            TelemetryFill += l_Length;
+            TelemetryLastTime = l_Now;
+            for (uint32_t l_Field = ZERO; l_Field < l_Fields; l_Field++)
+            {
+                TelemetryLastValues[p_Channel][l_Field] = p_Values[l_Field];
+            }
+            TelemetryStats.Records++;
+        }
+        __set_PRIMASK(l_Primask);
+
+        if (l_Send)
+        {
+            (void)telemetry_send();
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function sends the partly filled buffer if the UART is free, call it from a periodic task
+ *        to bound the latency when few records are written. it also resends a full buffer that found the UART busy
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t telemetry_flush(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint8_t l_Send = ZERO;
+    uint32_t l_Primask = __get_PRIMASK();
+    __disable_irq();
+    if (ZERO != TelemetryRetry)
+    {
+        TelemetryRetry = ZERO;
+        l_Send = 1;
+    }
+    else if ((TelemetryFill == TelemetryFirstRecord) || (ZERO != TelemetrySending))
+    {
+        /* Nothing */
+    }
+    else
+    {
+        telemetry_close(CYCLE_COUNTER_NOW());
+        l_Send = 1;
+    }
+    __set_PRIMASK(l_Primask);
+
+    if (l_Send)
+    {
+        l_EcuStatus = telemetry_send();
+    }
+    else
+    {
+        /* Nothing */
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function copies the counters of the telemetry
+ *
+ * @param p_Stats destination of the counters
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t telemetry_get_stats(telemetry_stats_t *p_Stats)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Primask = __get_PRIMASK();
+    if (NULL == p_Stats)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        __disable_irq();
+        *p_Stats = TelemetryStats;
+        __set_PRIMASK(l_Primask);
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief writes an unsigned LEB128 varint, 7 bits per byte with the top bit set on all but the last
+ *
+ * @param p_Buffer destination, room for TELEMETRY_VARINT_MAX bytes
+ * @param p_Value value to write
+ * @return uint32_t bytes written
+ */
+static uint32_t telemetry_put_varint(uint8_t *p_Buffer, uint32_t p_Value)
+{
+    uint32_t l_Length = ZERO;
+    while (p_Value >= 0x80U)
+    {
+        p_Buffer[l_Length++] = (uint8_t)(p_Value | 0x80U);
+        p_Value >>= 7;
+    }
+    p_Buffer[l_Length++] = (uint8_t)p_Value;
+    return l_Length;
+}
+
+/**
+ * @brief starts the active buffer: frame header, sequence, dropped count, core clock and base timestamp, the delta
+ *        state restarts from zero so the buffer decodes without the previous one. called with interrupts masked
+ *
+ * @param p_Now base timestamp in cycles
+ */
+static void telemetry_open(uint32_t p_Now)
+{
+    uint8_t *l_Buffer = TelemetryBuffers[TelemetryActive];
+    uint32_t l_Fill = TELEMETRY_PAYLOAD_OFFSET;
+    l_Buffer[0] = LINK_SYNC_0;
+    l_Buffer[1] = LINK_SYNC_1;
+    l_Buffer[2] = LINK_MSG_TELEMETRY;
+    l_Buffer[l_Fill++] = TelemetrySequence;
+    l_Fill += telemetry_put_varint(&l_Buffer[l_Fill], TelemetryStats.Dropped);
+    TelemetryClock = SystemCoreClock;
+    l_Fill += telemetry_put_varint(&l_Buffer[l_Fill], TelemetryClock / TELEMETRY_CLOCK_UNIT);
+    l_Buffer[l_Fill++] = (uint8_t)p_Now;
+    l_Buffer[l_Fill++] = (uint8_t)(p_Now >> 8);
+    l_Buffer[l_Fill++] = (uint8_t)(p_Now >> 16);
+    l_Buffer[l_Fill++] = (uint8_t)(p_Now >> 24);
+    TelemetryFill = l_Fill;
+    TelemetryFirstRecord = l_Fill;
+    TelemetryLastTime = p_Now;
+    for (uint32_t l_Channel = ZERO; l_Channel < TELEMETRY_CHANNELS; l_Channel++)
+    {
+        for (uint32_t l_Field = ZERO; l_Field < TELEMETRY_MAX_FIELDS; l_Field++)
+        {
+            TelemetryLastValues[l_Channel][l_Field] = ZERO;
+        }
+    }
+}
+
+/**
+ * @brief hands the active buffer to the sender and opens the other one. called with interrupts masked and no buffer
+ *        on the wire, the caller then runs telemetry_send with interrupts enabled
+ *
+ * @param p_Now base timestamp of the new buffer in cycles
+ */
+static void telemetry_close(uint32_t p_Now)
+{
+    TelemetrySending = 1;
+    TelemetryClosed = TelemetryActive;
+    TelemetryClosedFill = TelemetryFill;
+    TelemetryActive ^= 1U;
+    TelemetrySequence++;
+    telemetry_open(p_Now);
+}
+
+/**
+ * @brief writes the length and CRC of the closed buffer and hands it to the UART. runs with interrupts enabled, only
+ *        the context that set TelemetrySending touches the closed buffer
+ *
+ * @return ecu_status_t ECU_ERROR if the UART is busy with another sender, telemetry_flush tries again
+ */
+static ecu_status_t telemetry_send(void)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint8_t *l_Buffer = TelemetryBuffers[TelemetryClosed];
+    uint32_t l_Length = TelemetryClosedFill - TELEMETRY_PAYLOAD_OFFSET;
+    l_Buffer[3] = (uint8_t)l_Length;
+    uint16_t l_Crc = link_crc16(l_Buffer, 2U, l_Length + 2U, 0xFFFFFFFFUL);
+    l_Buffer[TelemetryClosedFill] = (uint8_t)l_Crc;
+    l_Buffer[TelemetryClosedFill + 1U] = (uint8_t)(l_Crc >> 8);
+    l_EcuStatus = uart_transmit(l_Buffer, (uint16_t)(TelemetryClosedFill + LINK_CRC_SIZE), telemetry_tx_done);
+    if (ECU_OK == l_EcuStatus)
+    {
+        TelemetryStats.Frames++;
+    }
+    else
+    {
+        // the buffer stays claimed, records keep going to the other one
+        TelemetryRetry = 1;
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief the buffer on the wire is free again
+ */
+static void telemetry_tx_done(void)
+{
+    TelemetrySending = ZERO;
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
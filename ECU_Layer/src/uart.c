@@ -0,0 +1,282 @@
+/**
+ * @file    uart.c
+ * @author  Ahmed Hani
+ * @brief   USART2 transport to the companion computer, reception by circular DMA with idle line detection,
+ *          transmission by one shot DMA
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/uart.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define UART_RX_MASK                (UART_RX_RING_SIZE - 1U)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void uart_rx_process(void);
+static void uart_rx_dma_event(DMA_HandleTypeDef *p_Dma);
+static void uart_tx_dma_complete(DMA_HandleTypeDef *p_Dma);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static uint8_t UartRxRing[UART_RX_RING_SIZE] __attribute__((aligned(4))) ECU_NOINIT;
+static uint32_t UartRxRead = ZERO;
+static uart_rx_callback_t UartRxCallback = NULL;
+static volatile uint8_t UartTxBusy = ZERO;
+static uart_tx_callback_t UartTxDone = NULL;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function configures the pins, USART2 and DMA1 streams 5 (RX) and 6 (TX) then starts reception
+ *
+ * @param p_Callback consumer of the received bytes
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t uart_init(uart_rx_callback_t p_Callback)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    GPIO_InitTypeDef l_GpioInit = {0};
+    if (NULL == p_Callback)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        UartRxCallback = p_Callback;
+        UartRxRead = ZERO;
+
+        /* pins */
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        l_GpioInit.Pin = GPIO_PIN_2 | GPIO_PIN_3;
+        l_GpioInit.Mode = GPIO_MODE_AF_PP;
+        l_GpioInit.Pull = GPIO_PULLUP;
+        l_GpioInit.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+        l_GpioInit.Alternate = GPIO_AF7_USART2;
+        HAL_GPIO_Init(GPIOA, &l_GpioInit);
+
+        /* USART2 8N1, 8x oversampling: BRR holds 16 * USARTDIV with the fraction on 3 bits */
+        __HAL_RCC_USART2_CLK_ENABLE();
+        uint32_t l_Divider = ((2UL * HAL_RCC_GetPCLK1Freq()) + (UART_BAUD_RATE / 2UL)) / UART_BAUD_RATE;
+        USART2->CR1 = ZERO;
+        USART2->CR2 = ZERO;
+        USART2->CR3 = USART_CR3_DMAR | USART_CR3_DMAT;
+        USART2->BRR = (l_Divider & ~0xFUL) | ((l_Divider & 0xFUL) >> 1);
+
+        /* DMA1 stream 5 channel 4, circular over the ring */
+        __HAL_RCC_DMA1_CLK_ENABLE();
+        hdma_usart2_rx.Instance = DMA1_Stream5;
+        hdma_usart2_rx.Init.Channel = DMA_CHANNEL_4;
+        hdma_usart2_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+        hdma_usart2_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_usart2_rx.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_usart2_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_usart2_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma_usart2_rx.Init.Mode = DMA_CIRCULAR;
+        hdma_usart2_rx.Init.Priority = DMA_PRIORITY_HIGH;
+        hdma_usart2_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+        /* DMA1 stream 6 channel 4, one transfer per buffer */
+        hdma_usart2_tx.Instance = DMA1_Stream6;
+        hdma_usart2_tx.Init.Channel = DMA_CHANNEL_4;
+        hdma_usart2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+        hdma_usart2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_usart2_tx.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_usart2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+        hdma_usart2_tx.Init.Priority = DMA_PRIORITY_MEDIUM;
+        hdma_usart2_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        if ((HAL_DMA_Init(&hdma_usart2_rx) != HAL_OK) || (HAL_DMA_Init(&hdma_usart2_tx) != HAL_OK))
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            hdma_usart2_rx.XferHalfCpltCallback = uart_rx_dma_event;
+            hdma_usart2_rx.XferCpltCallback = uart_rx_dma_event;
+            hdma_usart2_tx.XferCpltCallback = uart_tx_dma_complete;
+            hdma_usart2_tx.XferErrorCallback = uart_tx_dma_complete;
+            HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, UART_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+            HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, UART_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+            HAL_NVIC_SetPriority(USART2_IRQn, UART_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(USART2_IRQn);
+            if (HAL_DMA_Start_IT(&hdma_usart2_rx, (uint32_t)&USART2->DR, (uint32_t)UartRxRing,
+                                 UART_RX_RING_SIZE) != HAL_OK)
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+            else
+            {
+                USART2->CR1 = USART_CR1_OVER8 | USART_CR1_IDLEIE | USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function starts sending a buffer, never waits
+ *
+ * @param p_Data data to send, must stay untouched until p_Done is called
+ * @param p_Length number of bytes
+ * @param p_Done called when the buffer is free again (can be NULL)
+ * @return ecu_status_t ECU_ERROR if a transmission is already running
+ */
+ecu_status_t uart_transmit(const uint8_t *p_Data, uint16_t p_Length, uart_tx_callback_t p_Done)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    uint32_t l_Primask = __get_PRIMASK();
+    if ((NULL == p_Data) || (ZERO == p_Length))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        // producers can call from any priority, claiming the DMA is the only shared step
+        __disable_irq();
+        if (UartTxBusy)
+        {
+            l_EcuStatus = ECU_ERROR;
+        }
+        else
+        {
+            UartTxBusy = 1;
+        }
+        __set_PRIMASK(l_Primask);
+
+        if (ECU_OK == l_EcuStatus)
+        {
+            UartTxDone = p_Done;
+            USART2->SR = (uint32_t)~USART_SR_TC;
+            if (HAL_DMA_Start_IT(&hdma_usart2_tx, (uint32_t)p_Data, (uint32_t)&USART2->DR, p_Length) != HAL_OK)
+            {
+                UartTxBusy = ZERO;
+                l_EcuStatus = ECU_ERROR;
+            }
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function tells if a transmission is running
+ *
+ * @return uint8_t one while the transmit DMA is busy
+ */
+uint8_t uart_is_transmitting(void)
+{
+    return UartTxBusy;
+}
+
+/**
+ * @brief USART2 interrupt, only the idle line is enabled
+ */
+void uart_irq(void)
+{
+    uint32_t l_Status = USART2->SR;
+    if (l_Status & USART_SR_IDLE)
+    {
+        // SR then DR read clears IDLE (and any overrun / framing flag), the line is quiet so no byte is lost
+        (void)USART2->DR;
+        uart_rx_process();
+    }
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief hands the new bytes to the consumer, DMA and USART interrupts share a priority so this never nests
+ */
+static void uart_rx_process(void)
+{
+    uint32_t l_Write = (UART_RX_RING_SIZE - __HAL_DMA_GET_COUNTER(&hdma_usart2_rx)) & UART_RX_MASK;
+    if (l_Write != UartRxRead)
+    {
+        UartRxRead = UartRxCallback(UartRxRing, UartRxRead, l_Write) & UART_RX_MASK;
+    }
+}
+
+/**
+ * @brief DMA filled half or all of the ring, keeps the latency bounded on a link that never goes idle
+ *
+ * @param p_Dma DMA handle
+ */
+static void uart_rx_dma_event(DMA_HandleTypeDef *p_Dma)
+{
+    (void)p_Dma;
+    uart_rx_process();
+}
+
+/**
+ * @brief the last byte of the buffer went to the USART, the buffer belongs to the producer again
+ *
+ * @param p_Dma DMA handle
+ */
+static void uart_tx_dma_complete(DMA_HandleTypeDef *p_Dma)
+{
+    uart_tx_callback_t l_Done = UartTxDone;
+    (void)p_Dma;
+    UartTxBusy = ZERO;
+    if (NULL != l_Done)
+    {
+        l_Done();
+    }
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
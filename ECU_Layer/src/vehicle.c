@@ -0,0 +1,212 @@
+/**
+ * @file    vehicle.c
+ * @author  Ahmed Hani
+ * @brief   skid steer kinematics over the motor bank, one twist (speed, yaw rate) drives all four wheels
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/vehicle.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+
+
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function initialize the drivetrain and its motor bank, the car starts standing still
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @param p_Config geometry of the drivetrain
+ * @param p_Motors motor of every wheel, indexed by vehicle_wheel_t
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t vehicle_init(vehicle_t *p_Vehicle, const vehicle_config_t *p_Config, motor_t *const *p_Motors)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if ((NULL == p_Vehicle) || (NULL == p_Config) || (NULL == p_Motors) ||
+        (p_Config->TrackWidth <= 0.0f) || (p_Config->MaxWheelSpeed <= 0.0f))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        memset(p_Vehicle, ZERO, sizeof(vehicle_t));
+        p_Vehicle->HalfTrack = p_Config->TrackWidth * 0.5f;
+        p_Vehicle->MaxWheelSpeed = p_Config->MaxWheelSpeed;
+        for (uint8_t l_Wheel = ZERO; l_Wheel < VEHICLE_WHEELS; l_Wheel++)
+        {
+            p_Vehicle->Motors[l_Wheel] = p_Motors[l_Wheel];
+            // the sign of a reversed motor is folded into its scale factor
+            p_Vehicle->WheelToMotor[l_Wheel] = (float_t)MOTOR_MAX_SPEED / p_Config->MaxWheelSpeed;
+            if (p_Config->Reversed[l_Wheel])
+            {
+                p_Vehicle->WheelToMotor[l_Wheel] = -p_Vehicle->WheelToMotor[l_Wheel];
+            }
+        }
+
+        l_EcuStatus = motor_bank_init(p_Vehicle->Motors, VEHICLE_WHEELS);
+        if (ECU_OK == l_EcuStatus)
+        {
+            l_EcuStatus = vehicle_stop(p_Vehicle);
+        }
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function drives the car with a forward speed and a yaw rate, if a wheel would exceed its limit both
+ *        are scaled down together so the path curvature is kept, all wheels are written in one batch
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @param p_Speed forward speed in m/s
+ * @param p_YawRate yaw rate in rad/s, positive turns left
+ * @return ecu_status_t status of the operation
+ */
+ECU_RAMFUNC ecu_status_t vehicle_set_twist(vehicle_t *p_Vehicle, float_t p_Speed, float_t p_YawRate)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Vehicle)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        float_t l_Turn = p_YawRate * p_Vehicle->HalfTrack;
+        float_t l_Left = p_Speed - l_Turn;
+        float_t l_Right = p_Speed + l_Turn;
+
+        /* scale both sides by the same factor, the ratio left / right (the curvature) stays as requested */
+        float_t l_Largest = (l_Left < 0.0f) ? -l_Left : l_Left;
+        float_t l_AbsRight = (l_Right < 0.0f) ? -l_Right : l_Right;
+        l_Largest = (l_AbsRight > l_Largest) ? l_AbsRight : l_Largest;
+        if (l_Largest > p_Vehicle->MaxWheelSpeed)
+        {
+            float_t l_Scale = p_Vehicle->MaxWheelSpeed / l_Largest;
+            l_Left *= l_Scale;
+            l_Right *= l_Scale;
+            p_Speed *= l_Scale;
+            p_YawRate *= l_Scale;
+        }
+
+        p_Vehicle->WheelSpeeds[VEHICLE_WHEEL_FRONT_LEFT] = l_Left;
+        p_Vehicle->WheelSpeeds[VEHICLE_WHEEL_REAR_LEFT] = l_Left;
+        p_Vehicle->WheelSpeeds[VEHICLE_WHEEL_FRONT_RIGHT] = l_Right;
+        p_Vehicle->WheelSpeeds[VEHICLE_WHEEL_REAR_RIGHT] = l_Right;
+        p_Vehicle->Speed = p_Speed;
+        p_Vehicle->YawRate = p_YawRate;
+
+        float_t l_MotorSpeeds[VEHICLE_WHEELS];
+        for (uint8_t l_Wheel = ZERO; l_Wheel < VEHICLE_WHEELS; l_Wheel++)
+        {
+            l_MotorSpeeds[l_Wheel] = p_Vehicle->WheelSpeeds[l_Wheel] * p_Vehicle->WheelToMotor[l_Wheel];
+        }
+        l_EcuStatus = motor_bank_set(p_Vehicle->Motors, l_MotorSpeeds, VEHICLE_WHEELS);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function stops all wheels
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t vehicle_stop(vehicle_t *p_Vehicle)
+{
+    return vehicle_set_twist(p_Vehicle, 0.0f, 0.0f);
+}
+
+/**
+ * @brief this function brakes all wheels (motor_brake), unlike vehicle_stop it holds the car and is never refused
+ *        by the AEB brake latch
+ *
+ * @param p_Vehicle object of the drivetrain
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t vehicle_brake(vehicle_t *p_Vehicle)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+    if (NULL == p_Vehicle)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        for (uint8_t l_Wheel = ZERO; l_Wheel < VEHICLE_WHEELS; l_Wheel++)
+        {
+            p_Vehicle->WheelSpeeds[l_Wheel] = 0.0f;
+            if (ECU_OK != motor_brake(p_Vehicle->Motors[l_Wheel]))
+            {
+                l_EcuStatus = ECU_ERROR;
+            }
+        }
+        p_Vehicle->Speed = 0.0f;
+        p_Vehicle->YawRate = 0.0f;
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,300 @@
+/**
+ * @file    watchdog.c
+ * @author  Ahmed Hani
+ * @brief   independent watchdog (IWDG) kicked by a supervisor only while every critical task checks in on time
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "../inc/watchdog.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define WATCHDOG_KEY_RELOAD         (0xAAAAU)
+#define WATCHDOG_KEY_ACCESS         (0x5555U)
+#define WATCHDOG_KEY_START          (0xCCCCU)
+#define WATCHDOG_PR_DIV4            (0U)
+#define WATCHDOG_PR_DIV256          (6U)
+#define WATCHDOG_STOP_RELOAD        (IWDG_RLR_RL)
+#define WATCHDOG_RELOAD             ((WATCHDOG_TIMEOUT_MS * WATCHDOG_LSI_HZ) / (WATCHDOG_PRESCALER * 1000UL))
+
+#if (WATCHDOG_PRESCALER != 4)
+#error "WATCHDOG_PR_DIV4 is the prescaler register value of LSI / 4"
+#endif
+
+#if (WATCHDOG_STOP_PRESCALER != 256)
+#error "WATCHDOG_PR_DIV256 is the prescaler register value of LSI / 256"
+#endif
+
+#if (WATCHDOG_RELOAD > IWDG_RLR_RL)
+#error "WATCHDOG_TIMEOUT_MS does not fit the 12 bit reload at this prescaler"
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define WATCHDOG_BIT(task)          (1UL << (task))
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+volatile uint32_t WatchdogCheckIns = ZERO;
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static uint32_t WatchdogWindowMs[WATCHDOG_MAX_TASKS];
+static uint32_t WatchdogLastMs[WATCHDOG_MAX_TASKS];
+static volatile uint32_t WatchdogRegistered = ZERO;
+static volatile uint32_t WatchdogStalled = ZERO;
+static volatile uint8_t WatchdogStarted = ZERO;
+
+/* late tasks written before the IWDG reset, read back by watchdog_start of the next run */
+static ECU_NOINIT uint32_t WatchdogStallRecord;
+static uint8_t WatchdogResetCause = ZERO;
+static uint32_t WatchdogStalledBeforeReset = ZERO;
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+/**
+ * @brief this function adds a task to the supervision, its window starts now. call before watchdog_start, a task
+ *        can not leave the supervision
+ *
+ * @param p_Task task number, 0 .. WATCHDOG_MAX_TASKS - 1
+ * @param p_WindowMs longest time allowed between two check ins in milliseconds (2 at least)
+ * @return ecu_status_t ECU_ERROR for a wrong task number or window
+ */
+ecu_status_t watchdog_register(uint8_t p_Task, uint32_t p_WindowMs)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    // the supervisor samples every millisecond, a 1 ms window would fail on tick jitter
+    if ((p_Task >= WATCHDOG_MAX_TASKS) || (p_WindowMs < 2U))
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        uint32_t l_Primask = __get_PRIMASK();
+
+        __disable_irq();
+        WatchdogWindowMs[p_Task] = p_WindowMs;
+        WatchdogLastMs[p_Task] = HAL_GetTick();
+        WatchdogRegistered |= WATCHDOG_BIT(p_Task);
+        __set_PRIMASK(l_Primask);
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function starts the IWDG (LSI, WATCHDOG_TIMEOUT_MS), it is frozen while the debugger halts the core
+ *
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t watchdog_start(void)
+{
+    boot_report_t l_Boot;
+
+    if (ZERO == WatchdogStarted)
+    {
+        // the record is random after a power up, only an IWDG reset makes it valid
+        if ((ECU_OK == boot_get_report(&l_Boot)) && (l_Boot.ResetFlags & RCC_CSR_IWDGRSTF))
+        {
+            WatchdogResetCause = 1U;
+            WatchdogStalledBeforeReset = WatchdogStallRecord;
+        }
+        else
+        {
+            /* Nothing */
+        }
+        WatchdogStallRecord = ZERO;
+
+        DBGMCU->APB1FZ |= DBGMCU_APB1_FZ_DBG_IWDG_STOP;
+
+        // the start key also starts the LSI
+        IWDG->KR = WATCHDOG_KEY_START;
+        IWDG->KR = WATCHDOG_KEY_ACCESS;
+        IWDG->PR = WATCHDOG_PR_DIV4;
+        IWDG->RLR = WATCHDOG_RELOAD;
+        while (ZERO != (IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU)))
+        {
+            /* Nothing */
+        }
+        IWDG->KR = WATCHDOG_KEY_RELOAD;
+        WatchdogStarted = 1U;
+    }
+    else
+    {
+        /* Nothing */
+    }
+    return ECU_OK;
+}
+
+/**
+ * @brief this function collects the check ins and kicks the IWDG if no task is late, called from SysTick_Handler
+ */
+void watchdog_supervise(void)
+{
+    uint32_t l_Now = HAL_GetTick();
+    uint32_t l_CheckIns = ZERO;
+    uint32_t l_Pending = WatchdogRegistered;
+
+    // take and clear the bits at once, a check in from a higher priority handler makes the STREX fail
+    do
+    {
+        l_CheckIns = __LDREXW(&WatchdogCheckIns);
+    } while (__STREXW(ZERO, &WatchdogCheckIns) != ZERO);
+
+    while (ZERO != l_Pending)
+    {
+        uint8_t l_Task = (uint8_t)(31U - __CLZ(l_Pending));
+
+        l_Pending &= ~WATCHDOG_BIT(l_Task);
+        if (l_CheckIns & WATCHDOG_BIT(l_Task))
+        {
+            WatchdogLastMs[l_Task] = l_Now;
+        }
+        else if ((l_Now - WatchdogLastMs[l_Task]) > WatchdogWindowMs[l_Task])
+        {
+            WatchdogStalled |= WATCHDOG_BIT(l_Task);
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+
+    // latched: a late task is never forgiven, the IWDG resets the MCU
+    if (ZERO == WatchdogStalled)
+    {
+        if (WatchdogStarted)
+        {
+            IWDG->KR = WATCHDOG_KEY_RELOAD;
+        }
+        else
+        {
+            /* Nothing */
+        }
+    }
+    else
+    {
+        WatchdogStallRecord = WatchdogStalled;
+    }
+}
+
+/**
+ * @brief this function stretches the IWDG timeout to WATCHDOG_STOP_TIMEOUT_MS for STOP mode (no SysTick, no
+ *        supervisor) or brings WATCHDOG_TIMEOUT_MS back, the IWDG is kicked either way. nothing is kicked once a
+ *        task is late, a stall is never forgiven
+ *
+ * @param p_Stop one before STOP and on every wake up that goes back to STOP, zero after the last wake up
+ * @return ecu_status_t ECU_ERROR if a task is late, the timeout is left as it was
+ */
+ecu_status_t watchdog_set_stop(uint8_t p_Stop)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if (ZERO != WatchdogStalled)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else if (WatchdogStarted)
+    {
+        // kicked first: the count left under the old prescaler is the full reload, never a nearly expired one
+        IWDG->KR = WATCHDOG_KEY_RELOAD;
+        IWDG->KR = WATCHDOG_KEY_ACCESS;
+        IWDG->PR = p_Stop ? WATCHDOG_PR_DIV256 : WATCHDOG_PR_DIV4;
+        IWDG->RLR = p_Stop ? WATCHDOG_STOP_RELOAD : WATCHDOG_RELOAD;
+        while (ZERO != (IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU)))
+        {
+            /* Nothing */
+        }
+        IWDG->KR = WATCHDOG_KEY_RELOAD;
+    }
+    else
+    {
+        /* Nothing */
+    }
+    return l_EcuStatus;
+}
+
+/**
+ * @brief this function tells if the IWDG runs
+ *
+ * @return uint8_t nonzero once watchdog_start was called
+ */
+uint8_t watchdog_is_started(void)
+{
+    return WatchdogStarted;
+}
+
+/**
+ * @brief this function reports the supervision state and the cause of the last reset (read by watchdog_start)
+ *
+ * @param p_Report destination
+ * @return ecu_status_t status of the operation
+ */
+ecu_status_t watchdog_get_report(watchdog_report_t *p_Report)
+{
+    ecu_status_t l_EcuStatus = ECU_OK;
+
+    if (NULL == p_Report)
+    {
+        l_EcuStatus = ECU_ERROR;
+    }
+    else
+    {
+        p_Report->Registered = WatchdogRegistered;
+        p_Report->Stalled = WatchdogStalled;
+        p_Report->ResetByWatchdog = WatchdogResetCause;
+        p_Report->StalledBeforeReset = WatchdogStalledBeforeReset;
+    }
+    return l_EcuStatus;
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
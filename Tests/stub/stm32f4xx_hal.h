@@ -0,0 +1,120 @@
+/**
+ * @file    stm32f4xx_hal.h
+ * @author  Ahmed Hani
+ * @brief   host stand-in for the HAL header: only what the modules under test use from it
+ * @date    2026-10-19
+ * @note    the DWT cycle counter reads the host time stamp counter, so the cycle figures the modules record
+ *          themselves (CyclesPerSample, WorstTickCycles ...) are host cycles. interrupt masking does nothing
+ */
+
+
+#ifndef STUB_STM32F4XX_HAL_H_
+#define STUB_STM32F4XX_HAL_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define DWT                             (stub_dwt())
+#define CoreDebug                       (&StubCoreDebug)
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+}DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+}CoreDebug_Type;
+
+typedef struct
+{
+    uint32_t Unused;
+}DMA_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t Unused;
+}EXTI_HandleTypeDef;
+
+
+
+/***********************************************************************************************************************
+*                                                   EXTERN OBJECTS                                                     *
+***********************************************************************************************************************/
+extern uint32_t SystemCoreClock;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+static DWT_Type StubDwt __attribute__((unused));
+static CoreDebug_Type StubCoreDebug __attribute__((unused));
+
+/**
+ * @brief the cycle counter, refreshed from the host on every access
+ *
+ * @return DWT_Type* counter registers
+ */
+static inline DWT_Type *stub_dwt(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    StubDwt.CYCCNT = (uint32_t)__rdtsc();
+#else
+    struct timespec l_Now;
+    clock_gettime(CLOCK_MONOTONIC, &l_Now);
+    StubDwt.CYCCNT = (uint32_t)((l_Now.tv_sec * 1000000000LL) + l_Now.tv_nsec);
+#endif
+    return &StubDwt;
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return 0U;
+}
+
+static inline void __set_PRIMASK(uint32_t p_Primask)
+{
+    (void)p_Primask;
+}
+
+static inline void __disable_irq(void)
+{
+}
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* STUB_STM32F4XX_HAL_H_ */
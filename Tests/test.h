@@ -0,0 +1,99 @@
+/**
+ * @file    test.h
+ * @author  Ahmed Hani
+ * @brief   minimal host test harness: checks, a failure count and a nanosecond clock for the benchmarks
+ * @date    2026-10-19
+ * @note    the ECU_Layer sources under test are compiled for the host with -DECU_RAMFUNC_ENABLE=0, see Makefile
+ */
+
+
+#ifndef TEST_TEST_H_
+#define TEST_TEST_H_
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+/* counts and prints a failed condition, the test goes on so one run lists every failure */
+#define TEST_CHECK(cond)                                                                \
+    do                                                                                  \
+    {                                                                                   \
+        TestChecks++;                                                                   \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            TestFailures++;                                                             \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);                      \
+        }                                                                               \
+    } while (0)
+
+/* |a - b| <= tol, the values are printed on failure */
+#define TEST_CHECK_NEAR(a, b, tol)                                                      \
+    do                                                                                  \
+    {                                                                                   \
+        double l_A = (double)(a);                                                       \
+        double l_B = (double)(b);                                                       \
+        TestChecks++;                                                                   \
+        if (!(((l_A - l_B) <= (tol)) && ((l_B - l_A) <= (tol))))                        \
+        {                                                                               \
+            TestFailures++;                                                             \
+            printf("FAIL %s:%d: %s = %g, %s = %g, tol %g\n", __FILE__, __LINE__,       \
+                   #a, l_A, #b, l_B, (double)(tol));                                    \
+        }                                                                               \
+    } while (0)
+
+/* summary line and exit status of a test program */
+#define TEST_REPORT(name)                                                               \
+    (printf("%s: %u checks, %u failures\n", (name), TestChecks, TestFailures), (TestFailures != 0U))
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DEFINITION                                                 *
+***********************************************************************************************************************/
+static unsigned int TestChecks = 0U;
+static unsigned int TestFailures = 0U;
+
+/**
+ * @brief monotonic host time for the benchmarks
+ *
+ * @return uint64_t nanoseconds
+ */
+static inline uint64_t test_now_ns(void)
+{
+    struct timespec l_Now;
+    clock_gettime(CLOCK_MONOTONIC, &l_Now);
+    return ((uint64_t)l_Now.tv_sec * 1000000000ULL) + (uint64_t)l_Now.tv_nsec;
+}
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
+
+
+#endif /* TEST_TEST_H_ */
@@ -0,0 +1,345 @@
+/**
+ * @file    test_attitude.c
+ * @author  Ahmed Hani
+ * @brief   host tests of the Mahony attitude filter against a double precision reference, and its cycles per sample
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "test.h"
+#include "../ECU_Layer/inc/attitude.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define TEST_KP                 (2.0f)
+#define TEST_KI                 (0.05f)
+#define TEST_RATE_HZ            (1000U)
+#define TEST_PERIOD             (1.0f / TEST_RATE_HZ)
+#define TEST_BURST              (16U)
+#define TEST_BENCH_BURSTS       (50000U)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define TEST_TO_Q16(x)          ((q16_t)lround((x) * 65536.0))
+
+
+
+/***********************************************************************************************************************
+*                                                      DATA TYPES                                                      *
+***********************************************************************************************************************/
+/**
+ * @brief the same filter in double precision with an exact square root
+ */
+typedef struct
+{
+    double Q[4];
+    double GyroBias[3];
+}test_reference_t;
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void test_init_rejects_bad_config(void);
+static void test_static_tilt(void);
+static void test_free_fall(void);
+static void test_double_reference(void);
+static void test_timestamps_follow_the_clock(void);
+static void test_benchmark(void);
+static void test_reference_update(test_reference_t *p_Ref, const double *p_Gyro, const double *p_Accel, double p_Dt);
+static void test_gravity(double p_Roll, double p_Pitch, double *p_Accel);
+
+
+
+/***********************************************************************************************************************
+*                                                     GLOBAL OBJECTS                                                   *
+***********************************************************************************************************************/
+uint32_t SystemCoreClock = 84000000U;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+int main(void)
+{
+    test_init_rejects_bad_config();
+    test_static_tilt();
+    test_free_fall();
+    test_double_reference();
+    test_timestamps_follow_the_clock();
+    test_benchmark();
+    return TEST_REPORT("attitude");
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief negative gains and a zero period are refused
+ */
+static void test_init_rejects_bad_config(void)
+{
+    attitude_t l_Attitude;
+    attitude_config_t l_Config = { TEST_KP, TEST_KI, TEST_PERIOD };
+    TEST_CHECK(ECU_ERROR == attitude_init(NULL, &l_Config));
+    l_Config.Kp = -1.0f;
+    TEST_CHECK(ECU_ERROR == attitude_init(&l_Attitude, &l_Config));
+    l_Config.Kp = TEST_KP;
+    l_Config.SamplePeriod = 0.0f;
+    TEST_CHECK(ECU_ERROR == attitude_init(&l_Attitude, &l_Config));
+    l_Config.SamplePeriod = TEST_PERIOD;
+    TEST_CHECK(ECU_OK == attitude_init(&l_Attitude, &l_Config));
+    TEST_CHECK(ECU_ERROR == attitude_update_batch(&l_Attitude, NULL, 1U));
+}
+
+/**
+ * @brief standing still on a tilted surface the estimate converges to the tilt (the yaw is not observable from
+ *        gravity, the shortest rotation to a rolled and pitched attitude has a small euler yaw of its own)
+ */
+static void test_static_tilt(void)
+{
+    attitude_t l_Attitude;
+    attitude_config_t l_Config = { TEST_KP, 0.0f, TEST_PERIOD };   // the bias integral only slows the settling
+    attitude_euler_t l_Euler;
+    double l_Accel[3];
+    float_t l_Gyro[3] = { 0.0f, 0.0f, 0.0f };
+    float_t l_AccelF[3];
+
+    (void)attitude_init(&l_Attitude, &l_Config);
+    test_gravity(0.3, -0.2, l_Accel);
+    for (int l_Axis = 0; l_Axis < 3; l_Axis++)
+    {
+        l_AccelF[l_Axis] = (float_t)(l_Accel[l_Axis] * 9.81);
+    }
+    for (uint32_t l_Sample = 0U; l_Sample < (10U * TEST_RATE_HZ); l_Sample++)
+    {
+        (void)attitude_update(&l_Attitude, l_Gyro, l_AccelF, TEST_PERIOD);
+    }
+    (void)attitude_get_euler(&l_Attitude, &l_Euler);
+    TEST_CHECK_NEAR(l_Euler.Roll, 0.3, 1e-3);
+    TEST_CHECK_NEAR(l_Euler.Pitch, -0.2, 1e-3);
+}
+
+/**
+ * @brief no acceleration (free fall) integrates the gyro alone and never produces a NaN
+ */
+static void test_free_fall(void)
+{
+    attitude_t l_Attitude;
+    attitude_config_t l_Config = { TEST_KP, TEST_KI, TEST_PERIOD };
+    attitude_euler_t l_Euler;
+    float_t l_Gyro[3] = { 0.0f, 0.0f, 1.0f };
+    float_t l_Accel[3] = { 0.0f, 0.0f, 0.0f };
+
+    (void)attitude_init(&l_Attitude, &l_Config);
+    for (uint32_t l_Sample = 0U; l_Sample < (TEST_RATE_HZ / 2U); l_Sample++)
+    {
+        (void)attitude_update(&l_Attitude, l_Gyro, l_Accel, TEST_PERIOD);
+    }
+    (void)attitude_get_euler(&l_Attitude, &l_Euler);
+    TEST_CHECK(!isnan(l_Attitude.Q[0]) && !isnan(l_Attitude.Q[3]));
+    TEST_CHECK_NEAR(l_Euler.Yaw, 0.5, 1e-3);
+}
+
+/**
+ * @brief single precision, fused multiply-adds and the fast inverse square root against the double reference on a
+ *        car rolling, pitching and turning with noisy sensors and a gyro bias
+ */
+static void test_double_reference(void)
+{
+    attitude_t l_Attitude;
+    attitude_config_t l_Config = { TEST_KP, TEST_KI, TEST_PERIOD };
+    test_reference_t l_Ref = { { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+    double l_Worst = 0.0;
+    uint32_t l_Seed = 2026U;
+
+    (void)attitude_init(&l_Attitude, &l_Config);
+    for (uint32_t l_Sample = 0U; l_Sample < (30U * TEST_RATE_HZ); l_Sample++)
+    {
+        double l_Time = (double)l_Sample / TEST_RATE_HZ;
+        double l_Gyro[3] = { 0.4 * cos(l_Time * 1.3), 0.3 * cos(l_Time * 0.7), 0.5 + (0.2 * sin(l_Time * 0.4)) };
+        double l_Accel[3];
+        float_t l_GyroF[3];
+        float_t l_AccelF[3];
+
+        test_gravity(0.3 * sin(l_Time * 1.3), 0.4 * sin(l_Time * 0.7), l_Accel);
+        for (int l_Axis = 0; l_Axis < 3; l_Axis++)
+        {
+            l_Seed = (l_Seed * 1103515245U) + 12345U;
+            l_Gyro[l_Axis] += 0.02 + ((double)((l_Seed >> 16) & 0xFFU) - 127.5) * 1e-4;
+            l_Accel[l_Axis] = (l_Accel[l_Axis] + (((double)((l_Seed >> 8) & 0xFFU) - 127.5) * 2e-4)) * 9.81;
+            l_GyroF[l_Axis] = (float_t)l_Gyro[l_Axis];
+            l_AccelF[l_Axis] = (float_t)l_Accel[l_Axis];
+        }
+
+        (void)attitude_update(&l_Attitude, l_GyroF, l_AccelF, TEST_PERIOD);
+        test_reference_update(&l_Ref, l_Gyro, l_Accel, TEST_PERIOD);
+        for (int l_Index = 0; l_Index < 4; l_Index++)
+        {
+            double l_Error = fabs((double)l_Attitude.Q[l_Index] - l_Ref.Q[l_Index]);
+            l_Worst = (l_Error > l_Worst) ? l_Error : l_Worst;
+        }
+    }
+    printf("attitude: worst quaternion error against double %.2e over 30 s\n", l_Worst);
+    TEST_CHECK(l_Worst < 1e-3);
+}
+
+/**
+ * @brief the period of a batch step comes from the timestamps with the clock running now: the same 1 ms spacing
+ *        before and after a switch from 84 to 42 MHz integrates the same yaw
+ */
+static void test_timestamps_follow_the_clock(void)
+{
+    attitude_t l_Attitude;
+    attitude_config_t l_Config = { TEST_KP, 0.0f, 2.0f * TEST_PERIOD };   // nominal period deliberately wrong
+    attitude_euler_t l_Euler;
+    imu_sample_t l_Burst[TEST_BURST];
+    uint32_t l_Timestamp = 0xFFF00000U;     // crosses the counter wrap as well
+
+    (void)attitude_init(&l_Attitude, &l_Config);
+    for (uint32_t l_Clock = 84000000U; l_Clock >= 42000000U; l_Clock /= 2U)
+    {
+        SystemCoreClock = l_Clock;
+        for (uint32_t l_Batch = 0U; l_Batch < (TEST_RATE_HZ / TEST_BURST); l_Batch++)
+        {
+            for (uint32_t l_Index = 0U; l_Index < TEST_BURST; l_Index++)
+            {
+                l_Burst[l_Index].Gyro[0] = 0;
+                l_Burst[l_Index].Gyro[1] = 0;
+                l_Burst[l_Index].Gyro[2] = TEST_TO_Q16(0.5);
+                l_Burst[l_Index].Accel[0] = 0;
+                l_Burst[l_Index].Accel[1] = 0;
+                l_Burst[l_Index].Accel[2] = TEST_TO_Q16(9.81);
+                l_Burst[l_Index].Timestamp = l_Timestamp;
+                l_Timestamp += l_Clock / TEST_RATE_HZ;
+            }
+            (void)attitude_update_batch(&l_Attitude, l_Burst, TEST_BURST);
+        }
+    }
+    SystemCoreClock = 84000000U;
+    (void)attitude_get_euler(&l_Attitude, &l_Euler);
+    // 2 * 992 samples of 1 ms at 0.5 rad/s, the first one at the nominal 2 ms
+    TEST_CHECK_NEAR(l_Euler.Yaw, 0.5 * ((2.0 * (TEST_RATE_HZ / TEST_BURST) * TEST_BURST) + 1.0) / TEST_RATE_HZ, 2e-3);
+}
+
+/**
+ * @brief cycles per sample as recorded by the filter itself (host time stamp counter through the DWT stand-in)
+ */
+static void test_benchmark(void)
+{
+    attitude_t l_Attitude;
+    attitude_config_t l_Config = { TEST_KP, TEST_KI, TEST_PERIOD };
+    imu_sample_t l_Burst[TEST_BURST];
+    uint32_t l_Best = UINT32_MAX;
+    uint64_t l_Sum = 0U;
+
+    (void)attitude_init(&l_Attitude, &l_Config);
+    for (uint32_t l_Index = 0U; l_Index < TEST_BURST; l_Index++)
+    {
+        l_Burst[l_Index].Gyro[0] = TEST_TO_Q16(0.01 * l_Index);
+        l_Burst[l_Index].Gyro[1] = TEST_TO_Q16(-0.02);
+        l_Burst[l_Index].Gyro[2] = TEST_TO_Q16(0.3);
+        l_Burst[l_Index].Accel[0] = TEST_TO_Q16(0.5);
+        l_Burst[l_Index].Accel[1] = TEST_TO_Q16(-0.3);
+        l_Burst[l_Index].Accel[2] = TEST_TO_Q16(9.7);
+        l_Burst[l_Index].Timestamp = l_Index * (SystemCoreClock / TEST_RATE_HZ);
+    }
+
+    uint64_t l_Start = test_now_ns();
+    for (uint32_t l_Batch = 0U; l_Batch < TEST_BENCH_BURSTS; l_Batch++)
+    {
+        (void)attitude_update_batch(&l_Attitude, l_Burst, TEST_BURST);
+        l_Best = (l_Attitude.CyclesPerSample < l_Best) ? l_Attitude.CyclesPerSample : l_Best;
+        l_Sum += l_Attitude.CyclesPerSample;
+    }
+    uint64_t l_Elapsed = test_now_ns() - l_Start;
+    printf("attitude: %u cycles per sample best, %.1f average, %.1f ns per sample on the host\n", l_Best,
+           (double)l_Sum / TEST_BENCH_BURSTS, (double)l_Elapsed / (TEST_BENCH_BURSTS * TEST_BURST));
+    TEST_CHECK(!isnan(l_Attitude.Q[0]));
+}
+
+/**
+ * @brief Mahony step in double precision, written from the equations and not from attitude.c
+ *
+ * @param p_Ref reference state
+ * @param p_Gyro angular rate in rad/s
+ * @param p_Accel acceleration, any unit
+ * @param p_Dt period in seconds
+ */
+static void test_reference_update(test_reference_t *p_Ref, const double *p_Gyro, const double *p_Accel, double p_Dt)
+{
+    double *l_Q = p_Ref->Q;
+    double l_G[3] = { p_Gyro[0] - p_Ref->GyroBias[0], p_Gyro[1] - p_Ref->GyroBias[1], p_Gyro[2] - p_Ref->GyroBias[2] };
+    double l_Norm = sqrt((p_Accel[0] * p_Accel[0]) + (p_Accel[1] * p_Accel[1]) + (p_Accel[2] * p_Accel[2]));
+
+    if (l_Norm > 0.0)
+    {
+        double l_A[3] = { p_Accel[0] / l_Norm, p_Accel[1] / l_Norm, p_Accel[2] / l_Norm };
+        // gravity expected in the body frame: earth z rotated back by the quaternion
+        double l_V[3] = { 2.0 * ((l_Q[1] * l_Q[3]) - (l_Q[0] * l_Q[2])),
+                          2.0 * ((l_Q[0] * l_Q[1]) + (l_Q[2] * l_Q[3])),
+                          (l_Q[0] * l_Q[0]) - (l_Q[1] * l_Q[1]) - (l_Q[2] * l_Q[2]) + (l_Q[3] * l_Q[3]) };
+        double l_E[3] = { (l_A[1] * l_V[2]) - (l_A[2] * l_V[1]),
+                          (l_A[2] * l_V[0]) - (l_A[0] * l_V[2]),
+                          (l_A[0] * l_V[1]) - (l_A[1] * l_V[0]) };
+        for (int l_Axis = 0; l_Axis < 3; l_Axis++)
+        {
+            p_Ref->GyroBias[l_Axis] -= TEST_KI * p_Dt * l_E[l_Axis];
+            l_G[l_Axis] += (TEST_KI * p_Dt * l_E[l_Axis]) + (TEST_KP * l_E[l_Axis]);
+        }
+    }
+
+    double l_Dq[4] = { -(l_Q[1] * l_G[0]) - (l_Q[2] * l_G[1]) - (l_Q[3] * l_G[2]),
+                       (l_Q[0] * l_G[0]) + (l_Q[2] * l_G[2]) - (l_Q[3] * l_G[1]),
+                       (l_Q[0] * l_G[1]) - (l_Q[1] * l_G[2]) + (l_Q[3] * l_G[0]),
+                       (l_Q[0] * l_G[2]) + (l_Q[1] * l_G[1]) - (l_Q[2] * l_G[0]) };
+    for (int l_Index = 0; l_Index < 4; l_Index++)
+    {
+        l_Q[l_Index] += 0.5 * p_Dt * l_Dq[l_Index];
+    }
+    l_Norm = sqrt((l_Q[0] * l_Q[0]) + (l_Q[1] * l_Q[1]) + (l_Q[2] * l_Q[2]) + (l_Q[3] * l_Q[3]));
+    for (int l_Index = 0; l_Index < 4; l_Index++)
+    {
+        l_Q[l_Index] /= l_Norm;
+    }
+}
+
+/**
+ * @brief unit gravity seen by an accelerometer at rest for a roll and a pitch (z-y-x)
+ *
+ * @param p_Roll roll in radians
+ * @param p_Pitch pitch in radians
+ * @param p_Accel destination, x y z
+ */
+static void test_gravity(double p_Roll, double p_Pitch, double *p_Accel)
+{
+    p_Accel[0] = -sin(p_Pitch);
+    p_Accel[1] = sin(p_Roll) * cos(p_Pitch);
+    p_Accel[2] = cos(p_Roll) * cos(p_Pitch);
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
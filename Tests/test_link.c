@@ -0,0 +1,424 @@
+/**
+ * @file    test_link.c
+ * @author  Ahmed Hani
+ * @brief   host loopback tests of the link parser: frames go through a pseudo terminal in raw mode and are parsed
+ *          in place from a ring filled the way the UART DMA fills it
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include "test.h"
+#include "../ECU_Layer/inc/link_frame.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define TEST_RING_SIZE          (512U)      // UART_RX_RING_SIZE
+#define TEST_MAX_COMMANDS       (512U)
+#define TEST_TIMEOUT_MS         (1000)
+#define TEST_WRAP_FRAMES        (200U)      // 10 bytes each, the ring wraps several times
+#define TEST_TOL                (1e-6)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void test_open_pty(void);
+static void test_reset(void);
+static uint32_t test_frame(uint8_t *p_Frame, uint8_t p_Type, const uint8_t *p_Payload, uint8_t p_Length);
+static uint32_t test_drive_frame(uint8_t *p_Frame, int16_t p_SpeedMm, int16_t p_YawMrad);
+static void test_transfer(const uint8_t *p_Bytes, uint32_t p_Length);
+static void test_on_command(const link_command_t *p_Command);
+static void test_init_checks(void);
+static void test_commands(void);
+static void test_split_frame(void);
+static void test_bad_crc(void);
+static void test_resync(void);
+static void test_invalid_frames(void);
+static void test_full_frame(void);
+static void test_ring_wrap(void);
+
+
+
+/***********************************************************************************************************************
+*                                                     STATIC OBJECTS                                                   *
+***********************************************************************************************************************/
+static int TestMaster = -1;
+static int TestSlave = -1;
+static link_parser_t TestParser;
+static uint8_t TestRing[TEST_RING_SIZE];
+static uint32_t TestRead;
+static uint32_t TestWrite;
+static link_command_t TestCommands[TEST_MAX_COMMANDS];
+static uint32_t TestCount;
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+int main(void)
+{
+    test_open_pty();
+    test_init_checks();
+    test_commands();
+    test_split_frame();
+    test_bad_crc();
+    test_resync();
+    test_invalid_frames();
+    test_full_frame();
+    test_ring_wrap();
+    close(TestSlave);
+    close(TestMaster);
+    return TEST_REPORT("link");
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief opens a pseudo terminal pair, the slave in raw mode so every byte value goes through untouched
+ */
+static void test_open_pty(void)
+{
+    struct termios l_Mode;
+
+    TestMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((TestMaster < 0) || (0 != grantpt(TestMaster)) || (0 != unlockpt(TestMaster)))
+    {
+        printf("FAIL no pseudo terminal\n");
+        exit(1);
+    }
+    TestSlave = open(ptsname(TestMaster), O_RDWR | O_NOCTTY);
+    if ((TestSlave < 0) || (0 != tcgetattr(TestSlave, &l_Mode)))
+    {
+        printf("FAIL cannot open the slave side\n");
+        exit(1);
+    }
+    cfmakeraw(&l_Mode);
+    tcsetattr(TestSlave, TCSANOW, &l_Mode);
+}
+
+/**
+ * @brief starts every test on an empty ring and a fresh parser
+ */
+static void test_reset(void)
+{
+    TEST_CHECK(ECU_OK == link_parser_init(&TestParser, test_on_command, TEST_RING_SIZE));
+    TestRead = 0U;
+    TestWrite = 0U;
+    TestCount = 0U;
+}
+
+/**
+ * @brief builds one frame
+ *
+ * @param p_Frame destination, LINK_HEADER_SIZE + p_Length + LINK_CRC_SIZE bytes
+ * @param p_Type LINK_MSG_* of the frame
+ * @param p_Payload payload (can be NULL when p_Length is 0)
+ * @param p_Length payload length
+ * @return uint32_t size of the frame
+ */
+static uint32_t test_frame(uint8_t *p_Frame, uint8_t p_Type, const uint8_t *p_Payload, uint8_t p_Length)
+{
+    uint16_t l_Crc;
+
+    p_Frame[0] = LINK_SYNC_0;
+    p_Frame[1] = LINK_SYNC_1;
+    p_Frame[2] = p_Type;
+    p_Frame[3] = p_Length;
+    for (uint32_t l_Index = 0U; l_Index < p_Length; l_Index++)
+    {
+        p_Frame[LINK_HEADER_SIZE + l_Index] = p_Payload[l_Index];
+    }
+    l_Crc = link_crc16(p_Frame, 2U, 2U + p_Length, 0xFFFFFFFFU);
+    p_Frame[LINK_HEADER_SIZE + p_Length] = (uint8_t)l_Crc;
+    p_Frame[LINK_HEADER_SIZE + p_Length + 1U] = (uint8_t)(l_Crc >> 8);
+    return LINK_HEADER_SIZE + p_Length + LINK_CRC_SIZE;
+}
+
+/**
+ * @brief builds one LINK_MSG_DRIVE frame
+ *
+ * @param p_Frame destination
+ * @param p_SpeedMm speed in mm/s
+ * @param p_YawMrad yaw rate in mrad/s
+ * @return uint32_t size of the frame
+ */
+static uint32_t test_drive_frame(uint8_t *p_Frame, int16_t p_SpeedMm, int16_t p_YawMrad)
+{
+    uint8_t l_Payload[LINK_DRIVE_LENGTH];
+
+    l_Payload[0] = (uint8_t)p_SpeedMm;
+    l_Payload[1] = (uint8_t)((uint16_t)p_SpeedMm >> 8);
+    l_Payload[2] = (uint8_t)p_YawMrad;
+    l_Payload[3] = (uint8_t)((uint16_t)p_YawMrad >> 8);
+    return test_frame(p_Frame, LINK_MSG_DRIVE, l_Payload, LINK_DRIVE_LENGTH);
+}
+
+/**
+ * @brief writes bytes on the master side and reads them back from the slave into the ring, the parser runs after
+ *        every read like it runs on the DMA half / complete and idle line interrupts
+ *
+ * @param p_Bytes data sent by the companion computer
+ * @param p_Length number of bytes
+ */
+static void test_transfer(const uint8_t *p_Bytes, uint32_t p_Length)
+{
+    uint32_t l_Received = 0U;
+    struct pollfd l_Poll = { TestSlave, POLLIN, 0 };
+
+    TEST_CHECK((ssize_t)p_Length == write(TestMaster, p_Bytes, p_Length));
+    while ((l_Received < p_Length) && (poll(&l_Poll, 1, TEST_TIMEOUT_MS) > 0))
+    {
+        // the DMA never runs over the bytes the parser still needs, and a read stops at the end of the ring
+        uint32_t l_Offset = TestWrite & (TEST_RING_SIZE - 1U);
+        uint32_t l_Free = (TEST_RING_SIZE - 1U) - ((TestWrite - TestRead) & (TEST_RING_SIZE - 1U));
+        uint32_t l_Room = TEST_RING_SIZE - l_Offset;
+        ssize_t l_Read = read(TestSlave, &TestRing[l_Offset], (l_Free < l_Room) ? l_Free : l_Room);
+
+        if (l_Read <= 0)
+        {
+            break;
+        }
+        l_Received += (uint32_t)l_Read;
+        TestWrite = (TestWrite + (uint32_t)l_Read) & (TEST_RING_SIZE - 1U);
+        TestRead = link_parser_scan(&TestParser, TestRing, TestRead, TestWrite);
+    }
+    TEST_CHECK(l_Received == p_Length);
+}
+
+/**
+ * @brief receiver of the parsed commands
+ *
+ * @param p_Command decoded command
+ */
+static void test_on_command(const link_command_t *p_Command)
+{
+    if (TestCount < TEST_MAX_COMMANDS)
+    {
+        TestCommands[TestCount] = *p_Command;
+    }
+    TestCount++;
+}
+
+/**
+ * @brief the parser refuses a missing callback and rings that are not a power of two or hold less than two frames
+ */
+static void test_init_checks(void)
+{
+    link_parser_t l_Parser;
+    TEST_CHECK(ECU_ERROR == link_parser_init(NULL, test_on_command, TEST_RING_SIZE));
+    TEST_CHECK(ECU_ERROR == link_parser_init(&l_Parser, NULL, TEST_RING_SIZE));
+    TEST_CHECK(ECU_ERROR == link_parser_init(&l_Parser, test_on_command, 200U));
+    TEST_CHECK(ECU_ERROR == link_parser_init(&l_Parser, test_on_command, 256U));
+    TEST_CHECK(ECU_OK == link_parser_init(&l_Parser, test_on_command, 1024U));
+    TEST_CHECK(1023U == l_Parser.Mask);
+}
+
+/**
+ * @brief one frame of every type back to back, negative fields are sign extended
+ */
+static void test_commands(void)
+{
+    uint8_t l_Bytes[64];
+    uint8_t l_Mode = 3U;
+    uint32_t l_Length;
+
+    test_reset();
+    l_Length = test_drive_frame(l_Bytes, 500, -250);
+    l_Length += test_frame(&l_Bytes[l_Length], LINK_MSG_MODE, &l_Mode, LINK_MODE_LENGTH);
+    l_Length += test_frame(&l_Bytes[l_Length], LINK_MSG_HEARTBEAT, NULL, LINK_HEARTBEAT_LENGTH);
+    test_transfer(l_Bytes, l_Length);
+
+    TEST_CHECK(3U == TestCount);
+    TEST_CHECK(LINK_MSG_DRIVE == TestCommands[0].Type);
+    TEST_CHECK_NEAR(TestCommands[0].Speed, 0.5, TEST_TOL);
+    TEST_CHECK_NEAR(TestCommands[0].YawRate, -0.25, TEST_TOL);
+    TEST_CHECK(LINK_MSG_MODE == TestCommands[1].Type);
+    TEST_CHECK(3U == TestCommands[1].Mode);
+    TEST_CHECK(LINK_MSG_HEARTBEAT == TestCommands[2].Type);
+    TEST_CHECK(3U == TestParser.Stats.Frames);
+    TEST_CHECK(0U == TestParser.Stats.SkippedBytes);
+    TEST_CHECK(TestRead == TestWrite);
+}
+
+/**
+ * @brief a frame arriving in pieces stays in the ring until its last byte, whatever the cut
+ */
+static void test_split_frame(void)
+{
+    uint8_t l_Bytes[16];
+    uint32_t l_Length = test_drive_frame(l_Bytes, -1200, 32767);
+
+    for (uint32_t l_Cut = 1U; l_Cut < l_Length; l_Cut++)
+    {
+        test_reset();
+        test_transfer(l_Bytes, l_Cut);
+        TEST_CHECK(0U == TestCount);
+        TEST_CHECK(0U == TestRead);
+        test_transfer(&l_Bytes[l_Cut], l_Length - l_Cut);
+        TEST_CHECK(1U == TestCount);
+        TEST_CHECK_NEAR(TestCommands[0].Speed, -1.2, TEST_TOL);
+        TEST_CHECK_NEAR(TestCommands[0].YawRate, 32.767, 1e-5);
+    }
+}
+
+/**
+ * @brief a corrupted frame is counted and dropped, the next frame is still found
+ */
+static void test_bad_crc(void)
+{
+    uint8_t l_Bytes[32];
+    uint32_t l_Length;
+
+    test_reset();
+    l_Length = test_drive_frame(l_Bytes, 100, 0);
+    l_Bytes[5] ^= 0x10U;
+    l_Length += test_drive_frame(&l_Bytes[l_Length], 200, 0);
+    test_transfer(l_Bytes, l_Length);
+
+    TEST_CHECK(1U == TestCount);
+    TEST_CHECK_NEAR(TestCommands[0].Speed, 0.2, TEST_TOL);
+    TEST_CHECK(1U == TestParser.Stats.CrcErrors);
+    TEST_CHECK(1U == TestParser.Stats.Frames);
+    TEST_CHECK(TestRead == TestWrite);
+}
+
+/**
+ * @brief line noise, false sync bytes and an impossible length are skipped byte by byte
+ */
+static void test_resync(void)
+{
+    static const uint8_t l_Noise[] = { 0x00, 0xFF, LINK_SYNC_0, 0x13, LINK_SYNC_0, LINK_SYNC_1, 0x01, 0xFF };
+    uint8_t l_Bytes[32];
+    uint32_t l_Length = sizeof(l_Noise);
+
+    test_reset();
+    for (uint32_t l_Index = 0U; l_Index < l_Length; l_Index++)
+    {
+        l_Bytes[l_Index] = l_Noise[l_Index];
+    }
+    l_Length += test_drive_frame(&l_Bytes[l_Length], 300, 100);
+    test_transfer(l_Bytes, l_Length);
+
+    TEST_CHECK(1U == TestCount);
+    TEST_CHECK_NEAR(TestCommands[0].Speed, 0.3, TEST_TOL);
+    TEST_CHECK_NEAR(TestCommands[0].YawRate, 0.1, TEST_TOL);
+    TEST_CHECK(sizeof(l_Noise) == TestParser.Stats.SkippedBytes);
+    TEST_CHECK(0U == TestParser.Stats.CrcErrors);
+    TEST_CHECK(TestRead == TestWrite);
+}
+
+/**
+ * @brief frames with a good CRC but an unknown type or a wrong length are counted and never reach the receiver
+ */
+static void test_invalid_frames(void)
+{
+    uint8_t l_Payload[3] = { 1U, 2U, 3U };
+    uint8_t l_Bytes[32];
+    uint32_t l_Length;
+
+    test_reset();
+    l_Length = test_frame(l_Bytes, LINK_MSG_DRIVE, l_Payload, 3U);
+    l_Length += test_frame(&l_Bytes[l_Length], 0x42U, NULL, 0U);
+    test_transfer(l_Bytes, l_Length);
+
+    TEST_CHECK(0U == TestCount);
+    TEST_CHECK(2U == TestParser.Stats.Invalid);
+    TEST_CHECK(0U == TestParser.Stats.Frames);
+    TEST_CHECK(TestRead == TestWrite);
+}
+
+/**
+ * @brief a frame of LINK_MAX_PAYLOAD bytes (a whole telemetry buffer) is checked as a frame, not skipped as noise
+ */
+static void test_full_frame(void)
+{
+    uint8_t l_Payload[LINK_MAX_PAYLOAD];
+    uint8_t l_Bytes[2U * (LINK_HEADER_SIZE + LINK_MAX_PAYLOAD + LINK_CRC_SIZE)];
+    uint32_t l_Length;
+
+    test_reset();
+    for (uint32_t l_Index = 0U; l_Index < LINK_MAX_PAYLOAD; l_Index++)
+    {
+        l_Payload[l_Index] = (uint8_t)(l_Index * 7U);
+    }
+    l_Length = test_frame(l_Bytes, LINK_MSG_TELEMETRY, l_Payload, LINK_MAX_PAYLOAD);
+    l_Length += test_drive_frame(&l_Bytes[l_Length], 400, 0);
+    test_transfer(l_Bytes, l_Length);
+
+    TEST_CHECK(1U == TestCount);
+    TEST_CHECK_NEAR(TestCommands[0].Speed, 0.4, TEST_TOL);
+    TEST_CHECK(1U == TestParser.Stats.Invalid);
+    TEST_CHECK(0U == TestParser.Stats.CrcErrors);
+    TEST_CHECK(0U == TestParser.Stats.SkippedBytes);
+    TEST_CHECK(TestRead == TestWrite);
+}
+
+/**
+ * @brief a long stream wraps the ring several times, frames straddling the end of the ring decode the same
+ */
+static void test_ring_wrap(void)
+{
+    uint8_t l_Bytes[TEST_WRAP_FRAMES * (LINK_HEADER_SIZE + LINK_DRIVE_LENGTH + LINK_CRC_SIZE)];
+    uint32_t l_Length = 0U;
+    uint8_t l_Ok = 1U;
+
+    test_reset();
+    for (uint32_t l_Frame = 0U; l_Frame < TEST_WRAP_FRAMES; l_Frame++)
+    {
+        l_Length += test_drive_frame(&l_Bytes[l_Length], (int16_t)l_Frame, (int16_t)-l_Frame);
+    }
+    // uneven chunks so the frames land at every offset of the ring
+    for (uint32_t l_Sent = 0U, l_Chunk = 1U; l_Sent < l_Length; l_Chunk = (l_Chunk % 37U) + 1U)
+    {
+        uint32_t l_Size = ((l_Length - l_Sent) < l_Chunk) ? (l_Length - l_Sent) : l_Chunk;
+        test_transfer(&l_Bytes[l_Sent], l_Size);
+        l_Sent += l_Size;
+    }
+
+    TEST_CHECK(TEST_WRAP_FRAMES == TestCount);
+    for (uint32_t l_Frame = 0U; (l_Frame < TestCount) && (l_Frame < TEST_WRAP_FRAMES); l_Frame++)
+    {
+        l_Ok &= ((int32_t)(TestCommands[l_Frame].Speed * 1000.0f + 0.5f) == (int32_t)l_Frame);
+        l_Ok &= ((int32_t)(TestCommands[l_Frame].YawRate * -1000.0f + 0.5f) == (int32_t)l_Frame);
+    }
+    TEST_CHECK(l_Ok);
+    TEST_CHECK(0U == TestParser.Stats.SkippedBytes);
+    TEST_CHECK(TestRead == TestWrite);
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,295 @@
+/**
+ * @file    test_range_filter.c
+ * @author  Ahmed Hani
+ * @brief   host tests of the range filter (step, outlier rejection, ramp tracking, double reference) and its benchmark
+ * @date    2026-10-19
+ * @note    nan
+ */
+
+/***********************************************************************************************************************
+*                                                      INCLUDES                                                        *
+***********************************************************************************************************************/
+#include "test.h"
+#include "../ECU_Layer/inc/range_filter.h"
+
+
+
+/***********************************************************************************************************************
+*                                                    MACRO DEFINES                                                     *
+***********************************************************************************************************************/
+#define TEST_ALPHA              (0.5f)
+#define TEST_BETA               (0.2f)
+#define TEST_PERIOD             (0.05f)     // 20 Hz echo rate
+#define TEST_SETTLE             (60)        // samples after which the tracker is settled
+#define TEST_TOL_M              (0.002)     // 2 mm
+#define TEST_BENCH_SAMPLES      (4000000U)
+
+
+
+/***********************************************************************************************************************
+*                                                   MACRO FUNCTIONS                                                    *
+***********************************************************************************************************************/
+#define TEST_RANGE(filter)      ((double)(filter).Range / 65536.0)
+#define TEST_CLOSING(filter)    ((double)(filter).ClosingSpeed / 65536.0)
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DEFINITION                                             *
+***********************************************************************************************************************/
+static void test_init_rejects_bad_gains(void);
+static void test_no_echo_is_free_space(void);
+static void test_step(void);
+static void test_outlier_rejection(void);
+static void test_ramp_tracking(void);
+static void test_double_reference(void);
+static void test_benchmark(void);
+static double test_reference_median(const uint16_t *p_Window);
+
+
+
+/***********************************************************************************************************************
+*                                                  FUNCTION DECLARATION                                                *
+***********************************************************************************************************************/
+
+int main(void)
+{
+    test_init_rejects_bad_gains();
+    test_no_echo_is_free_space();
+    test_step();
+    test_outlier_rejection();
+    test_ramp_tracking();
+    test_double_reference();
+    test_benchmark();
+    return TEST_REPORT("range_filter");
+}
+
+
+
+
+/***********************************************************************************************************************
+*                                               STATIC FUNCTION DECLARATION                                            *
+***********************************************************************************************************************/
+
+/**
+ * @brief gains and period out of range are refused
+ */
+static void test_init_rejects_bad_gains(void)
+{
+    range_filter_t l_Filter;
+    TEST_CHECK(ECU_ERROR == range_filter_init(NULL, TEST_ALPHA, TEST_BETA, TEST_PERIOD));
+    TEST_CHECK(ECU_ERROR == range_filter_init(&l_Filter, 0.0f, TEST_BETA, TEST_PERIOD));
+    TEST_CHECK(ECU_ERROR == range_filter_init(&l_Filter, 1.5f, TEST_BETA, TEST_PERIOD));
+    TEST_CHECK(ECU_ERROR == range_filter_init(&l_Filter, TEST_ALPHA, 2.5f, TEST_PERIOD));
+    TEST_CHECK(ECU_ERROR == range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, 0.0f));
+    TEST_CHECK(ECU_ERROR == range_filter_update(NULL, 1000U));
+    TEST_CHECK(ECU_OK == range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, TEST_PERIOD));
+}
+
+/**
+ * @brief a missing echo and a reading past the limit both read as the maximum range
+ */
+static void test_no_echo_is_free_space(void)
+{
+    range_filter_t l_Filter;
+    (void)range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, TEST_PERIOD);
+    (void)range_filter_update(&l_Filter, 0U);
+    TEST_CHECK_NEAR(TEST_RANGE(l_Filter), RANGE_FILTER_MAX_RANGE_MM / 1000.0, TEST_TOL_M);
+    for (int l_Sample = 0; l_Sample < TEST_SETTLE; l_Sample++)
+    {
+        (void)range_filter_update(&l_Filter, 65000U);
+    }
+    TEST_CHECK_NEAR(TEST_RANGE(l_Filter), RANGE_FILTER_MAX_RANGE_MM / 1000.0, TEST_TOL_M);
+    TEST_CHECK_NEAR(TEST_CLOSING(l_Filter), 0.0, 0.01);
+}
+
+/**
+ * @brief a step is held back by the median for half a window, then the tracker converges without a steady error
+ */
+static void test_step(void)
+{
+    range_filter_t l_Filter;
+    (void)range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, TEST_PERIOD);
+    (void)range_filter_update(&l_Filter, 2000U);
+
+    for (int l_Sample = 0; l_Sample < (RANGE_FILTER_MEDIAN_WINDOW / 2); l_Sample++)
+    {
+        (void)range_filter_update(&l_Filter, 1000U);
+        TEST_CHECK_NEAR(TEST_RANGE(l_Filter), 2.0, TEST_TOL_M);
+    }
+    (void)range_filter_update(&l_Filter, 1000U);
+    TEST_CHECK(TEST_RANGE(l_Filter) < 1.9);
+    // a step toward the car reads as an approaching target
+    TEST_CHECK(TEST_CLOSING(l_Filter) > 0.5);
+
+    for (int l_Sample = 0; l_Sample < TEST_SETTLE; l_Sample++)
+    {
+        (void)range_filter_update(&l_Filter, 1000U);
+    }
+    TEST_CHECK_NEAR(TEST_RANGE(l_Filter), 1.0, TEST_TOL_M);
+    TEST_CHECK_NEAR(TEST_CLOSING(l_Filter), 0.0, 0.01);
+}
+
+/**
+ * @brief up to half a window of consecutive wild readings (multipath, missed echo) never reaches the output
+ */
+static void test_outlier_rejection(void)
+{
+    static const uint16_t s_Outliers[] = { 150U, 0U, 3900U, 1U };
+    range_filter_t l_Filter;
+    (void)range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, TEST_PERIOD);
+
+    for (int l_Sample = 0; l_Sample < TEST_SETTLE; l_Sample++)
+    {
+        (void)range_filter_update(&l_Filter, 1500U);
+    }
+    for (unsigned int l_Case = 0U; l_Case < (sizeof(s_Outliers) / sizeof(s_Outliers[0])); l_Case++)
+    {
+        for (int l_Burst = 0; l_Burst < (RANGE_FILTER_MEDIAN_WINDOW / 2); l_Burst++)
+        {
+            (void)range_filter_update(&l_Filter, s_Outliers[l_Case]);
+            TEST_CHECK_NEAR(TEST_RANGE(l_Filter), 1.5, TEST_TOL_M);
+            TEST_CHECK_NEAR(TEST_CLOSING(l_Filter), 0.0, 0.01);
+        }
+        for (int l_Sample = 0; l_Sample < RANGE_FILTER_MEDIAN_WINDOW; l_Sample++)
+        {
+            (void)range_filter_update(&l_Filter, 1500U);
+        }
+    }
+}
+
+/**
+ * @brief a target closing at constant speed: the speed is tracked without steady error and the range only lags by
+ *        the median delay (half a window)
+ */
+static void test_ramp_tracking(void)
+{
+    const double l_Speed = 0.5;                                 // m/s toward the car
+    const double l_StepMm = l_Speed * TEST_PERIOD * 1000.0;     // 25 mm per sample
+    range_filter_t l_Filter;
+    double l_TrueMm = 3500.0;
+    (void)range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, TEST_PERIOD);
+
+    for (int l_Sample = 0; l_Sample < (TEST_SETTLE * 2); l_Sample++)
+    {
+        (void)range_filter_update(&l_Filter, (uint16_t)l_TrueMm);
+        l_TrueMm -= l_StepMm;
+    }
+    l_TrueMm += l_StepMm;   // last sample pushed
+    TEST_CHECK_NEAR(TEST_CLOSING(l_Filter), l_Speed, 0.01);
+    TEST_CHECK_NEAR(TEST_RANGE(l_Filter), (l_TrueMm + ((RANGE_FILTER_MEDIAN_WINDOW / 2) * l_StepMm)) / 1000.0,
+                    TEST_TOL_M);
+}
+
+/**
+ * @brief the Q16 filter against the same median + alpha-beta tracker in double precision on a noisy stream
+ */
+static void test_double_reference(void)
+{
+    range_filter_t l_Filter;
+    uint16_t l_Window[RANGE_FILTER_MEDIAN_WINDOW];
+    double l_Range = 0.0;
+    double l_Closing = 0.0;
+    double l_WorstRange = 0.0;
+    double l_WorstClosing = 0.0;
+    uint32_t l_Seed = 12345U;
+    (void)range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, TEST_PERIOD);
+
+    for (int l_Sample = 0; l_Sample < 20000; l_Sample++)
+    {
+        // slow oscillating target, 20 mm noise and a wild reading now and then
+        l_Seed = (l_Seed * 1103515245U) + 12345U;
+        double l_True = 2000.0 + (1200.0 * sin((double)l_Sample * 0.01));
+        int32_t l_Noise = (int32_t)((l_Seed >> 16) % 41U) - 20;
+        uint16_t l_Raw = (uint16_t)(l_True + l_Noise);
+        if (((l_Seed >> 8) & 0x3FU) == 0U)
+        {
+            l_Raw = (uint16_t)((l_Seed >> 4) & 0x0FFFU);
+        }
+        if ((0U == l_Raw) || (l_Raw > RANGE_FILTER_MAX_RANGE_MM))
+        {
+            l_Raw = RANGE_FILTER_MAX_RANGE_MM;
+        }
+
+        if (0 == l_Sample)
+        {
+            for (int l_Index = 0; l_Index < RANGE_FILTER_MEDIAN_WINDOW; l_Index++)
+            {
+                l_Window[l_Index] = l_Raw;
+            }
+            l_Range = l_Raw / 1000.0;
+        }
+        else
+        {
+            l_Window[(l_Sample - 1) % RANGE_FILTER_MEDIAN_WINDOW] = l_Raw;
+            double l_Predicted = l_Range - (l_Closing * TEST_PERIOD);
+            double l_Residual = (test_reference_median(l_Window) / 1000.0) - l_Predicted;
+            l_Range = l_Predicted + (TEST_ALPHA * l_Residual);
+            l_Closing -= (TEST_BETA / TEST_PERIOD) * l_Residual;
+        }
+        (void)range_filter_update(&l_Filter, l_Raw);
+
+        double l_Error = fabs(TEST_RANGE(l_Filter) - l_Range);
+        l_WorstRange = (l_Error > l_WorstRange) ? l_Error : l_WorstRange;
+        l_Error = fabs(TEST_CLOSING(l_Filter) - l_Closing);
+        l_WorstClosing = (l_Error > l_WorstClosing) ? l_Error : l_WorstClosing;
+    }
+    printf("range_filter: worst error against double %.3f mm, %.4f m/s\n", l_WorstRange * 1000.0, l_WorstClosing);
+    TEST_CHECK(l_WorstRange < 0.001);
+    TEST_CHECK(l_WorstClosing < 0.01);
+}
+
+/**
+ * @brief host time of one update, for comparing changes of the filter (the target figure comes from the DWT)
+ */
+static void test_benchmark(void)
+{
+    range_filter_t l_Filter;
+    volatile q16_t l_Sink = 0;
+    (void)range_filter_init(&l_Filter, TEST_ALPHA, TEST_BETA, TEST_PERIOD);
+
+    uint64_t l_Start = test_now_ns();
+    for (uint32_t l_Sample = 0U; l_Sample < TEST_BENCH_SAMPLES; l_Sample++)
+    {
+        (void)range_filter_update(&l_Filter, (uint16_t)(500U + (l_Sample & 0x7FFU)));
+        l_Sink = l_Filter.Range;
+    }
+    uint64_t l_Elapsed = test_now_ns() - l_Start;
+    (void)l_Sink;
+    printf("range_filter: %.1f ns per update on the host\n", (double)l_Elapsed / TEST_BENCH_SAMPLES);
+}
+
+/**
+ * @brief median by sorting a copy, independent of the sorting network under test
+ *
+ * @param p_Window window of raw samples
+ * @return double median sample
+ */
+static double test_reference_median(const uint16_t *p_Window)
+{
+    uint16_t l_Sorted[RANGE_FILTER_MEDIAN_WINDOW];
+    memcpy(l_Sorted, p_Window, sizeof(l_Sorted));
+    for (int l_Pass = 0; l_Pass < RANGE_FILTER_MEDIAN_WINDOW; l_Pass++)
+    {
+        for (int l_Index = 0; (l_Index + 1) < RANGE_FILTER_MEDIAN_WINDOW; l_Index++)
+        {
+            if (l_Sorted[l_Index] > l_Sorted[l_Index + 1])
+            {
+                uint16_t l_Swap = l_Sorted[l_Index];
+                l_Sorted[l_Index] = l_Sorted[l_Index + 1];
+                l_Sorted[l_Index + 1] = l_Swap;
+            }
+        }
+    }
+    return (double)l_Sorted[RANGE_FILTER_MEDIAN_WINDOW / 2];
+}
+
+
+
+
+/***********************************************************************************************************************
+* AUTHOR                |* NOTE                                                                                        *
+************************************************************************************************************************
+*                       |                                                                                              *
+*                       |                                                                                              *
+***********************************************************************************************************************/
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+@file    log_decode.py
+@author  Ahmed Hani
+@brief   rebuilds the LOGGER_PRINT messages from the format strings kept in the .logstr section of the ELF
+@date    2026-10-19
+@note    the ELF must be the one flashed on the target, ids are offsets in its .logstr section.
+         SWO capture of the ITM (default build):  python3 Tools/log_decode.py Debug/ADAS.elf swo.bin --itm
+         telemetry link (LOGGER_TRANSPORT_TELEMETRY):  python3 Tools/log_decode.py Debug/ADAS.elf /dev/ttyUSB0
+         only the log records are printed, use telemetry_decode.py for the other channels
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+import telemetry_decode
+
+ITM_PORT = 1            # LOGGER_ITM_PORT, header words
+ITM_ARG_PORT = 2        # LOGGER_ITM_ARG_PORT, argument words
+COUNT_SHIFT = 24        # LOGGER_COUNT_SHIFT
+ID_MASK = (1 << COUNT_SHIFT) - 1
+CONVERSION = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diuxXocpfFeEgGs%])")
+
+
+def load_formats(path):
+    """maps every string id to its format, parsed from the section headers of an ELF32 or ELF64 file"""
+    with open(path, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an ELF file" % path)
+    is_64 = data[4] == 2
+    order = "<" if data[5] == 1 else ">"
+    if is_64:
+        shoff, = struct.unpack_from(order + "Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(order + "HHH", data, 0x3A)
+        header = order + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(order + "I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(order + "HHH", data, 0x2E)
+        header = order + "IIIIIIIIII"
+    sections = [struct.unpack_from(header, data, shoff + index * shentsize) for index in range(shnum)]
+    names = sections[shstrndx]
+    formats = {}
+    for name, _, _, address, offset, size, _, _, _, _ in sections:
+        end = data.index(b"\0", names[4] + name)
+        if data[names[4] + name:end] != b".logstr":
+            continue
+        content = data[offset:offset + size]
+        start = 0
+        while start < len(content):
+            stop = content.find(b"\0", start)
+            stop = len(content) if stop < 0 else stop
+            if stop > start:
+                formats[(address + start) & ID_MASK] = content[start:stop].decode("utf-8", "replace")
+            start = stop + 1
+    if not formats:
+        raise ValueError("%s has no .logstr section, is it built with LOGGER_PRINT calls?" % path)
+    return formats
+
+
+def format_message(text, args):
+    """printf formatting of 32 bit words, floats arrive as their raw bits (LOGGER_F32)"""
+    args = list(args)
+
+    def convert(match):
+        flags, _, kind = match.groups()
+        if kind == "%":
+            return "%"
+        word = args.pop(0) & 0xFFFFFFFF if args else 0
+        if kind in "di":
+            return ("%" + flags + "d") % (word - (1 << 32) if word & 0x80000000 else word)
+        if kind == "u":
+            return ("%" + flags + "d") % word
+        if kind == "p":
+            return "0x%08x" % word
+        if kind in "fFeEgG":
+            return ("%" + flags + kind) % struct.unpack("<f", struct.pack("<I", word))[0]
+        if kind == "c":
+            return chr(word & 0xFF)
+        if kind == "s":
+            return "<str 0x%08x>" % word
+        return ("%" + flags + kind) % word
+
+    return CONVERSION.sub(convert, text)
+
+
+def telemetry_messages(stream):
+    """(seconds since the first record, header, arguments) of every log record on the telemetry link"""
+    timeline = telemetry_decode.Timeline()
+    for payload in telemetry_decode.frames(stream):
+        try:
+            records = list(telemetry_decode.decode_payload(payload))
+        except (IndexError, ValueError):
+            continue
+        for _, _, timestamp, clock, name, fields in records:
+            seconds = timeline.seconds_of(timestamp, clock)
+            if name == "log":
+                yield seconds, fields[0] & 0xFFFFFFFF, fields[1:]
+
+
+def itm_messages(stream):
+    """(None, header, arguments) from the 32 bit writes of the logger to its stimulus ports, messages cut by a
+    full stimulus FIFO are skipped"""
+    data = stream.read()
+    words = []
+    index = 0
+    while index < len(data):
+        header = data[index]
+        index += 1
+        size = (0, 1, 2, 4)[header & 3]
+        if size:
+            # source packet, bit 2 clear for a stimulus port whose number is in bits 7:3
+            port = header >> 3
+            if (header & 4) == 0 and port in (ITM_PORT, ITM_ARG_PORT) and size == 4 and index + 4 <= len(data):
+                words.append((port, struct.unpack_from("<I", data, index)[0]))
+            index += size
+        elif header not in (0x00, 0x70, 0x80) and header & 0x80:
+            # timestamp or extension packet, continuation bytes have bit 7 set. sync and overflow are one byte
+            while index < len(data) and data[index] & 0x80:
+                index += 1
+            index += 1
+    header = None
+    arguments = []
+    for port, word in words + [(ITM_PORT, None)]:
+        if port == ITM_PORT:
+            if header is not None and len(arguments) == header >> COUNT_SHIFT:
+                yield None, header, arguments
+            header, arguments = word, []
+        elif header is not None:
+            arguments.append(word)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="rebuilds the LOGGER_PRINT messages")
+    parser.add_argument("elf", help="ELF flashed on the target (Debug/ADAS.elf)")
+    parser.add_argument("source", nargs="?", help="capture file or serial device, stdin when omitted")
+    parser.add_argument("--itm", action="store_true", help="source is a raw SWO capture of the ITM")
+    args = parser.parse_args()
+
+    formats = load_formats(args.elf)
+    stream = open(args.source, "rb", buffering=0) if args.source else sys.stdin.buffer
+    messages = itm_messages(stream) if args.itm else telemetry_messages(stream)
+    for timestamp, header, arguments in messages:
+        text = formats.get(header & ID_MASK)
+        if text is None:
+            text = "<unknown id 0x%06x, wrong ELF?>" % (header & ID_MASK)
+        line = format_message(text, arguments[:header >> COUNT_SHIFT]).rstrip("\r\n")
+        if timestamp is not None:
+            line = "[%.6f] %s" % (timestamp, line)
+        sys.stdout.write(line + "\n")
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+@file    ramfunc_report.py
+@author  Ahmed Hani
+@brief   lists the functions placed in SRAM by ECU_RAMFUNC and what they cost, read from the symbols of the ELF
+@date    2026-10-19
+@note    the code is counted twice: once in RAM where it runs and once in FLASH where Reset_Handler copies it from.
+         python3 Tools/ramfunc_report.py Debug/ADAS.elf
+"""
+
+import argparse
+import struct
+import sys
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+EM_ARM = 40
+RAM_SIZE = 64 * 1024
+
+
+def load_symbols(path):
+    """maps every symbol name to (address, size, type) from the .symtab of an ELF32 or ELF64 file, thumb bit cleared"""
+    with open(path, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an ELF file" % path)
+    is_64 = data[4] == 2
+    order = "<" if data[5] == 1 else ">"
+    thumb = struct.unpack_from(order + "H", data, 0x12)[0] == EM_ARM
+    if is_64:
+        shoff, = struct.unpack_from(order + "Q", data, 0x28)
+        shentsize, shnum, _ = struct.unpack_from(order + "HHH", data, 0x3A)
+        header = order + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(order + "I", data, 0x20)
+        shentsize, shnum, _ = struct.unpack_from(order + "HHH", data, 0x2E)
+        header = order + "IIIIIIIIII"
+    sections = [struct.unpack_from(header, data, shoff + index * shentsize) for index in range(shnum)]
+    symbols = {}
+    for _, kind, _, _, offset, size, link, _, _, entsize in sections:
+        if kind != SHT_SYMTAB:
+            continue
+        strings = sections[link][4]
+        for start in range(offset, offset + size, entsize):
+            if is_64:
+                name, info, _, _, value, length = struct.unpack_from(order + "IBBHQQ", data, start)
+            else:
+                name, value, length, info, _, _ = struct.unpack_from(order + "IIIBBH", data, start)
+            end = data.index(b"\0", strings + name)
+            if thumb and (info & 0xF) == STT_FUNC:
+                value &= ~1
+            symbols[data[strings + name:end].decode("utf-8", "replace")] = (value, length, info & 0xF)
+    if "_sramfunc" not in symbols or "_eramfunc" not in symbols:
+        raise ValueError("%s has no _sramfunc / _eramfunc, is it linked with STM32F401RCTX_FLASH.ld?" % path)
+    return symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description="lists the ECU_RAMFUNC functions and their RAM cost")
+    parser.add_argument("elf", help="linked firmware (Debug/ADAS.elf)")
+    args = parser.parse_args()
+
+    symbols = load_symbols(args.elf)
+    start = symbols["_sramfunc"][0]
+    end = symbols["_eramfunc"][0]
+    budget = symbols.get("_Max_RamFunc_Size", (None,))[0]
+
+    functions = sorted((address, length, name) for name, (address, length, kind) in symbols.items()
+                       if kind == STT_FUNC and start <= address < end)
+    for address, length, name in functions:
+        sys.stdout.write("0x%08x %6d  %s\n" % (address, length, name))
+
+    total = end - start
+    padding = total - sum(length for _, length, _ in functions)
+    sys.stdout.write("%d functions, %d bytes of RAM (%.1f%% of %d K) + the same in FLASH, %d bytes of padding\n"
+                     % (len(functions), total, 100.0 * total / RAM_SIZE, RAM_SIZE // 1024, padding))
+    if budget is not None:
+        sys.stdout.write("budget _Max_RamFunc_Size %d bytes, %d left\n" % (budget, budget - total))
+
+
+if __name__ == "__main__":
+    main()
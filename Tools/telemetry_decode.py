@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+@file    telemetry_decode.py
+@author  Ahmed Hani
+@brief   decodes the telemetry frames of ECU_Layer/src/telemetry.c into CSV
+@date    2026-10-19
+@note    reads a capture file, a serial device (already set to the link baud rate) or stdin:
+             stty -F /dev/ttyUSB0 2000000 raw && python3 Tools/telemetry_decode.py /dev/ttyUSB0
+         output columns: sequence, time in seconds since the first record (cycle counter with --cycles), channel,
+         fields. every buffer carries the core clock of its timestamps, power profile changes decode right.
+         CHANNELS must follow telemetry_channel_t and TelemetryFieldCounts
+"""
+
+import argparse
+import sys
+
+SYNC = b"\xA5\x5A"
+MSG_TELEMETRY = 0x80
+HEADER_SIZE = 4
+CRC_SIZE = 2
+
+# (name, number of fields) in telemetry_channel_t order
+CHANNELS = [
+    ("wheel_speeds", 4),
+    ("motor_duties", 4),
+    ("ranges", 4),
+    ("pose", 3),
+    ("task_timing", 2),
+    ("log", 4),
+]
+
+
+def crc16(data):
+    """CRC16-CCITT, polynomial 0x1021, initial value 0xFFFF (link_crc16)"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def varint(data, offset):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value & 0xFFFFFFFF, offset
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def to_int32(value):
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+class Timeline:
+    """turns the cycle counter of the records into seconds, the core clock may change from one buffer to the next"""
+
+    def __init__(self):
+        self.seconds = 0.0
+        self.last = None
+
+    def seconds_of(self, timestamp, clock):
+        # the counter wraps every 2^32 cycles (51 s at 84 MHz), gaps are counted at the clock of the newer buffer
+        if self.last is not None:
+            self.seconds += ((timestamp - self.last) & 0xFFFFFFFF) / clock
+        self.last = timestamp
+        return self.seconds
+
+
+def decode_payload(payload):
+    """yields (sequence, dropped, timestamp, clock in Hz, channel name, fields) for every record of one buffer"""
+    sequence = payload[0]
+    dropped, offset = varint(payload, 1)
+    clock, offset = varint(payload, offset)
+    clock *= 1000
+    if not clock:
+        raise ValueError("zero core clock")
+    timestamp = int.from_bytes(payload[offset:offset + 4], "little")
+    offset += 4
+    last = [[0] * count for _, count in CHANNELS]
+    while offset < len(payload):
+        channel = payload[offset]
+        offset += 1
+        if channel >= len(CHANNELS):
+            raise ValueError("unknown channel %d" % channel)
+        delta, offset = varint(payload, offset)
+        timestamp = (timestamp + delta) & 0xFFFFFFFF
+        name, count = CHANNELS[channel]
+        for field in range(count):
+            value, offset = varint(payload, offset)
+            last[channel][field] = to_int32(last[channel][field] + unzigzag(value))
+        yield sequence, dropped, timestamp, clock, name, list(last[channel])
+
+
+def frames(stream):
+    """yields the payload of every telemetry frame with a good CRC, resynchronizes on the sync bytes"""
+    pending = bytearray()
+    while True:
+        chunk = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+        if not chunk:
+            return
+        pending += chunk
+        while True:
+            start = pending.find(SYNC)
+            if start < 0:
+                del pending[:-1]
+                break
+            del pending[:start]
+            if len(pending) < HEADER_SIZE:
+                break
+            end = HEADER_SIZE + pending[3] + CRC_SIZE
+            if len(pending) < end:
+                break
+            crc = pending[end - 2] | (pending[end - 1] << 8)
+            if crc != crc16(pending[2:end - 2]):
+                del pending[:1]
+                continue
+            if pending[2] == MSG_TELEMETRY:
+                yield bytes(pending[HEADER_SIZE:end - 2])
+            del pending[:end]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="decodes the telemetry frames into CSV")
+    parser.add_argument("source", nargs="?", help="capture file or serial device, stdin when omitted")
+    parser.add_argument("--cycles", action="store_true", help="prints the raw cycle counter instead of seconds")
+    args = parser.parse_args()
+
+    stream = open(args.source, "rb", buffering=0) if args.source else sys.stdin.buffer
+    out = sys.stdout
+    out.write("sequence,time,channel,fields\n")
+    last_sequence = None
+    last_dropped = 0
+    timeline = Timeline()
+    for payload in frames(stream):
+        try:
+            records = list(decode_payload(payload))
+        except (IndexError, ValueError) as error:
+            sys.stderr.write("bad telemetry frame: %s\n" % error)
+            continue
+        if records:
+            sequence, dropped = records[0][0], records[0][1]
+            if last_sequence is not None and sequence != ((last_sequence + 1) & 0xFF):
+                sys.stderr.write("frames lost before sequence %d\n" % sequence)
+            if dropped != last_dropped:
+                sys.stderr.write("%d records dropped on the target\n" % ((dropped - last_dropped) & 0xFFFFFFFF))
+            last_sequence, last_dropped = sequence, dropped
+        for sequence, _, timestamp, clock, name, fields in records:
+            seconds = timeline.seconds_of(timestamp, clock)
+            time = str(timestamp) if args.cycles else "%.6f" % seconds
+            out.write("%d,%s,%s,%s\n" % (sequence, time, name, ",".join(str(field) for field in fields)))
+        out.flush()
+
+
+if __name__ == "__main__":
+    main()